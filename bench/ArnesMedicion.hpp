@@ -0,0 +1,228 @@
+#ifndef ARNES_MEDICION_HPP
+#define ARNES_MEDICION_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Arnés mínimo de microbenchmarks, sin dependencias externas.
+ *
+ * Cada caso es una función que prepara sus datos, mide con un Cronometro
+ * sólo la parte que interesa y retorna cuántas operaciones hizo. El arnés
+ * la repite (al menos `repeticionesMinimas` veces y hasta juntar
+ * `tiempoObjetivo` segundos medidos) y guarda mínimo y mediana de ns/op.
+ *
+ * Los resultados se emiten como tabla, CSV o JSON para poder comparar
+ * corridas entre sí (p. ej. guardando el JSON de cada commit).
+ */
+
+/** Impide que el compilador elimine un cálculo cuyo resultado no se usa */
+template <typename T>
+inline void noOptimizar(const T& valor) {
+    #if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(valor) : "memory");
+    #else
+        static volatile const void* sumidero;
+        sumidero = &valor;
+    #endif
+}
+
+/** Mide el tramo entre iniciar() y detener(); puede acumular varios tramos */
+class Cronometro {
+public:
+    Cronometro() : acumulado(0.0) {}
+
+    void iniciar() {
+        inicio = std::chrono::steady_clock::now();
+    }
+
+    void detener() {
+        acumulado += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    double segundos() const {
+        return acumulado;
+    }
+
+private:
+    std::chrono::steady_clock::time_point inicio;
+    double acumulado;
+};
+
+/// Resultado de un caso con un tamaño
+struct ResultadoMedicion {
+    std::string grupo;        ///< Qué se mide (p. ej. "ListaSensor::insertar")
+    std::string tipo;         ///< Tipo de dato o variante
+    std::uint64_t n;          ///< Tamaño del problema
+    int repeticiones;
+    double nsPorOpMinimo;
+    double nsPorOpMediana;
+    double opsPorSegundo;     ///< Con el mínimo
+};
+
+enum class FormatoSalida { Tabla, Csv, Json };
+
+class ArnesMedicion {
+public:
+    ArnesMedicion() : formato(FormatoSalida::Tabla), tiempoObjetivo(0.2), repeticionesMinimas(3),
+                      repeticionesMaximas(50) {}
+
+    /**
+     * Opciones de línea de comandos:
+     *   --formato=tabla|csv|json   --salida=archivo   --filtro=texto
+     *   --tiempo=segundos          (tiempo medido mínimo por caso)
+     * Las opciones no reconocidas se dejan para el programa.
+     */
+    void configurar(int argc, char* argv[]) {
+        for (int i = 1; i < argc; i++) {
+            const char* a = argv[i];
+            if (std::strncmp(a, "--formato=", 10) == 0) {
+                std::string f(a + 10);
+                formato = (f == "json") ? FormatoSalida::Json
+                        : (f == "csv") ? FormatoSalida::Csv : FormatoSalida::Tabla;
+            } else if (std::strncmp(a, "--salida=", 9) == 0) {
+                rutaSalida = a + 9;
+            } else if (std::strncmp(a, "--filtro=", 9) == 0) {
+                filtro = a + 9;
+            } else if (std::strncmp(a, "--tiempo=", 9) == 0) {
+                tiempoObjetivo = std::atof(a + 9);
+            }
+        }
+    }
+
+    /** true si el grupo pasa el filtro de --filtro */
+    bool habilitado(const std::string& grupo) const {
+        return filtro.empty() || grupo.find(filtro) != std::string::npos;
+    }
+
+    /**
+     * Ejecuta caso(Cronometro&) -> operaciones hasta cumplir el tiempo
+     * objetivo y registra el resultado.
+     */
+    template <typename Caso>
+    void medir(const std::string& grupo, const std::string& tipo, std::uint64_t n, Caso caso) {
+        if (!habilitado(grupo)) {
+            return;
+        }
+        std::vector<double> nsPorOp;
+        double total = 0.0;
+        while (static_cast<int>(nsPorOp.size()) < repeticionesMinimas ||
+               (total < tiempoObjetivo && static_cast<int>(nsPorOp.size()) < repeticionesMaximas)) {
+            Cronometro cronometro;
+            std::uint64_t operaciones = caso(cronometro);
+            total += cronometro.segundos();
+            nsPorOp.push_back(operaciones == 0 ? 0.0 : cronometro.segundos() * 1e9 / operaciones);
+        }
+        std::sort(nsPorOp.begin(), nsPorOp.end());
+
+        ResultadoMedicion r;
+        r.grupo = grupo;
+        r.tipo = tipo;
+        r.n = n;
+        r.repeticiones = static_cast<int>(nsPorOp.size());
+        r.nsPorOpMinimo = nsPorOp.front();
+        r.nsPorOpMediana = nsPorOp[nsPorOp.size() / 2];
+        r.opsPorSegundo = (r.nsPorOpMinimo > 0.0) ? 1e9 / r.nsPorOpMinimo : 0.0;
+        resultados.push_back(r);
+
+        // El progreso va a stderr para no mezclarse con CSV/JSON en stdout
+        std::fprintf(stderr, "  %-40s %-8s n=%-10llu %12.2f ns/op\n", grupo.c_str(), tipo.c_str(),
+                     static_cast<unsigned long long>(n), r.nsPorOpMinimo);
+    }
+
+    /** Escribe todos los resultados en el formato y destino elegidos */
+    void emitir(const std::string& programa) const {
+        std::ofstream archivo;
+        if (!rutaSalida.empty()) {
+            archivo.open(rutaSalida);
+            if (!archivo) {
+                std::cerr << "[Error] No se pudo abrir " << rutaSalida << std::endl;
+                return;
+            }
+        }
+        std::ostream& os = rutaSalida.empty() ? std::cout : archivo;
+        switch (formato) {
+            case FormatoSalida::Csv:  emitirCsv(os); break;
+            case FormatoSalida::Json: emitirJson(os, programa); break;
+            default:                  emitirTabla(os); break;
+        }
+    }
+
+private:
+    void emitirTabla(std::ostream& os) const {
+        char linea[256];
+        std::snprintf(linea, sizeof(linea), "%-40s %-8s %12s %14s %14s %16s\n", "grupo", "tipo", "n",
+                      "ns/op (mín)", "ns/op (med)", "ops/s");
+        os << linea;
+        for (const ResultadoMedicion& r : resultados) {
+            std::snprintf(linea, sizeof(linea), "%-40s %-8s %12llu %14.2f %14.2f %16.0f\n",
+                          r.grupo.c_str(), r.tipo.c_str(), static_cast<unsigned long long>(r.n),
+                          r.nsPorOpMinimo, r.nsPorOpMediana, r.opsPorSegundo);
+            os << linea;
+        }
+    }
+
+    void emitirCsv(std::ostream& os) const {
+        os << "grupo,tipo,n,repeticiones,ns_por_op_min,ns_por_op_mediana,ops_por_s\n";
+        char linea[256];
+        for (const ResultadoMedicion& r : resultados) {
+            std::snprintf(linea, sizeof(linea), "%s,%s,%llu,%d,%.3f,%.3f,%.1f\n",
+                          r.grupo.c_str(), r.tipo.c_str(), static_cast<unsigned long long>(r.n),
+                          r.repeticiones, r.nsPorOpMinimo, r.nsPorOpMediana, r.opsPorSegundo);
+            os << linea;
+        }
+    }
+
+    void emitirJson(std::ostream& os, const std::string& programa) const {
+        char fecha[32];
+        std::time_t ahora = std::time(nullptr);
+        std::strftime(fecha, sizeof(fecha), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&ahora));
+
+        os << "{\n  \"programa\": \"" << programa << "\",\n"
+           << "  \"fecha\": \"" << fecha << "\",\n"
+           << "  \"compilador\": \"" << compilador() << "\",\n"
+           << "  \"resultados\": [\n";
+        char linea[512];
+        for (std::size_t i = 0; i < resultados.size(); i++) {
+            const ResultadoMedicion& r = resultados[i];
+            std::snprintf(linea, sizeof(linea),
+                          "    {\"grupo\": \"%s\", \"tipo\": \"%s\", \"n\": %llu, \"repeticiones\": %d, "
+                          "\"ns_por_op_min\": %.3f, \"ns_por_op_mediana\": %.3f, \"ops_por_s\": %.1f}%s\n",
+                          r.grupo.c_str(), r.tipo.c_str(), static_cast<unsigned long long>(r.n),
+                          r.repeticiones, r.nsPorOpMinimo, r.nsPorOpMediana, r.opsPorSegundo,
+                          (i + 1 < resultados.size()) ? "," : "");
+            os << linea;
+        }
+        os << "  ]\n}\n";
+    }
+
+    static std::string compilador() {
+        #if defined(__clang__)
+            return std::string("clang ") + __clang_version__;
+        #elif defined(__GNUC__)
+            return std::string("gcc ") + __VERSION__;
+        #elif defined(_MSC_VER)
+            return "msvc " + std::to_string(_MSC_VER);
+        #else
+            return "desconocido";
+        #endif
+    }
+
+    FormatoSalida formato;
+    std::string rutaSalida;
+    std::string filtro;
+    double tiempoObjetivo;
+    int repeticionesMinimas;
+    int repeticionesMaximas;
+    std::vector<ResultadoMedicion> resultados;
+};
+
+#endif // ARNES_MEDICION_HPP
@@ -0,0 +1,345 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+#if SISTEMAIOT_EJECUCION_PARALELA
+#include <execution>
+#endif
+
+#include "ArnesMedicion.hpp"
+#include "KernelesAnalitica.hpp"
+#include "ListaSensor.hpp"
+#include "ListaSensorBloques.hpp"
+#include "ListaSensorCircular.hpp"
+
+// Kernels de análisis de historial: bucle original (acumula en T) frente
+// a las versiones escalar, SSE4.1 y AVX2 de KernelesAnalitica.hpp.
+// Uso: bench_analitica [--formato=tabla|csv|json] [--salida=archivo]
+//                      [--filtro=texto] [--tiempo=s] [--max=N]
+// Además informa en stderr el error de la suma de cada variante.
+//
+// Los grupos Recorrido::<lista> comparan los bucles con paraCada frente a
+// los algoritmos estándar sobre los iteradores de cada historial y, en
+// los historiales contiguos, sobre sus tramos. Las variantes par_unseq
+// sólo se compilan si CMake encontró TBB (SISTEMAIOT_EJECUCION_PARALELA).
+
+template <typename T>
+static std::vector<T> generarValores(std::uint64_t n) {
+    std::vector<T> valores(static_cast<std::size_t>(n));
+    std::uint32_t x = 2463534242u;
+    for (std::size_t i = 0; i < valores.size(); i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        valores[i] = static_cast<T>(x % 100000u) / static_cast<T>(4);
+    }
+    return valores;
+}
+
+/** Suma, mínimo y máximo como los calculaba la lista: acumulando en T */
+template <typename T>
+static ResumenSegmento<T> bucleOriginal(const T* datos, std::size_t n) {
+    T suma = T();
+    T minimo = datos[0];
+    T maximo = datos[0];
+    for (std::size_t i = 0; i < n; i++) {
+        suma += datos[i];
+        if (datos[i] < minimo) minimo = datos[i];
+        if (maximo < datos[i]) maximo = datos[i];
+    }
+    ResumenSegmento<T> r;
+    r.cantidad = n;
+    r.suma = suma;
+    r.minimo = minimo;
+    r.maximo = maximo;
+    return r;
+}
+
+static const NivelSimd NIVELES[] = { NivelSimd::Escalar, NivelSimd::Sse41, NivelSimd::Avx2 };
+
+template <typename T>
+static void informarPrecision(const char* tipo, const std::vector<T>& valores) {
+    long double exacta = 0.0L;
+    for (std::size_t i = 0; i < valores.size(); i++) {
+        exacta += static_cast<long double>(valores[i]);
+    }
+    double original = static_cast<double>(bucleOriginal(valores.data(), valores.size()).suma);
+    std::fprintf(stderr, "[Precision] %s n=%zu exacta=%.6Lf bucle=%.6f (error %.3g)",
+                 tipo, valores.size(), exacta, original, static_cast<double>(original - exacta));
+    for (NivelSimd nivel : NIVELES) {
+        fijarNivelSimd(nivel);
+        if (nivelSimdActivo() != nivel) {
+            continue;
+        }
+        double suma = KernelesAnalitica::resumir(valores.data(), valores.size()).obtenerSuma();
+        std::fprintf(stderr, " %s=%.3g", nombreNivelSimd(nivel), static_cast<double>(suma - exacta));
+    }
+    std::fprintf(stderr, "\n");
+    fijarNivelSimd(NivelSimd::Avx2);
+}
+
+template <typename T>
+static void medirKernels(ArnesMedicion& arnes, const char* tipo, std::uint64_t n) {
+    const std::vector<T> valores = generarValores<T>(n);
+    const T* datos = valores.data();
+    const std::size_t cantidad = valores.size();
+    const T bajo = static_cast<T>(5000);
+    const T alto = static_cast<T>(15000);
+    const std::uint64_t repeticiones = (n >= 10000000) ? 1 : 10000000 / n;
+    std::string nombre;
+
+    if (arnes.habilitado("Analitica::resumir")) {
+        nombre = std::string(tipo) + "/bucle";
+        arnes.medir("Analitica::resumir", nombre, n, [&](Cronometro& c) {
+            c.iniciar();
+            for (std::uint64_t r = 0; r < repeticiones; r++) {
+                noOptimizar(bucleOriginal(datos, cantidad));
+            }
+            c.detener();
+            return repeticiones * n;
+        });
+    }
+
+    for (NivelSimd nivel : NIVELES) {
+        fijarNivelSimd(nivel);
+        if (nivelSimdActivo() != nivel) {
+            continue;
+        }
+        nombre = std::string(tipo) + "/" + nombreNivelSimd(nivel);
+
+        arnes.medir("Analitica::resumir", nombre, n, [&](Cronometro& c) {
+            c.iniciar();
+            for (std::uint64_t r = 0; r < repeticiones; r++) {
+                noOptimizar(KernelesAnalitica::resumir(datos, cantidad));
+            }
+            c.detener();
+            return repeticiones * n;
+        });
+
+        arnes.medir("Analitica::varianza", nombre, n, [&](Cronometro& c) {
+            c.iniciar();
+            for (std::uint64_t r = 0; r < repeticiones; r++) {
+                noOptimizar(KernelesAnalitica::sumaCuadradosDesviacion(datos, cantidad, 12500.0));
+            }
+            c.detener();
+            return repeticiones * n;
+        });
+
+        arnes.medir("Analitica::contarEnRango", nombre, n, [&](Cronometro& c) {
+            c.iniciar();
+            for (std::uint64_t r = 0; r < repeticiones; r++) {
+                noOptimizar(KernelesAnalitica::contarEnRango(datos, cantidad, bajo, alto));
+            }
+            c.detener();
+            return repeticiones * n;
+        });
+    }
+    fijarNivelSimd(NivelSimd::Avx2);
+
+    // Las listas con el nivel que elija la CPU
+    if (arnes.habilitado("ListaSensorBloques::calcularVarianza")) {
+        ListaSensorBloques<T> bloques;
+        bloques.insertarVarios(datos, static_cast<int>(cantidad));
+        arnes.medir("ListaSensorBloques::calcularVarianza", tipo, n, [&](Cronometro& c) {
+            c.iniciar();
+            for (std::uint64_t r = 0; r < repeticiones; r++) {
+                noOptimizar(bloques.calcularVarianza());
+            }
+            c.detener();
+            return repeticiones * n;
+        });
+    }
+
+    if (arnes.habilitado("ListaSensorCircular::contarEnRango")) {
+        ListaSensorCircular<T> anillo(cantidad);
+        anillo.insertarVarios(datos, static_cast<int>(cantidad));
+        arnes.medir("ListaSensorCircular::contarEnRango", tipo, n, [&](Cronometro& c) {
+            c.iniciar();
+            for (std::uint64_t r = 0; r < repeticiones; r++) {
+                noOptimizar(anillo.contarEnRango(bajo, alto));
+            }
+            c.detener();
+            return repeticiones * n;
+        });
+    }
+}
+
+/** Suma y extremos de un historial con los algoritmos estándar, frente al
+ *  bucle escrito a mano con paraCada
+ */
+template <typename Lista>
+static void medirRecorrido(ArnesMedicion& arnes, const char* grupo, const Lista& lista,
+                           std::uint64_t n, std::uint64_t repeticiones) {
+    typedef typename Lista::value_type T;
+
+    arnes.medir(grupo, "suma/paraCada", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            double suma = 0.0;
+            lista.paraCada([&suma](const T& v) { suma += static_cast<double>(v); });
+            noOptimizar(suma);
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+
+    arnes.medir(grupo, "suma/accumulate", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            noOptimizar(std::accumulate(lista.begin(), lista.end(), 0.0));
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+
+    arnes.medir(grupo, "suma/reduce", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            noOptimizar(std::reduce(lista.begin(), lista.end(), 0.0));
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+
+#if SISTEMAIOT_EJECUCION_PARALELA
+    arnes.medir(grupo, "suma/reduce(par_unseq)", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            noOptimizar(std::reduce(std::execution::par_unseq, lista.begin(), lista.end(), 0.0));
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+#endif
+
+    arnes.medir(grupo, "minmax/paraCada", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            const T* minimo = nullptr;
+            const T* maximo = nullptr;
+            lista.paraCada([&](const T& v) {
+                if (minimo == nullptr || v < *minimo) minimo = &v;
+                if (maximo == nullptr || !(v < *maximo)) maximo = &v;
+            });
+            noOptimizar(std::make_pair(minimo, maximo));
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+
+    arnes.medir(grupo, "minmax/minmax_element", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            noOptimizar(std::minmax_element(lista.begin(), lista.end()));
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+}
+
+/** Los mismos algoritmos por tramos contiguos (iteradores de puntero) */
+template <typename Lista>
+static void medirTramos(ArnesMedicion& arnes, const char* grupo, const Lista& lista,
+                        std::uint64_t n, std::uint64_t repeticiones) {
+    typedef typename Lista::value_type T;
+
+    arnes.medir(grupo, "suma/tramos+reduce", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            double suma = 0.0;
+            for (TramoLecturas<T> tramo : lista.segmentos()) {
+                suma += std::reduce(tramo.begin(), tramo.end(), 0.0);
+            }
+            noOptimizar(suma);
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+
+#if SISTEMAIOT_EJECUCION_PARALELA
+    arnes.medir(grupo, "suma/tramos+reduce(par_unseq)", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            double suma = 0.0;
+            for (TramoLecturas<T> tramo : lista.segmentos()) {
+                suma += std::reduce(std::execution::par_unseq, tramo.begin(), tramo.end(), 0.0);
+            }
+            noOptimizar(suma);
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+#endif
+
+    arnes.medir(grupo, "minmax/tramos+minmax_element", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            const T* minimo = nullptr;
+            const T* maximo = nullptr;
+            for (TramoLecturas<T> tramo : lista.segmentos()) {
+                std::pair<const T*, const T*> mm = std::minmax_element(tramo.begin(), tramo.end());
+                if (minimo == nullptr || *mm.first < *minimo) minimo = mm.first;
+                if (maximo == nullptr || !(*mm.second < *maximo)) maximo = mm.second;
+            }
+            noOptimizar(std::make_pair(minimo, maximo));
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+}
+
+static void medirRecorridos(ArnesMedicion& arnes, std::uint64_t n) {
+    const std::vector<double> valores = generarValores<double>(n);
+    const int cantidad = static_cast<int>(valores.size());
+    const std::uint64_t repeticiones = (n >= 10000000) ? 1 : 10000000 / n;
+
+    if (arnes.habilitado("Recorrido::ListaSensor<Slab>")) {
+        ListaSensor<double> lista;
+        lista.insertarVarios(valores.data(), cantidad);
+        medirRecorrido(arnes, "Recorrido::ListaSensor<Slab>", lista, n, repeticiones);
+    }
+    if (arnes.habilitado("Recorrido::ListaSensorBloques")) {
+        ListaSensorBloques<double> bloques;
+        bloques.insertarVarios(valores.data(), cantidad);
+        medirRecorrido(arnes, "Recorrido::ListaSensorBloques", bloques, n, repeticiones);
+        medirTramos(arnes, "Recorrido::ListaSensorBloques", bloques, n, repeticiones);
+    }
+    if (arnes.habilitado("Recorrido::ListaSensorCircular")) {
+        ListaSensorCircular<double> anillo(valores.size());
+        anillo.insertarVarios(valores.data(), cantidad);
+        medirRecorrido(arnes, "Recorrido::ListaSensorCircular", anillo, n, repeticiones);
+        medirTramos(arnes, "Recorrido::ListaSensorCircular", anillo, n, repeticiones);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ArnesMedicion arnes;
+    arnes.configurar(argc, argv);
+
+    std::uint64_t maximo = 10000000;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--max=", 6) == 0) {
+            maximo = std::strtoull(argv[i] + 6, nullptr, 10);
+        }
+    }
+    std::fprintf(stderr, "[Info] Nivel SIMD disponible: %s\n", nombreNivelSimd(nivelSimdDisponible()));
+
+    informarPrecision<int>("int", generarValores<int>(maximo));
+    informarPrecision<float>("float", generarValores<float>(maximo));
+    informarPrecision<double>("double", generarValores<double>(maximo));
+
+    for (std::uint64_t n = 1000; n <= maximo; n *= 10) {
+        medirKernels<int>(arnes, "int", n);
+        medirKernels<float>(arnes, "float", n);
+        medirKernels<double>(arnes, "double", n);
+        medirRecorridos(arnes, n);
+    }
+
+    arnes.emitir("bench_analitica");
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ArnesMedicion.hpp"
+#include "BocetoCuantiles.hpp"
+
+// Percentiles con BocetoCuantiles frente al cálculo exacto ordenando una
+// copia del historial (std::sort o std::nth_element).
+// Uso: bench_cuantiles [--formato=tabla|csv|json] [--salida=archivo]
+//                      [--filtro=texto] [--tiempo=s] [--max=N]
+// La precisión (valor y error de rango de p50/p95/p99/p99.9, con un
+// boceto y con 16 bocetos combinados) se informa en stderr.
+
+static const double CUANTILES[] = { 0.50, 0.95, 0.99, 0.999 };
+static const int PARTES_COMBINADAS = 16;
+
+/** Lecturas sintéticas: temperatura ~ normal, presión con picos (lognormal) */
+static std::vector<double> generarLecturas(const char* distribucion, std::size_t n) {
+    std::vector<double> valores(n);
+    std::mt19937_64 generador(12345);
+    if (std::strcmp(distribucion, "normal") == 0) {
+        std::normal_distribution<double> d(22.0, 4.0);
+        for (double& v : valores) v = d(generador);
+    } else {
+        std::lognormal_distribution<double> d(11.5, 0.6);
+        for (double& v : valores) v = std::floor(d(generador));
+    }
+    return valores;
+}
+
+static double exacto(const std::vector<double>& ordenados, double q) {
+    return ordenados[static_cast<std::size_t>(q * static_cast<double>(ordenados.size() - 1))];
+}
+
+/** Fracción de lecturas menores que x (rango del valor estimado) */
+static double rango(const std::vector<double>& ordenados, double x) {
+    return static_cast<double>(std::lower_bound(ordenados.begin(), ordenados.end(), x) - ordenados.begin()) /
+           static_cast<double>(ordenados.size());
+}
+
+static void informarPrecision(const char* distribucion, std::size_t n) {
+    std::vector<double> valores = generarLecturas(distribucion, n);
+    BocetoCuantiles uno;
+    uno.agregarVarios(valores.data(), valores.size());
+
+    std::vector<BocetoCuantiles> partes(PARTES_COMBINADAS);
+    for (std::size_t i = 0; i < valores.size(); i++) {
+        partes[i % PARTES_COMBINADAS].agregar(valores[i]);
+    }
+    BocetoCuantiles combinado;
+    for (const BocetoCuantiles& parte : partes) {
+        combinado.combinar(parte);
+    }
+
+    std::sort(valores.begin(), valores.end());
+    std::fprintf(stderr, "[Precision] %s n=%zu centroides=%zu bytes=%zu\n", distribucion, n,
+                 uno.obtenerCentroides(), uno.bytesReservados());
+    for (double q : CUANTILES) {
+        double real = exacto(valores, q);
+        double estimado = uno.cuantil(q);
+        double unido = combinado.cuantil(q);
+        std::fprintf(stderr,
+                     "  p%-5g exacto=%-12.6g boceto=%-12.6g (rango %+.4f%%)  combinado=%-12.6g (rango %+.4f%%)\n",
+                     q * 100.0, real, estimado, (rango(valores, estimado) - q) * 100.0,
+                     unido, (rango(valores, unido) - q) * 100.0);
+    }
+}
+
+static void medir(ArnesMedicion& arnes, const char* distribucion, std::uint64_t n) {
+    const std::vector<double> valores = generarLecturas(distribucion, static_cast<std::size_t>(n));
+    const std::uint64_t repeticiones = (n >= 1000000) ? 1 : 1000000 / n;
+    std::vector<double> copia(valores.size());
+
+    arnes.medir("BocetoCuantiles::agregar", distribucion, n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < repeticiones; r++) {
+            BocetoCuantiles boceto;
+            boceto.agregarVarios(valores.data(), valores.size());
+            noOptimizar(boceto.obtenerCentroides());
+        }
+        c.detener();
+        return repeticiones * n;
+    });
+
+    // Consulta de p50/p95/p99: boceto ya lleno frente a ordenar la copia
+    BocetoCuantiles lleno;
+    lleno.agregarVarios(valores.data(), valores.size());
+    lleno.compactar();
+    const std::uint64_t consultas = 100000;
+
+    arnes.medir("Percentiles::p50/p95/p99", std::string(distribucion) + "/boceto", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < consultas; r++) {
+            noOptimizar(lleno.cuantil(0.50) + lleno.cuantil(0.95) + lleno.cuantil(0.99));
+        }
+        c.detener();
+        return consultas;
+    });
+
+    const std::uint64_t ordenamientos = (n >= 100000) ? 3 : 300000 / n;
+    arnes.medir("Percentiles::p50/p95/p99", std::string(distribucion) + "/sort", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < ordenamientos; r++) {
+            copia.assign(valores.begin(), valores.end());
+            std::sort(copia.begin(), copia.end());
+            noOptimizar(exacto(copia, 0.50) + exacto(copia, 0.95) + exacto(copia, 0.99));
+        }
+        c.detener();
+        return ordenamientos;
+    });
+
+    arnes.medir("Percentiles::p50/p95/p99", std::string(distribucion) + "/nth_element", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < ordenamientos; r++) {
+            copia.assign(valores.begin(), valores.end());
+            double suma = 0.0;
+            for (double q : { 0.50, 0.95, 0.99 }) {
+                std::size_t k = static_cast<std::size_t>(q * static_cast<double>(copia.size() - 1));
+                std::nth_element(copia.begin(), copia.begin() + static_cast<std::ptrdiff_t>(k), copia.end());
+                suma += copia[k];
+            }
+            noOptimizar(suma);
+        }
+        c.detener();
+        return ordenamientos;
+    });
+
+    // Unir 16 sensores (o 16 minutos) en un solo boceto
+    std::vector<BocetoCuantiles> partes(PARTES_COMBINADAS);
+    for (std::size_t i = 0; i < valores.size(); i++) {
+        partes[i % PARTES_COMBINADAS].agregar(valores[i]);
+    }
+    for (BocetoCuantiles& parte : partes) {
+        parte.compactar(true);
+    }
+    arnes.medir("BocetoCuantiles::combinar", std::string(distribucion) + "/x16", n, [&](Cronometro& c) {
+        c.iniciar();
+        for (std::uint64_t r = 0; r < consultas / 100; r++) {
+            BocetoCuantiles total;
+            for (const BocetoCuantiles& parte : partes) {
+                total.combinar(parte);
+            }
+            noOptimizar(total.cuantil(0.99));
+        }
+        c.detener();
+        return consultas / 100;
+    });
+}
+
+int main(int argc, char* argv[]) {
+    ArnesMedicion arnes;
+    arnes.configurar(argc, argv);
+
+    std::uint64_t maximo = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--max=", 6) == 0) {
+            maximo = std::strtoull(argv[i] + 6, nullptr, 10);
+        }
+    }
+
+    informarPrecision("normal", static_cast<std::size_t>(maximo));
+    informarPrecision("lognormal", static_cast<std::size_t>(maximo));
+
+    for (std::uint64_t n = 1000; n <= maximo; n *= 10) {
+        medir(arnes, "normal", n);
+        medir(arnes, "lognormal", n);
+    }
+
+    arnes.emitir("bench_cuantiles");
+    return 0;
+}
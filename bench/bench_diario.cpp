@@ -0,0 +1,251 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "RecuperacionDiario.hpp"
+
+// Lecturas por segundo de GestorSensores::registrarLectura con y sin diario,
+// para varias políticas de confirmación (lecturas por fdatasync / ms).
+// Antes de medir verifica que reproducir el diario (también con una cola
+// cortada y después de un punto de control) deja los mismos historiales;
+// si no, termina con código 1.
+// Uso: bench_diario [lecturas] [directorio]
+
+using std::cout;
+using std::endl;
+
+static double medir(DiarioLecturas* diario, long lecturas, std::uint64_t& syncs) {
+    GestorSensores gestor;
+    if (diario != nullptr) {
+        gestor.asignarDiario(diario);
+    }
+    char nombre[16];
+    for (int s = 0; s < 8; s++) {
+        std::snprintf(nombre, sizeof(nombre), "T%d", s);
+        gestor.agregarSensor(new SensorTemperaturaCircular(nombre, 4096));
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < lecturas; i++) {
+        gestor.registrarLectura(static_cast<std::uint32_t>(i & 7), 20.0 + static_cast<double>(i % 100) * 0.1);
+    }
+    if (diario != nullptr) {
+        diario->sincronizar();   // Se mide hasta que todo está en disco
+    }
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    syncs = (diario != nullptr) ? diario->obtenerSincronizaciones() : 0;
+    gestor.asignarDiario(nullptr);
+    return static_cast<double>(lecturas) / segundos;
+}
+
+/** true si ambos gestores tienen los mismos sensores con las mismas
+ *  lecturas (instante y valor), en orden */
+static bool mismosHistoriales(GestorSensores& esperado, GestorSensores& obtenido) {
+    if (esperado.obtenerCantidad() != obtenido.obtenerCantidad()) {
+        return false;
+    }
+    const std::int64_t desde = std::numeric_limits<std::int64_t>::min();
+    const std::int64_t hasta = std::numeric_limits<std::int64_t>::max();
+    for (std::uint32_t id = 0; id < static_cast<std::uint32_t>(esperado.obtenerCantidad()); id++) {
+        SensorBase* a = esperado.sensorPorId(id);
+        SensorBase* b = obtenido.buscarSensor(a->obtenerNombre());
+        if (b == nullptr) {
+            return false;
+        }
+        std::vector<LecturaTemporal> la;
+        std::vector<LecturaTemporal> lb;
+        a->lecturasEntre(desde, hasta, la);
+        b->lecturasEntre(desde, hasta, lb);
+        if (la.size() != lb.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < la.size(); i++) {
+            if (la[i].instanteMs != lb[i].instanteMs || la[i].valor != lb[i].valor) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void registrarVarias(GestorSensores& gestor, long desde, long n) {
+    for (long i = desde; i < desde + n; i++) {
+        gestor.registrarLectura(static_cast<std::uint32_t>(i % 3), static_cast<double>((i * 37) % 500) * 0.25);
+    }
+}
+
+/** Arranca como main: instantánea (si existe) y luego el diario */
+static ResumenReproduccion arrancar(DiarioLecturas& diario, GestorSensores& gestor, const char* rutaInstantanea) {
+    std::uint64_t generacion = 0;
+    InstantaneaMapeada instantanea(rutaInstantanea);
+    if (instantanea.estaAbierta()) {
+        restaurarInstantanea(instantanea, gestor);
+        generacion = instantanea.obtenerGeneracion();
+    }
+    return recuperarDiario(diario, gestor, generacion);
+}
+
+static bool informar(const char* prueba, bool correcto) {
+    cout << (correcto ? "ok     " : "FALLO  ") << prueba << endl;
+    return correcto;
+}
+
+/**
+ * Escribe lecturas (y procesamientos) con diario, reabre y compara los
+ * historiales recuperados con los originales: tras un cierre limpio,
+ * tras cortar el último registro a medias y tras un punto de control,
+ * incluida una caída entre guardar la instantánea y reiniciar el diario.
+ */
+static bool verificarReproduccion(const std::string& directorio) {
+    std::string rutaDiario = directorio + "/bench_diario_verificacion.wal";
+    std::string rutaInstantanea = directorio + "/bench_diario_verificacion.snap";
+    ::unlink(rutaDiario.c_str());
+    ::unlink(rutaInstantanea.c_str());
+    std::ostream descarte(nullptr);
+    bool correcto = true;
+
+    // 1. Cierre limpio: lecturas y un procesamiento (quita el mínimo)
+    GestorSensores original;
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        original.asignarDiario(&diario);
+        original.agregarSensor(new SensorTemperatura("V-T"));
+        original.agregarSensor(new SensorPresion("V-P"));
+        original.agregarSensor(new SensorTemperaturaBloques("V-B"));
+        registrarVarias(original, 0, 3000);
+        original.procesarTodosSensores(descarte);
+        registrarVarias(original, 3000, 3000);
+        original.asignarDiario(nullptr);
+    }
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores recuperado;
+        ResumenReproduccion resumen = arrancar(diario, recuperado, rutaInstantanea.c_str());
+        correcto &= informar("diario completo",
+                             resumen.bytesDescartados == 0 && mismosHistoriales(original, recuperado));
+        recuperado.asignarDiario(nullptr);
+    }
+
+    // 2. Cola cortada: medio registro de lectura al final (caída a mitad
+    //    de una escritura). Se descarta y lo nuevo queda contiguo a lo bueno.
+    {
+        const char medio[] = { 'L', 0, 0, 0, 0, 7, 7, 7, 7, 7 };
+        std::FILE* archivo = std::fopen(rutaDiario.c_str(), "ab");
+        std::fwrite(medio, 1, sizeof(medio), archivo);
+        std::fclose(archivo);
+    }
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores recuperado;
+        ResumenReproduccion resumen = arrancar(diario, recuperado, rutaInstantanea.c_str());
+        correcto &= informar("cola cortada descartada",
+                             resumen.bytesDescartados == 10 && mismosHistoriales(original, recuperado));
+        registrarVarias(recuperado, 6000, 500);
+        recuperado.asignarDiario(nullptr);
+        original = recuperado;   // Nueva referencia (la copia no hereda el diario)
+    }
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores recuperado;
+        ResumenReproduccion resumen = arrancar(diario, recuperado, rutaInstantanea.c_str());
+        correcto &= informar("lecturas anotadas tras truncar",
+                             resumen.bytesDescartados == 0 && mismosHistoriales(original, recuperado));
+        recuperado.asignarDiario(nullptr);
+    }
+
+    // 3. Punto de control: instantánea con generación g, diario reiniciado
+    //    y más lecturas; al arrancar se aplica sólo lo posterior. El anillo
+    //    agregado después sólo está en el diario: debe volver acotado.
+    std::uint64_t generacion = 0;
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores gestor;
+        arrancar(diario, gestor, rutaInstantanea.c_str());
+        bool guardado = guardarPuntoControl(gestor, &diario, rutaInstantanea.c_str());
+        generacion = diario.obtenerGeneracion();
+        registrarVarias(gestor, 7000, 800);
+        gestor.agregarSensor(new SensorTemperaturaCircular("V-C", 100, std::chrono::hours(1)));
+        for (int i = 0; i < 300; i++) {
+            gestor.registrarLectura(3, static_cast<double>(i % 40));
+        }
+        gestor.procesarTodosSensores(descarte);
+        gestor.asignarDiario(nullptr);
+        original = gestor;
+        correcto &= informar("guardar punto de control", guardado && generacion > 0);
+    }
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores recuperado;
+        ResumenReproduccion resumen = arrancar(diario, recuperado, rutaInstantanea.c_str());
+        correcto &= informar("instantánea + diario de la generación siguiente",
+                             !resumen.obsoleto && resumen.generacion == generacion &&
+                             mismosHistoriales(original, recuperado));
+        recuperado.asignarDiario(nullptr);
+    }
+
+    // 4. Caída entre guardar la instantánea y reiniciar el diario: el
+    //    diario viejo (generación menor) ya está en ella y no se aplica
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores gestor;
+        arrancar(diario, gestor, rutaInstantanea.c_str());
+        diario.sincronizar();
+        EscritorInstantanea escritor;
+        gestor.volcarInstantanea(escritor);
+        escritor.guardar(rutaInstantanea.c_str(), diario.obtenerGeneracion() + 1);
+        gestor.asignarDiario(nullptr);
+    }
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores recuperado;
+        ResumenReproduccion resumen = arrancar(diario, recuperado, rutaInstantanea.c_str());
+        correcto &= informar("diario anterior a la instantánea descartado",
+                             resumen.obsoleto && resumen.lecturas == 0 &&
+                             diario.obtenerGeneracion() == generacion + 1 &&
+                             mismosHistoriales(original, recuperado));
+        recuperado.asignarDiario(nullptr);
+    }
+
+    ::unlink(rutaDiario.c_str());
+    ::unlink(rutaInstantanea.c_str());
+    return correcto;
+}
+
+int main(int argc, char* argv[]) {
+    long lecturas = (argc > 1) ? std::atol(argv[1]) : 2000000;
+    const char* directorio = (argc > 2) ? argv[2] : ".";
+    char ruta[512];
+    std::snprintf(ruta, sizeof(ruta), "%s/bench_diario.wal", directorio);
+
+    const PoliticaDiario politicas[] = { { 1, 0, false }, { 1, 0, true }, { 64, 0, false }, { 64, 0, true },
+                                         { 4096, 200, false }, { 0, 1000, false } };
+
+    if (!verificarReproduccion(directorio)) {
+        return 1;
+    }
+
+    std::uint64_t syncs = 0;
+    cout << "Lecturas: " << lecturas << endl;
+    cout << "sin diario              " << medir(nullptr, lecturas, syncs) / 1e6 << " M lecturas/s" << endl;
+    for (const PoliticaDiario& p : politicas) {
+        ::unlink(ruta);
+        // Con un fsync por lectura (o por cada N, esperando) basta una muestra pequeña
+        long n = (p.lecturasPorSync == 1 || p.esperarDurable) ? lecturas / 1000 + 1 : lecturas;
+        double tasa;
+        {
+            DiarioLecturas diario(ruta, p);
+            tasa = medir(&diario, n, syncs);
+        }
+        cout << "N=" << p.lecturasPorSync << " T=" << p.intervaloMs << "ms"
+             << (p.esperarDurable ? " espera" : "       ") << "\t"
+             << tasa / 1e6 << " M lecturas/s, " << syncs << " fdatasync (" << n << " lecturas)" << endl;
+    }
+    ::unlink(ruta);
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DetectorAnomalias.hpp"
+#include "GeneradorCarga.hpp"
+#include "ServicioMultipuerto.hpp"
+#include "SensorTemperatura.hpp"
+#include "SensorPresion.hpp"
+
+// Rendimiento y latencia de extremo a extremo de la ingesta: GeneradorCarga
+// escribe en pseudo-terminales y ServicioMultipuerto las lee, interpreta y
+// aplica al GestorSensores. La latencia sale de las sondas LAT<p>.
+// Uso: bench_ingesta [--puertos=4] [--sensores=8] [--tasa=0] [--malformadas=0.01]
+//                    [--rafaga=0] [--periodo-rafaga=1000] [--segundos=5]
+//                    [--lectores=1] [--aplicadores=1] [--sonda=1000]
+//                    [--metricas=archivo]  (activa RegistroMetricas y lo vuelca al final)
+//                    [--anomalias=0|1] [--salto=0]  (DetectorAnomalias con z > 4 y, si
+//                    salto > 0, límite de variación entre lecturas de temperatura)
+
+using std::cout;
+using std::endl;
+
+/**
+ * Sensor receptor de las sondas: cada valor es el instante de envío en
+ * µs de CLOCK_MONOTONIC. Lo aplica siempre el mismo hilo aplicador.
+ */
+class SensorLatencia : public SensorBase {
+public:
+    explicit SensorLatencia(const char* nom) : SensorBase(nom) {}
+
+    void registrarLectura(double valor) override {
+        latencias.push_back(GeneradorCarga::relojMonotonoUs() - static_cast<std::int64_t>(valor));
+    }
+
+    using SensorBase::procesarLectura;
+    void procesarLectura(std::ostream&) override {}
+    void imprimirInfo() const override {}
+    TipoSensor obtenerTipo() const override { return TipoSensor::Temperatura; }
+    SensorBase* clonar() const override { return new SensorLatencia(*this); }
+    void serializar(EscritorInstantanea&) const override {}
+    bool restaurar(const InstantaneaMapeada&, std::uint32_t) override { return false; }
+
+    std::vector<std::int64_t> latencias;   ///< µs
+};
+
+static const char* opcion(const char* argumento, const char* nombre) {
+    std::size_t n = std::strlen(nombre);
+    return (std::strncmp(argumento, nombre, n) == 0 && argumento[n] == '=') ? argumento + n + 1 : nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    ConfiguracionCarga config;
+    config.puertos = 4;
+    config.sensoresPorPuerto = 8;
+    config.lineasPorSegundo = 0.0;
+    config.fraccionMalformadas = 0.01;
+    config.sondaCada = 1000;
+    double segundos = 5.0;
+    int lectores = 1;
+    int aplicadores = 1;
+    std::string rutaMetricas;
+    bool anomalias = false;
+    double salto = 0.0;
+    for (int i = 1; i < argc; i++) {
+        const char* v;
+        if ((v = opcion(argv[i], "--puertos"))) config.puertos = std::atoi(v);
+        else if ((v = opcion(argv[i], "--sensores"))) config.sensoresPorPuerto = std::atoi(v);
+        else if ((v = opcion(argv[i], "--tasa"))) config.lineasPorSegundo = std::atof(v);
+        else if ((v = opcion(argv[i], "--malformadas"))) config.fraccionMalformadas = std::atof(v);
+        else if ((v = opcion(argv[i], "--rafaga"))) config.lineasPorRafaga = static_cast<std::uint32_t>(std::atol(v));
+        else if ((v = opcion(argv[i], "--periodo-rafaga"))) config.periodoRafagaMs = static_cast<std::uint32_t>(std::atol(v));
+        else if ((v = opcion(argv[i], "--segundos"))) segundos = std::atof(v);
+        else if ((v = opcion(argv[i], "--sonda"))) config.sondaCada = static_cast<std::uint32_t>(std::atol(v));
+        else if ((v = opcion(argv[i], "--lectores"))) lectores = std::atoi(v);
+        else if ((v = opcion(argv[i], "--aplicadores"))) aplicadores = std::atoi(v);
+        else if ((v = opcion(argv[i], "--metricas"))) rutaMetricas = v;
+        else if ((v = opcion(argv[i], "--anomalias"))) anomalias = std::atoi(v) != 0;
+        else if ((v = opcion(argv[i], "--salto"))) salto = std::atof(v);
+    }
+
+    GestorSensores gestor;
+    RegistroMetricas metricas;
+    if (!rutaMetricas.empty()) {
+        gestor.asignarMetricas(&metricas);
+    }
+    // Las alertas se formatean hacia un flujo sin destino: se mide la
+    // detección y el drenado, no la escritura en la terminal
+    DetectorAnomalias detector;
+    std::ostream descarte(nullptr);
+    AlertadorAnomalias alertador(detector, descarte);
+    if (anomalias) {
+        gestor.asignarDetector(&detector);
+    }
+    std::vector<SensorLatencia*> sondas;
+    for (int p = 0; p < config.puertos; p++) {
+        for (int s = 0; s < config.sensoresPorPuerto; s++) {
+            std::string nombre = GeneradorCarga::nombreSensor(p, s);
+            if (GeneradorCarga::esTemperatura(s)) {
+                gestor.agregarSensor(new SensorTemperaturaCircular(nombre.c_str(), 4096));
+            } else {
+                gestor.agregarSensor(new SensorPresionCircular(nombre.c_str(), 4096));
+            }
+        }
+        SensorLatencia* sonda = new SensorLatencia(GeneradorCarga::nombreSonda(p).c_str());
+        gestor.agregarSensor(sonda);
+        sondas.push_back(sonda);
+    }
+    if (anomalias) {
+        for (std::uint32_t id = 0; id < gestor.obtenerCantidadIds(); id++) {
+            const char* nombre = gestor.sensorPorId(id)->obtenerNombre();
+            if (std::strncmp(nombre, "LAT", 3) == 0) {
+                detector.configurar(id, { 0.05, 0.0, 0, 0.0, 0.0 });  // Las sondas son instantes, no lecturas
+            } else if (std::strncmp(nombre, "TEMP", 4) == 0) {
+                detector.configurar(id, { 0.05, 4.0, 32, salto, 0.01 });
+            }
+        }
+        alertador.iniciar();
+    }
+
+    GeneradorCarga generador(config);
+    if (!generador.crearPuertos()) {
+        return 1;
+    }
+    ServicioMultipuerto servicio(gestor, lectores, aplicadores);
+    for (int p = 0; p < generador.obtenerCantidadPuertos(); p++) {
+        if (!servicio.agregarPuerto(generador.obtenerRutaPuerto(p))) {
+            return 1;
+        }
+    }
+
+    servicio.iniciar();
+    auto inicio = std::chrono::steady_clock::now();
+    generador.iniciar();
+    std::this_thread::sleep_for(std::chrono::duration<double>(segundos));
+    generador.detener();
+    double tEmision = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    // Esperar a que el servicio vacíe lo que quedó en los pty y las colas
+    const std::uint64_t enviadas = generador.obtenerLineasEnviadas();
+    auto procesadas = [&]() {
+        return servicio.obtenerLecturasAplicadas() + servicio.obtenerLineasInvalidas() +
+               servicio.obtenerSensoresDesconocidos();
+    };
+    auto limite = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (procesadas() < enviadas && std::chrono::steady_clock::now() < limite) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double tTotal = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    servicio.detener();
+    alertador.detener();
+
+    std::vector<std::int64_t> latencias;
+    for (SensorLatencia* s : sondas) {
+        latencias.insert(latencias.end(), s->latencias.begin(), s->latencias.end());
+    }
+    std::sort(latencias.begin(), latencias.end());
+    auto percentil = [&](double q) -> double {
+        if (latencias.empty()) return 0.0;
+        std::size_t i = static_cast<std::size_t>(q * static_cast<double>(latencias.size() - 1));
+        return static_cast<double>(latencias[i]);
+    };
+
+    std::uint64_t aplicadas = servicio.obtenerLecturasAplicadas();
+    cout << "Puertos: " << config.puertos << " x " << config.sensoresPorPuerto << " sensor(es), tasa "
+         << (config.lineasPorSegundo > 0.0 ? std::to_string(static_cast<long>(config.lineasPorSegundo)) + "/s por puerto"
+                                           : std::string("saturación"))
+         << ", lectores " << lectores << ", aplicadores " << aplicadores << endl;
+    cout << "Enviadas: " << enviadas << " (" << generador.obtenerMalformadasEnviadas() << " malformadas, "
+         << generador.obtenerSondasEnviadas() << " sondas, " << generador.obtenerRafagas() << " ráfagas)" << endl;
+    cout << "Aplicadas: " << aplicadas << ", inválidas: " << servicio.obtenerLineasInvalidas()
+         << ", desconocidas: " << servicio.obtenerSensoresDesconocidos() << endl;
+    cout << "Rendimiento: " << enviadas / tEmision / 1e6 << " M líneas/s emitidas, "
+         << aplicadas / tTotal / 1e6 << " M lecturas/s aplicadas ("
+         << generador.obtenerBytesEnviados() / tEmision / (1024.0 * 1024.0) << " MiB/s)" << endl;
+    cout << "Latencia (µs, " << latencias.size() << " sondas): p50 " << percentil(0.50)
+         << ", p99 " << percentil(0.99) << ", p99.9 " << percentil(0.999)
+         << ", máx " << (latencias.empty() ? 0.0 : static_cast<double>(latencias.back())) << endl;
+    if (anomalias) {
+        cout << "Anomalías: " << detector.obtenerDetectadas() << " detectada(s), "
+             << detector.obtenerDescartadas() << " descartada(s) por cola llena, "
+             << alertador.obtenerEmitidas() << " alerta(s) drenadas" << endl;
+    }
+    if (!rutaMetricas.empty()) {
+        ResumenHistograma ingesta = metricas.latenciaIngesta().resumir();
+        cout << "Latencia de ingesta (µs, " << ingesta.cantidad << " lecturas, puerto -> sensor): p50 "
+             << ingesta.percentil(0.50) / 1000.0 << ", p99 " << ingesta.percentil(0.99) / 1000.0
+             << ", máx " << ingesta.maximo / 1000.0 << endl;
+        if (!metricas.volcarArchivo(rutaMetricas)) {
+            std::cerr << "[Error] No se pudo escribir " << rutaMetricas << endl;
+        }
+    }
+    return (procesadas() == enviadas) ? 0 : 1;
+}
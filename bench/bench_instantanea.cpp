@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+#include "RecuperacionDiario.hpp"
+
+// Arranque en caliente: reproducir el diario completo frente a mapear una
+// instantánea con los mismos sensores.
+// Uso: bench_instantanea [sensores] [lecturas por sensor] [directorio]
+
+using std::cout;
+using std::endl;
+
+static double segundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+int main(int argc, char* argv[]) {
+    int sensores = (argc > 1) ? std::atoi(argv[1]) : 100;
+    long lecturas = (argc > 2) ? std::atol(argv[2]) : 20000;
+    std::string directorio = (argc > 3) ? argv[3] : ".";
+    std::string rutaDiario = directorio + "/bench_instantanea.wal";
+    std::string rutaInstantanea = directorio + "/bench_instantanea.snap";
+    ::unlink(rutaDiario.c_str());
+    ::unlink(rutaInstantanea.c_str());
+
+    {
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores gestor;
+        gestor.asignarDiario(&diario);
+        char nombre[16];
+        for (int s = 0; s < sensores; s++) {
+            std::snprintf(nombre, sizeof(nombre), "S%d", s);
+            if (s % 2 == 0) {
+                gestor.agregarSensor(new SensorTemperatura(nombre));
+            } else {
+                gestor.agregarSensor(new SensorPresionBloques(nombre));
+            }
+        }
+        for (long i = 0; i < lecturas; i++) {
+            for (int s = 0; s < sensores; s++) {
+                gestor.registrarLectura(static_cast<std::uint32_t>(s), static_cast<double>((i * 31 + s) % 1000) * 0.1);
+            }
+        }
+        EscritorInstantanea escritor;
+        auto inicio = std::chrono::steady_clock::now();
+        gestor.volcarInstantanea(escritor);
+        escritor.guardar(rutaInstantanea.c_str(), 1);
+        cout << "Sensores: " << sensores << ", lecturas: " << static_cast<long>(sensores) * lecturas << endl;
+        cout << "guardar instantánea        " << segundosDesde(inicio) * 1e3 << " ms" << endl;
+        gestor.asignarDiario(nullptr);
+    }
+
+    {
+        auto inicio = std::chrono::steady_clock::now();
+        DiarioLecturas diario(rutaDiario.c_str());
+        GestorSensores gestor;
+        ResumenReproduccion resumen = recuperarDiario(diario, gestor);
+        cout << "reproducir diario          " << segundosDesde(inicio) * 1e3 << " ms ("
+             << resumen.lecturas << " registros)" << endl;
+        gestor.asignarDiario(nullptr);
+    }
+
+    {
+        auto inicio = std::chrono::steady_clock::now();
+        InstantaneaMapeada instantanea(rutaInstantanea.c_str());
+        GestorSensores gestor;
+        std::uint32_t n = restaurarInstantanea(instantanea, gestor);
+        cout << "cargar instantánea (mmap)  " << segundosDesde(inicio) * 1e3 << " ms ("
+             << n << " sensores)" << endl;
+    }
+
+    ::unlink(rutaDiario.c_str());
+    ::unlink(rutaInstantanea.c_str());
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pty.h>
+#include <unistd.h>
+
+#include "ServicioMultipuerto.hpp"
+#include "SensorTemperatura.hpp"
+
+// Rendimiento de la ingesta multipuerto con pseudo-terminales como puertos.
+// Uso: bench_multipuerto [puertos] [lectores] [aplicadores] [lineas por puerto]
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+static const int SENSORES_POR_PUERTO = 8;
+
+/** Escribe lineas "P<puerto>S<k>:valor" en el extremo maestro del pty */
+static void emitir(int fdMaestro, int puerto, long lineas) {
+    std::string bloque;
+    char linea[64];
+    long enviadas = 0;
+    while (enviadas < lineas) {
+        bloque.clear();
+        for (int i = 0; i < 256 && enviadas < lineas; i++, enviadas++) {
+            int n = std::snprintf(linea, sizeof(linea), "P%dS%ld:%ld.%ld\r\n", puerto,
+                                  enviadas % SENSORES_POR_PUERTO, enviadas % 100, enviadas % 10);
+            bloque.append(linea, static_cast<std::size_t>(n));
+        }
+        std::size_t escritos = 0;
+        while (escritos < bloque.size()) {
+            ssize_t n = ::write(fdMaestro, bloque.data() + escritos, bloque.size() - escritos);
+            if (n <= 0) {
+                return;
+            }
+            escritos += static_cast<std::size_t>(n);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int numPuertos = (argc > 1) ? std::atoi(argv[1]) : 4;
+    int lectores = (argc > 2) ? std::atoi(argv[2]) : 1;
+    int aplicadores = (argc > 3) ? std::atoi(argv[3]) : 1;
+    long lineas = (argc > 4) ? std::atol(argv[4]) : 200000;
+
+    GestorSensores gestor;
+    char nombre[50];
+    for (int p = 0; p < numPuertos; p++) {
+        for (int s = 0; s < SENSORES_POR_PUERTO; s++) {
+            std::snprintf(nombre, sizeof(nombre), "P%dS%d", p, s);
+            gestor.agregarSensor(new SensorTemperatura(nombre));
+        }
+    }
+
+    ServicioMultipuerto servicio(gestor, lectores, aplicadores);
+    std::vector<int> maestros;
+    for (int p = 0; p < numPuertos; p++) {
+        int maestro = -1;
+        int esclavo = -1;
+        char ruta[128];
+        if (::openpty(&maestro, &esclavo, ruta, nullptr, nullptr) != 0) {
+            cerr << "[Error] openpty falló" << endl;
+            return 1;
+        }
+        if (!servicio.agregarPuerto(ruta)) {
+            return 1;
+        }
+        ::close(esclavo);   // El servicio mantiene su propio descriptor
+        maestros.push_back(maestro);
+    }
+
+    const std::uint64_t esperadas = static_cast<std::uint64_t>(numPuertos) * lineas;
+    auto inicio = std::chrono::steady_clock::now();
+    servicio.iniciar();
+
+    std::vector<std::thread> emisores;
+    for (int p = 0; p < numPuertos; p++) {
+        emisores.emplace_back(emitir, maestros[p], p, lineas);
+    }
+    for (std::thread& e : emisores) {
+        e.join();
+    }
+    while (servicio.obtenerLecturasAplicadas() + servicio.obtenerLineasInvalidas() < esperadas &&
+           std::chrono::steady_clock::now() - inicio < std::chrono::seconds(60)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    servicio.detener();
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    for (int m : maestros) {
+        ::close(m);
+    }
+
+    std::uint64_t aplicadas = servicio.obtenerLecturasAplicadas();
+    cout << "Puertos: " << numPuertos << ", lectores: " << lectores
+         << ", aplicadores: " << aplicadores << endl;
+    cout << "Lecturas aplicadas: " << aplicadas << " de " << esperadas
+         << " (inválidas " << servicio.obtenerLineasInvalidas()
+         << ", desconocidas " << servicio.obtenerSensoresDesconocidos()
+         << ", esperas por cola llena " << servicio.obtenerEsperasColaLlena() << ")" << endl;
+    cout << "Rendimiento: " << aplicadas / segundos / 1e6 << " M lecturas/s en "
+         << segundos << " s (" << std::thread::hardware_concurrency() << " núcleo(s))" << endl;
+    return (aplicadas == esperadas) ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "ParserLecturas.hpp"
+
+// Microbenchmark del intérprete ID:valor sobre una captura real de sensor.ino.
+// Uso: bench_parser [captura.txt] [MiB]
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#ifndef SISTEMAIOT_DIR_DATOS
+#define SISTEMAIOT_DIR_DATOS "bench/datos"
+#endif
+
+/**
+ * Versión anterior de conectarArduino: copia cada línea con strncpy a
+ * buffers de 50 bytes y convierte con atof. Sirve de referencia.
+ */
+static double interpretarAnterior(const std::string& flujo, long& lineas) {
+    double suma = 0.0;
+    const char* p = flujo.c_str();
+    char linea[256];
+    while (*p != '\0') {
+        const char* salto = std::strchr(p, '\n');
+        std::size_t largo = (salto == nullptr) ? std::strlen(p) : static_cast<std::size_t>(salto - p);
+        if (largo >= sizeof(linea)) largo = sizeof(linea) - 1;
+        std::memcpy(linea, p, largo);
+        linea[largo] = '\0';
+        p = (salto == nullptr) ? p + largo : salto + 1;
+
+        char* separador = std::strchr(linea, ':');
+        if (separador == nullptr) continue;
+        char idSensor[50];
+        char valorStr[50];
+        int idLen = static_cast<int>(separador - linea);
+        if (idLen >= 50) continue;
+        std::strncpy(idSensor, linea, idLen);
+        idSensor[idLen] = '\0';
+        std::strncpy(valorStr, separador + 1, sizeof(valorStr) - 1);
+        valorStr[sizeof(valorStr) - 1] = '\0';
+        suma += std::atof(valorStr) + idSensor[0];
+        lineas++;
+    }
+    return suma;
+}
+
+template <typename Funcion>
+static double medirMejor(int repeticiones, Funcion funcion) {
+    double mejor = 1e30;
+    for (int i = 0; i < repeticiones; i++) {
+        auto inicio = std::chrono::steady_clock::now();
+        funcion();
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        if (s < mejor) mejor = s;
+    }
+    return mejor;
+}
+
+int main(int argc, char* argv[]) {
+    std::string ruta = (argc > 1) ? argv[1] : SISTEMAIOT_DIR_DATOS "/captura_sensor_ino.txt";
+    long mib = (argc > 2) ? std::atol(argv[2]) : 32;
+
+    std::ifstream archivo(ruta, std::ios::binary);
+    if (!archivo) {
+        cerr << "[Error] No se pudo abrir la captura " << ruta << endl;
+        return 1;
+    }
+    std::stringstream contenido;
+    contenido << archivo.rdbuf();
+    const std::string captura = contenido.str();
+
+    std::string flujo;
+    flujo.reserve(static_cast<std::size_t>(mib) * 1024 * 1024 + captura.size());
+    while (flujo.size() < static_cast<std::size_t>(mib) * 1024 * 1024) {
+        flujo += captura;
+    }
+
+    long lineasNuevo = 0;
+    double sumaNuevo = 0.0;
+    double tNuevo = medirMejor(5, [&]() {
+        ParserLecturas parser;
+        double suma = 0.0;
+        parser.interpretar(flujo.data(), flujo.size(), [&suma](const LecturaCruda& l) {
+            suma += l.valor + l.id[0];
+        });
+        lineasNuevo = static_cast<long>(parser.obtenerLineasValidas());
+        sumaNuevo = suma;
+    });
+
+    long lineasAnterior = 0;
+    double sumaAnterior = 0.0;
+    double tAnterior = medirMejor(5, [&]() {
+        lineasAnterior = 0;
+        sumaAnterior = interpretarAnterior(flujo, lineasAnterior);
+    });
+
+    double megas = flujo.size() / (1024.0 * 1024.0);
+    cout << "Captura: " << ruta << " (" << captura.size() << " bytes), flujo de "
+         << megas << " MiB" << endl;
+    cout << "ParserLecturas   : " << lineasNuevo / tNuevo / 1e6 << " M líneas/s, "
+         << megas / tNuevo << " MiB/s (control " << sumaNuevo << ")" << endl;
+    cout << "strncpy + atof   : " << lineasAnterior / tAnterior / 1e6 << " M líneas/s, "
+         << megas / tAnterior << " MiB/s (control " << sumaAnterior << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+#include "AlmacenSensores.hpp"
+#include "GestorSensores.hpp"
+#include "SensorTemperatura.hpp"
+#include "SensorPresion.hpp"
+
+// Latencia de una pasada de procesarTodosSensores según el número de hilos,
+// y la misma pasada (más el registro por id) en el almacén por tipo.
+// Uso: bench_procesamiento [sensores] [lecturas por sensor] [pasadas]
+
+using std::cout;
+using std::endl;
+
+/** Descarta todo lo escrito: se mide el procesamiento, no la terminal */
+class BufferNulo : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+};
+
+static void poblar(GestorSensores& gestor, int sensores, int lecturas) {
+    char nombre[50];
+    unsigned semilla = 12345;
+    for (int s = 0; s < sensores; s++) {
+        std::snprintf(nombre, sizeof(nombre), "S%d", s);
+        SensorBase* sensor = (s % 2 == 0)
+            ? static_cast<SensorBase*>(new SensorTemperatura(nombre))
+            : static_cast<SensorBase*>(new SensorPresion(nombre));
+        // Historiales de largo desigual: unos sensores cuestan más que otros
+        int largo = lecturas / 2 + (s % 7) * lecturas / 6;
+        for (int i = 0; i < largo; i++) {
+            semilla = semilla * 1103515245u + 12345u;
+            sensor->registrarLectura(static_cast<double>(semilla % 100000) / 100.0);
+        }
+        gestor.agregarSensor(sensor);
+    }
+}
+
+/** Mismos sensores e historiales que poblar(), en arreglos por tipo */
+static void poblarAlmacen(AlmacenSensores& almacen, int sensores, int lecturas) {
+    char nombre[50];
+    unsigned semilla = 12345;
+    almacen.reservar<SensorTemperatura>(static_cast<std::size_t>(sensores / 2 + 1));
+    almacen.reservar<SensorPresion>(static_cast<std::size_t>(sensores / 2 + 1));
+    for (int s = 0; s < sensores; s++) {
+        std::snprintf(nombre, sizeof(nombre), "S%d", s);
+        std::int32_t id = (s % 2 == 0) ? almacen.emplazar<SensorTemperatura>(nombre)
+                                       : almacen.emplazar<SensorPresion>(nombre);
+        int largo = lecturas / 2 + (s % 7) * lecturas / 6;
+        for (int i = 0; i < largo; i++) {
+            semilla = semilla * 1103515245u + 12345u;
+            almacen.registrarLectura(static_cast<std::uint32_t>(id),
+                                     static_cast<double>(semilla % 100000) / 100.0);
+        }
+    }
+}
+
+/** Milisegundos de registrar `lecturas` lecturas repartidas por id */
+template <typename Destino>
+static double medirRegistro(Destino& destino, int sensores, int lecturas) {
+    unsigned x = 777;
+    auto inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < lecturas; i++) {
+        x = x * 1664525u + 1013904223u;
+        destino.registrarLectura((x >> 8) % static_cast<unsigned>(sensores), static_cast<double>(x % 5000) / 10.0);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+int main(int argc, char* argv[]) {
+    int sensores = (argc > 1) ? std::atoi(argv[1]) : 2000;
+    int lecturas = (argc > 2) ? std::atoi(argv[2]) : 4000;
+    int pasadas = (argc > 3) ? std::atoi(argv[3]) : 5;
+
+    BufferNulo nulo;
+    std::ostream salida(&nulo);
+
+    cout << "Sensores: " << sensores << ", lecturas por sensor ~" << lecturas
+         << ", núcleos: " << std::thread::hardware_concurrency() << endl;
+    cout << "hilos  primera pasada (ms)  siguientes (ms)  robos" << endl;
+
+    const int hilosProbados[] = { 0, 1, 2, 4, 8 };
+    for (int hilos : hilosProbados) {
+        GestorSensores gestor;
+        poblar(gestor, sensores, lecturas);
+        PoolTrabajo pool(hilos == 0 ? 1 : hilos);
+
+        double primera = 0.0;
+        double resto = 0.0;
+        for (int p = 0; p < pasadas; p++) {
+            auto inicio = std::chrono::steady_clock::now();
+            if (hilos == 0) {
+                gestor.procesarTodosSensores(salida);
+            } else {
+                gestor.procesarTodosSensores(pool, salida);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+            if (p == 0) primera = ms; else resto += ms;
+        }
+        std::printf("%5s  %20.2f  %15.3f  %5llu\n",
+                    hilos == 0 ? "sec" : std::to_string(hilos).c_str(), primera,
+                    pasadas > 1 ? resto / (pasadas - 1) : 0.0,
+                    static_cast<unsigned long long>(pool.obtenerRobos()));
+    }
+
+    // Secuencial: lista polimórfica frente a arreglos por tipo
+    cout << "\nalmacén            primera pasada (ms)  siguientes (ms)  registro 10^6 (ms)" << endl;
+    for (int variante = 0; variante < 2; variante++) {
+        double primera = 0.0;
+        double resto = 0.0;
+        double registro = 0.0;
+        GestorSensores gestor;
+        AlmacenSensores almacen;
+        if (variante == 0) {
+            poblar(gestor, sensores, lecturas);
+        } else {
+            poblarAlmacen(almacen, sensores, lecturas);
+        }
+        for (int p = 0; p < pasadas; p++) {
+            auto inicio = std::chrono::steady_clock::now();
+            if (variante == 0) {
+                gestor.procesarTodosSensores(salida);
+            } else {
+                almacen.procesarTodos(salida);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+            if (p == 0) primera = ms; else resto += ms;
+        }
+        registro = (variante == 0) ? medirRegistro(gestor, sensores, 1000000)
+                                   : medirRegistro(almacen, sensores, 1000000);
+        std::printf("%-17s  %20.2f  %15.3f  %18.2f\n",
+                    variante == 0 ? "GestorSensores" : "AlmacenSensores", primera,
+                    pasadas > 1 ? resto / (pasadas - 1) : 0.0, registro);
+    }
+    return 0;
+}
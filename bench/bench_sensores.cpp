@@ -0,0 +1,411 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ArnesMedicion.hpp"
+#include "GestorSensores.hpp"
+#include "ListaSensor.hpp"
+#include "ListaSensorBloques.hpp"
+#include "ListaSensorCircular.hpp"
+#include "ParserLecturas.hpp"
+#include "SensorPresion.hpp"
+#include "SensorTemperatura.hpp"
+
+// Suite de microbenchmarks de las estructuras del sistema.
+// Uso: bench_sensores [--formato=tabla|csv|json] [--salida=archivo]
+//                     [--filtro=texto] [--tiempo=s] [--max=N] [--captura=ruta]
+// --max limita el tamaño de las listas (10^7 por omisión).
+
+#ifndef SISTEMAIOT_DIR_DATOS
+#define SISTEMAIOT_DIR_DATOS "bench/datos"
+#endif
+
+/** Valores pseudoaleatorios reproducibles, sin orden (para el montículo) */
+template <typename T>
+static std::vector<T> generarValores(std::uint64_t n) {
+    std::vector<T> valores(static_cast<std::size_t>(n));
+    std::uint32_t x = 2463534242u;
+    for (std::size_t i = 0; i < valores.size(); i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        valores[i] = static_cast<T>(x % 100000u) / static_cast<T>(4);
+    }
+    return valores;
+}
+
+template <typename T>
+static void medirLista(ArnesMedicion& arnes, const char* tipo, std::uint64_t n) {
+    const std::vector<T> valores = generarValores<T>(n);
+
+    arnes.medir("ListaSensor::insertar", tipo, n, [&](Cronometro& c) {
+        ListaSensor<T>* lista = new ListaSensor<T>();
+        c.iniciar();
+        for (std::size_t i = 0; i < valores.size(); i++) {
+            lista->insertar(valores[i]);
+        }
+        c.detener();
+        noOptimizar(lista->obtenerCantidad());
+        delete lista;
+        return n;
+    });
+
+    // Misma inserción con instante (una lectura cada 100 ms)
+    arnes.medir("ListaSensor::insertarEn", tipo, n, [&](Cronometro& c) {
+        ListaSensor<T>* lista = new ListaSensor<T>();
+        const std::int64_t inicio = 1700000000000LL;
+        c.iniciar();
+        for (std::size_t i = 0; i < valores.size(); i++) {
+            lista->insertarEn(valores[i], inicio + 100 * static_cast<std::int64_t>(i));
+        }
+        c.detener();
+        noOptimizar(lista->obtenerCantidad());
+        delete lista;
+        return n;
+    });
+
+    if (!arnes.habilitado("ListaSensor::buscar") && !arnes.habilitado("ListaSensor::calcularPromedio") &&
+        !arnes.habilitado("ListaSensor::obtenerMinimo") && !arnes.habilitado("ListaSensor::eliminarMinimo")) {
+        return;
+    }
+
+    ListaSensor<T> lista;
+    lista.insertarVarios(valores.data(), static_cast<int>(valores.size()));
+
+    // Valor ausente: cada búsqueda recorre la lista completa
+    const std::uint64_t busquedas = (n >= 10000000) ? 3 : 10000000 / n;
+    arnes.medir("ListaSensor::buscar", tipo, n, [&](Cronometro& c) {
+        bool encontrado = false;
+        c.iniciar();
+        for (std::uint64_t i = 0; i < busquedas; i++) {
+            encontrado |= lista.buscar(static_cast<T>(-1));
+        }
+        c.detener();
+        noOptimizar(encontrado);
+        return busquedas;
+    });
+
+    const std::uint64_t consultas = 1000000;
+    arnes.medir("ListaSensor::calcularPromedio", tipo, n, [&](Cronometro& c) {
+        double suma = 0.0;
+        c.iniciar();
+        for (std::uint64_t i = 0; i < consultas; i++) {
+            suma += lista.calcularPromedio();
+            noOptimizar(suma);
+        }
+        c.detener();
+        return consultas;
+    });
+
+    arnes.medir("ListaSensor::obtenerMinimo", tipo, n, [&](Cronometro& c) {
+        T minimo = T();
+        c.iniciar();
+        for (std::uint64_t i = 0; i < consultas; i++) {
+            minimo = lista.obtenerMinimo();
+            noOptimizar(minimo);
+        }
+        c.detener();
+        return consultas;
+    });
+
+    // Incluye la construcción perezosa del montículo en la primera llamada
+    const std::uint64_t eliminaciones = (n < 100000) ? n : 100000;
+    arnes.medir("ListaSensor::eliminarMinimo", tipo, n, [&](Cronometro& c) {
+        ListaSensor<T> copia(lista);
+        c.iniciar();
+        for (std::uint64_t i = 0; i < eliminaciones; i++) {
+            copia.eliminarMinimo();
+        }
+        c.detener();
+        noOptimizar(copia.obtenerCantidad());
+        return eliminaciones;
+    });
+}
+
+/** Entregar un historial completo a otra etapa: copia profunda frente a
+ *  movimiento; y empalmar dos historiales frente a copiar uno al final
+ */
+template <typename Lista>
+static void medirTraspaso(ArnesMedicion& arnes, const char* nombreLista, std::uint64_t n) {
+    const std::string grupoTraspaso = std::string("Traspaso::") + nombreLista;
+    const std::string grupoEmpalme = std::string("Empalmar::") + nombreLista;
+    if (!arnes.habilitado(grupoTraspaso) && !arnes.habilitado(grupoEmpalme)) {
+        return;
+    }
+    const std::vector<int> valores = generarValores<int>(n);
+
+    arnes.medir(grupoTraspaso, "copia", n, [&](Cronometro& c) {
+        Lista origen;
+        origen.insertarVarios(valores.data(), static_cast<int>(valores.size()));
+        c.iniciar();
+        Lista destino(origen);
+        c.detener();
+        noOptimizar(destino.obtenerCantidad());
+        return std::uint64_t(1);
+    });
+
+    arnes.medir(grupoTraspaso, "movimiento", n, [&](Cronometro& c) {
+        Lista origen;
+        origen.insertarVarios(valores.data(), static_cast<int>(valores.size()));
+        c.iniciar();
+        Lista destino(std::move(origen));
+        c.detener();
+        noOptimizar(destino.obtenerCantidad());
+        return std::uint64_t(1);
+    });
+
+    arnes.medir(grupoEmpalme, "copiar al final", n, [&](Cronometro& c) {
+        Lista destino;
+        Lista origen;
+        destino.insertarVarios(valores.data(), static_cast<int>(valores.size()));
+        origen.insertarVarios(valores.data(), static_cast<int>(valores.size()));
+        c.iniciar();
+        origen.paraCada([&destino](const int& v) { destino.insertar(v); });
+        c.detener();
+        noOptimizar(destino.obtenerCantidad());
+        return std::uint64_t(1);
+    });
+
+    arnes.medir(grupoEmpalme, "empalmar", n, [&](Cronometro& c) {
+        Lista destino;
+        Lista origen;
+        destino.insertarVarios(valores.data(), static_cast<int>(valores.size()));
+        origen.insertarVarios(valores.data(), static_cast<int>(valores.size()));
+        c.iniciar();
+        destino.empalmar(origen);
+        c.detener();
+        noOptimizar(destino.obtenerCantidad());
+        return std::uint64_t(1);
+    });
+}
+
+/** Lecturas de los últimos 5 minutos de un historial con una lectura cada
+ *  100 ms: índice temporal frente a recorrer todo y filtrar por instante
+ */
+template <typename Lista>
+static void medirIntervalo(ArnesMedicion& arnes, const char* nombreLista, Lista& lista, std::uint64_t n) {
+    const std::string grupo = std::string("Intervalo::") + nombreLista;
+    if (!arnes.habilitado(grupo)) {
+        return;
+    }
+    const std::vector<float> valores = generarValores<float>(n);
+    const std::int64_t inicio = 1700000000000LL;
+    for (std::size_t i = 0; i < valores.size(); i++) {
+        lista.insertarEn(valores[i], inicio + 100 * static_cast<std::int64_t>(i));
+    }
+    const std::int64_t hasta = inicio + 100 * static_cast<std::int64_t>(n - 1);
+    const std::int64_t desde = hasta - 5 * 60 * 1000;
+    const std::uint64_t consultas = 10;
+
+    arnes.medir(grupo, "ultimos 5 min (indice)", n, [&](Cronometro& c) {
+        double suma = 0.0;
+        c.iniciar();
+        for (std::uint64_t r = 0; r < consultas; r++) {
+            lista.paraCadaEnIntervalo(desde, hasta, [&suma](const float& v, std::int64_t) {
+                suma += v;
+            });
+        }
+        c.detener();
+        noOptimizar(suma);
+        return consultas;
+    });
+
+    arnes.medir(grupo, "ultimos 5 min (recorrido)", n, [&](Cronometro& c) {
+        double suma = 0.0;
+        c.iniciar();
+        for (std::uint64_t r = 0; r < consultas; r++) {
+            lista.paraCadaConInstante([&](const float& v, std::int64_t instante) {
+                if (instante >= desde && instante <= hasta) {
+                    suma += v;
+                }
+            });
+        }
+        c.detener();
+        noOptimizar(suma);
+        return consultas;
+    });
+}
+
+/** Entregar el conjunto de sensores completo: copia (clonar) o movimiento */
+static void medirTraspasoGestor(ArnesMedicion& arnes, std::uint64_t sensores) {
+    if (!arnes.habilitado("Traspaso::GestorSensores")) {
+        return;
+    }
+    const std::vector<double> valores = generarValores<double>(1000);
+    auto poblar = [&](GestorSensores& gestor) {
+        char nombre[32];
+        for (std::uint64_t s = 0; s < sensores; s++) {
+            std::snprintf(nombre, sizeof(nombre), "S-%06llu", static_cast<unsigned long long>(s));
+            SensorTemperatura* sensor = gestor.emplazarSensor<SensorTemperatura>(nombre);
+            sensor->registrarLecturas(valores.data(), valores.size());
+        }
+    };
+    arnes.medir("Traspaso::GestorSensores", "copia", sensores, [&](Cronometro& c) {
+        GestorSensores origen;
+        poblar(origen);
+        c.iniciar();
+        GestorSensores destino(origen);
+        c.detener();
+        noOptimizar(destino.obtenerCantidad());
+        return std::uint64_t(1);
+    });
+    arnes.medir("Traspaso::GestorSensores", "movimiento", sensores, [&](Cronometro& c) {
+        GestorSensores origen;
+        poblar(origen);
+        c.iniciar();
+        GestorSensores destino(std::move(origen));
+        c.detener();
+        noOptimizar(destino.obtenerCantidad());
+        return std::uint64_t(1);
+    });
+}
+
+/** Una llamada virtual por lectura frente a lotes de `lote` lecturas */
+template <typename Sensor>
+static void medirRegistro(ArnesMedicion& arnes, const char* grupo, std::uint64_t lote) {
+    if (!arnes.habilitado(grupo)) {
+        return;
+    }
+    const std::uint64_t n = 1000000;
+    const std::vector<double> valores = generarValores<double>(n);
+    const std::string tipo = (lote == 1) ? std::string("por lectura") : "lote " + std::to_string(lote);
+    arnes.medir(grupo, tipo, n, [&](Cronometro& c) {
+        SensorBase* sensor = new Sensor("BENCH", static_cast<std::size_t>(n));
+        c.iniciar();
+        if (lote == 1) {
+            for (std::size_t i = 0; i < valores.size(); i++) {
+                sensor->registrarLectura(valores[i]);
+            }
+        } else {
+            for (std::size_t i = 0; i < valores.size(); i += lote) {
+                std::size_t m = (valores.size() - i < lote) ? valores.size() - i : lote;
+                sensor->registrarLecturas(valores.data() + i, m);
+            }
+        }
+        c.detener();
+        delete sensor;
+        return n;
+    });
+}
+
+static void medirGestor(ArnesMedicion& arnes, std::uint64_t sensores) {
+    if (!arnes.habilitado("GestorSensores::buscarSensor")) {
+        return;
+    }
+    GestorSensores gestor;
+    std::vector<std::string> nombres;
+    char nombre[32];
+    for (std::uint64_t s = 0; s < sensores; s++) {
+        std::snprintf(nombre, sizeof(nombre), "S-%06llu", static_cast<unsigned long long>(s));
+        gestor.agregarSensor(new SensorTemperatura(nombre));
+        nombres.push_back(nombre);
+    }
+    // Orden de consulta distinto del de inserción
+    std::vector<std::size_t> orden(1 << 16);
+    std::uint32_t x = 12345u;
+    for (std::size_t i = 0; i < orden.size(); i++) {
+        x = x * 1664525u + 1013904223u;
+        orden[i] = (x >> 8) % sensores;
+    }
+
+    const std::uint64_t consultas = 1000000;
+    arnes.medir("GestorSensores::buscarSensor", "nombre", sensores, [&](Cronometro& c) {
+        SensorBase* ultimo = nullptr;
+        c.iniciar();
+        for (std::uint64_t i = 0; i < consultas; i++) {
+            ultimo = gestor.buscarSensor(nombres[orden[i & (orden.size() - 1)]]);
+            noOptimizar(ultimo);
+        }
+        c.detener();
+        return consultas;
+    });
+}
+
+static void medirParser(ArnesMedicion& arnes, const std::string& rutaCaptura) {
+    if (!arnes.habilitado("ParserLecturas::interpretar")) {
+        return;
+    }
+    std::string captura;
+    std::ifstream archivo(rutaCaptura, std::ios::binary);
+    if (archivo) {
+        std::stringstream contenido;
+        contenido << archivo.rdbuf();
+        captura = contenido.str();
+    } else {
+        // Sin captura: líneas sintéticas con el mismo formato
+        std::fprintf(stderr, "[Aviso] Sin captura en %s; se usan líneas sintéticas.\n", rutaCaptura.c_str());
+        char linea[32];
+        for (int i = 0; i < 1000; i++) {
+            std::snprintf(linea, sizeof(linea), (i % 2) ? "PRES:%d\n" : "TEMP:%d.%02d\n", 90 + i % 20, i % 100);
+            captura += linea;
+        }
+    }
+
+    std::string flujo;
+    while (flujo.size() < 8u * 1024 * 1024) {
+        flujo += captura;
+    }
+    arnes.medir("ParserLecturas::interpretar", "linea", flujo.size(), [&](Cronometro& c) {
+        ParserLecturas parser;
+        double suma = 0.0;
+        c.iniciar();
+        parser.interpretar(flujo.data(), flujo.size(), [&suma](const LecturaCruda& l) {
+            suma += l.valor;
+        });
+        c.detener();
+        noOptimizar(suma);
+        return static_cast<std::uint64_t>(parser.obtenerLineasValidas() + parser.obtenerLineasInvalidas());
+    });
+}
+
+int main(int argc, char* argv[]) {
+    ArnesMedicion arnes;
+    arnes.configurar(argc, argv);
+
+    std::uint64_t maximo = 10000000;
+    std::string captura = SISTEMAIOT_DIR_DATOS "/captura_sensor_ino.txt";
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--max=", 6) == 0) {
+            maximo = std::strtoull(argv[i] + 6, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--captura=", 10) == 0) {
+            captura = argv[i] + 10;
+        }
+    }
+
+    for (std::uint64_t n = 1000; n <= maximo; n *= 10) {
+        medirLista<int>(arnes, "int", n);
+        medirLista<float>(arnes, "float", n);
+        medirLista<double>(arnes, "double", n);
+    }
+    for (std::uint64_t sensores = 10; sensores <= 100000; sensores *= 10) {
+        medirGestor(arnes, sensores);
+    }
+    medirParser(arnes, captura);
+    for (std::uint64_t n = 1000; n <= maximo && n <= 1000000; n *= 10) {
+        medirTraspaso<ListaSensor<int> >(arnes, "ListaSensor", n);
+        medirTraspaso<ListaSensor<int, AsignadorNew<int> > >(arnes, "ListaSensor<New>", n);
+        medirTraspaso<ListaSensorBloques<int> >(arnes, "ListaSensorBloques", n);
+    }
+    for (std::uint64_t n = 10000; n <= maximo && n <= 1000000; n *= 10) {
+        ListaSensor<float> lista;
+        medirIntervalo(arnes, "ListaSensor", lista, n);
+        ListaSensorBloques<float> bloques;
+        medirIntervalo(arnes, "ListaSensorBloques", bloques, n);
+        ListaSensorCircular<float> circular(static_cast<std::size_t>(n));
+        medirIntervalo(arnes, "ListaSensorCircular", circular, n);
+    }
+    medirTraspasoGestor(arnes, 100);
+    medirTraspasoGestor(arnes, 1000);
+    for (std::uint64_t lote = 1; lote <= 256; lote *= 16) {
+        medirRegistro<SensorTemperaturaCircular>(arnes, "SensorTemperatura::registrarLecturas", lote);
+        medirRegistro<SensorPresionCircular>(arnes, "SensorPresion::registrarLecturas", lote);
+    }
+
+    arnes.emitir("bench_sensores");
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "GeneradorCarga.hpp"
+
+// Reemplazo del ESP32 para pruebas: crea pseudo-terminales y emite lecturas
+// ID:valor por ellas. La ruta impresa se usa en la opción 4 de SistemaIoT
+// (o en ServicioMultipuerto) como si fuera el puerto serie.
+// Uso: generador_carga [--puertos=N] [--sensores=N] [--tasa=lineas/s por puerto, 0 = saturar]
+//                      [--malformadas=fraccion] [--rafaga=lineas] [--periodo-rafaga=ms]
+//                      [--lineas=por puerto] [--segundos=N] [--sonda=cada N] [--semilla=N]
+
+using std::cout;
+using std::endl;
+
+static volatile std::sig_atomic_t interrumpido = 0;
+
+static void alInterrumpir(int) {
+    interrumpido = 1;
+}
+
+/** Lee --nombre=valor; retorna nullptr si el argumento es otro */
+static const char* opcion(const char* argumento, const char* nombre) {
+    std::size_t n = std::strlen(nombre);
+    return (std::strncmp(argumento, nombre, n) == 0 && argumento[n] == '=') ? argumento + n + 1 : nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    ConfiguracionCarga config;
+    double segundos = 0.0;
+    for (int i = 1; i < argc; i++) {
+        const char* v;
+        if ((v = opcion(argv[i], "--puertos"))) config.puertos = std::atoi(v);
+        else if ((v = opcion(argv[i], "--sensores"))) config.sensoresPorPuerto = std::atoi(v);
+        else if ((v = opcion(argv[i], "--tasa"))) config.lineasPorSegundo = std::atof(v);
+        else if ((v = opcion(argv[i], "--malformadas"))) config.fraccionMalformadas = std::atof(v);
+        else if ((v = opcion(argv[i], "--rafaga"))) config.lineasPorRafaga = static_cast<std::uint32_t>(std::atol(v));
+        else if ((v = opcion(argv[i], "--periodo-rafaga"))) config.periodoRafagaMs = static_cast<std::uint32_t>(std::atol(v));
+        else if ((v = opcion(argv[i], "--lineas"))) config.lineasPorPuerto = std::strtoull(v, nullptr, 10);
+        else if ((v = opcion(argv[i], "--segundos"))) segundos = std::atof(v);
+        else if ((v = opcion(argv[i], "--sonda"))) config.sondaCada = static_cast<std::uint32_t>(std::atol(v));
+        else if ((v = opcion(argv[i], "--semilla"))) config.semilla = static_cast<std::uint32_t>(std::atol(v));
+        else {
+            std::cerr << "[Error] Opción desconocida: " << argv[i] << endl;
+            return 2;
+        }
+    }
+
+    GeneradorCarga generador(config);
+    if (!generador.crearPuertos()) {
+        return 1;
+    }
+    for (int p = 0; p < generador.obtenerCantidadPuertos(); p++) {
+        cout << "Puerto " << p << ": " << generador.obtenerRutaPuerto(p) << "  sensores:";
+        for (int s = 0; s < config.sensoresPorPuerto; s++) {
+            cout << ' ' << GeneradorCarga::nombreSensor(p, s);
+        }
+        cout << endl;
+    }
+
+    std::signal(SIGINT, alInterrumpir);
+    std::signal(SIGTERM, alInterrumpir);
+    auto inicio = std::chrono::steady_clock::now();
+    generador.iniciar();
+
+    // Un reporte por segundo hasta Ctrl+C, --segundos o --lineas
+    std::uint64_t anteriores = 0;
+    const std::uint64_t total = config.lineasPorPuerto * static_cast<std::uint64_t>(config.puertos);
+    while (!interrumpido) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::uint64_t enviadas = generador.obtenerLineasEnviadas();
+        double transcurrido = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        cout << "[Generador] " << transcurrido << " s: " << enviadas << " línea(s) ("
+             << (enviadas - anteriores) << "/s), " << generador.obtenerMalformadasEnviadas()
+             << " malformada(s), " << generador.obtenerRafagas() << " ráfaga(s)" << endl;
+        anteriores = enviadas;
+        if ((segundos > 0.0 && transcurrido >= segundos) || (total > 0 && enviadas >= total)) {
+            break;
+        }
+    }
+    generador.detener();
+    cout << "[Generador] Total: " << generador.obtenerLineasEnviadas() << " línea(s), "
+         << generador.obtenerBytesEnviados() << " byte(s)." << endl;
+    return 0;
+}
@@ -0,0 +1,394 @@
+#ifndef AGREGADOS_TEMPORALES_HPP
+#define AGREGADOS_TEMPORALES_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+    #include <time.h>
+#endif
+
+/// Un nivel de agregación: ancho de cubeta y cuántas cubetas se conservan
+struct NivelAgregacion {
+    std::int64_t anchoMs;      ///< Duración de cada cubeta en milisegundos
+    std::size_t capacidad;     ///< Cubetas retenidas (las más recientes)
+};
+
+/// Cantidad, suma, mínimo y máximo de un conjunto de lecturas
+struct ResumenRango {
+    std::uint64_t cantidad;
+    double suma;
+    double minimo;
+    double maximo;
+    std::int64_t desdeMs;   ///< Intervalo que de verdad resume [desdeMs, hastaMs):
+    std::int64_t hastaMs;   ///< más ancho que el pedido si un borde ya sólo estaba en una cubeta gruesa
+
+    ResumenRango()
+        : cantidad(0), suma(0.0),
+          minimo(std::numeric_limits<double>::infinity()),
+          maximo(-std::numeric_limits<double>::infinity()),
+          desdeMs(0), hastaMs(0) {}
+
+    void combinar(std::uint64_t n, double s, double mn, double mx) {
+        cantidad += n;
+        suma += s;
+        if (mn < minimo) minimo = mn;
+        if (mx > maximo) maximo = mx;
+    }
+
+    /** Extiende el intervalo cubierto para incluir [desde, hasta) */
+    void ampliar(std::int64_t desde, std::int64_t hasta) {
+        if (desde < desdeMs) desdeMs = desde;
+        if (hasta > hastaMs) hastaMs = hasta;
+    }
+
+    bool estaVacio() const {
+        return cantidad == 0;
+    }
+
+    double promedio() const {
+        if (cantidad == 0) {
+            throw std::runtime_error("Rango sin lecturas");
+        }
+        return suma / static_cast<double>(cantidad);
+    }
+};
+
+/**
+ * Resúmenes de un sensor a varias resoluciones (1 s, 1 min, 1 h por
+ * omisión), actualizados en cada lectura.
+ *
+ * Cada nivel es un anillo ordenado de cubetas {clave, cantidad, suma,
+ * mín, máx}; registrar() sólo toca la cubeta más reciente de cada nivel,
+ * así que cuesta O(niveles). Las cubetas se crean cuando llegan datos y
+ * el anillo crece hasta su capacidad, de modo que un sensor poco activo
+ * ocupa poco. Con los niveles predeterminados el máximo por sensor es
+ * de ~3000 cubetas (~120 KiB): 10 min por segundo, 1 día por minuto y
+ * 6 semanas por hora.
+ *
+ * consultar() responde un rango con las cubetas más gruesas que caben
+ * completas y baja a los niveles finos sólo para los bordes; nunca lee
+ * las lecturas originales. Si el nivel fino ya descartó un borde (rango
+ * más antiguo que su anillo), ese borde se responde con la cubeta gruesa
+ * entera y ResumenRango::desdeMs/hastaMs informan el intervalo ampliado. Se usa el reloj del sistema para que las
+ * cubetas coincidan con minutos y horas del calendario.
+ */
+class AgregadosTemporales {
+public:
+    typedef std::chrono::system_clock Reloj;
+
+    static const int MAX_NIVELES = 4;
+
+    AgregadosTemporales() : cantidadNiveles(0) {
+        static const NivelAgregacion predeterminados[] = {
+            { 1000, 600 },           // 1 s durante 10 min
+            { 60 * 1000, 1440 },     // 1 min durante 1 día
+            { 3600 * 1000, 1008 }    // 1 h durante 6 semanas
+        };
+        configurar(predeterminados, 3);
+    }
+
+    /** niveles debe ir de la resolución más fina a la más gruesa y cada
+     *  ancho debe ser múltiplo del anterior
+     */
+    AgregadosTemporales(const NivelAgregacion* niveles, int n) : cantidadNiveles(0) {
+        configurar(niveles, n);
+    }
+
+    /** Registra una lectura con la hora actual */
+    void registrar(double valor) {
+        registrarEn(valor, ahoraMilisegundos());
+    }
+
+    void registrar(double valor, Reloj::time_point instante) {
+        registrarEn(valor, aMilisegundos(instante));
+    }
+
+    /** Registra una lectura con su instante en ms desde la época del reloj */
+    void registrarEn(double valor, std::int64_t ms) {
+        for (int i = 0; i < cantidadNiveles; i++) {
+            niveles[i].registrar(valor, ms);
+        }
+    }
+
+    /** Registra n lecturas del mismo instante: se resumen en una pasada
+     *  y cada nivel recibe el resumen una sola vez
+     */
+    template <typename T>
+    void registrarVariosEn(const T* valores, std::size_t n, std::int64_t ms) {
+        if (n == 0) {
+            return;
+        }
+        double suma = 0.0;
+        double minimo = static_cast<double>(valores[0]);
+        double maximo = minimo;
+        for (std::size_t i = 0; i < n; i++) {
+            double v = static_cast<double>(valores[i]);
+            suma += v;
+            minimo = (v < minimo) ? v : minimo;
+            maximo = (v > maximo) ? v : maximo;
+        }
+        for (int i = 0; i < cantidadNiveles; i++) {
+            niveles[i].registrarResumen(static_cast<std::uint32_t>(n), suma, minimo, maximo, ms);
+        }
+    }
+
+    /**
+     * Hora actual en milisegundos. En Linux se usa el reloj "coarse" del
+     * kernel (resolución de unos pocos ms, sin leer el contador de ciclos):
+     * basta para cubetas de 1 s y cuesta una fracción de Reloj::now().
+     */
+    static std::int64_t ahoraMilisegundos() {
+        #ifdef __linux__
+            timespec ts;
+            if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+                return static_cast<std::int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+            }
+        #endif
+        return aMilisegundos(Reloj::now());
+    }
+
+    /** Agregado de las lecturas de [desde, hasta), con la precisión del
+     *  nivel más fino que aún conserva cada borde
+     */
+    ResumenRango consultar(Reloj::time_point desde, Reloj::time_point hasta) const {
+        ResumenRango resumen;
+        std::int64_t a = aMilisegundos(desde);
+        std::int64_t b = aMilisegundos(hasta);
+        resumen.desdeMs = a;
+        resumen.hastaMs = b;
+        if (a < b && cantidadNiveles > 0) {
+            acumular(cantidadNiveles - 1, a, b, resumen);
+        }
+        return resumen;
+    }
+
+    /** Agregado de las lecturas de los últimos `duracion` */
+    ResumenRango consultarUltimos(Reloj::duration duracion) const {
+        Reloj::time_point ahora = Reloj::now();
+        // El borde final incluye la cubeta en curso
+        return consultar(ahora - duracion, ahora + std::chrono::milliseconds(niveles[0].ancho));
+    }
+
+    int obtenerCantidadNiveles() const {
+        return cantidadNiveles;
+    }
+
+    /** Cubetas que ocupa hoy un nivel (crece hasta su capacidad) */
+    std::size_t obtenerCubetas(int nivel) const {
+        return niveles[nivel].cubetas.size();
+    }
+
+    std::int64_t obtenerAnchoMs(int nivel) const {
+        return niveles[nivel].ancho;
+    }
+
+    /**
+     * Llama funcion(nivel, clave, cantidad, suma, minimo, maximo) por cada
+     * cubeta, nivel por nivel y de la más antigua a la más reciente. La
+     * clave es el inicio de la cubeta dividido por el ancho del nivel.
+     */
+    template <typename Funcion>
+    void paraCadaCubeta(Funcion funcion) const {
+        for (int i = 0; i < cantidadNiveles; i++) {
+            const Nivel& n = niveles[i];
+            for (std::size_t k = 0; k < n.cubetas.size(); k++) {
+                const Cubeta& c = n.en(k);
+                funcion(i, c.clave, c.cantidad, c.suma, c.minimo, c.maximo);
+            }
+        }
+    }
+
+    /**
+     * Repone una cubeta exportada con paraCadaCubeta(). Deben llegar en el
+     * mismo orden; una cubeta que no es posterior a la última del nivel,
+     * o de un nivel que no existe, se ignora y retorna false.
+     */
+    bool restaurarCubeta(int nivel, std::int64_t clave, std::uint32_t cantidad,
+                         double suma, double minimo, double maximo) {
+        if (nivel < 0 || nivel >= cantidadNiveles || cantidad == 0) {
+            return false;
+        }
+        Nivel& n = niveles[nivel];
+        if (!n.cubetas.empty() && clave <= n.ultima().clave) {
+            return false;
+        }
+        Cubeta c = { clave, cantidad, suma, minimo, maximo };
+        n.anexar(c);
+        return true;
+    }
+
+private:
+    struct Cubeta {
+        std::int64_t clave;        ///< Inicio de la cubeta / ancho
+        std::uint32_t cantidad;
+        double suma;
+        double minimo;
+        double maximo;
+    };
+
+    struct Nivel {
+        std::int64_t ancho;
+        std::size_t capacidad;
+        std::vector<Cubeta> cubetas;   ///< Anillo ordenado por clave
+        std::size_t inicio;            ///< Posición de la cubeta más antigua
+
+        Nivel() : ancho(1), capacidad(1), inicio(0) {}
+
+        const Cubeta& en(std::size_t i) const {
+            std::size_t p = inicio + i;
+            return cubetas[p >= cubetas.size() ? p - cubetas.size() : p];
+        }
+
+        Cubeta& ultima() {
+            return cubetas[inicio == 0 ? cubetas.size() - 1 : inicio - 1];
+        }
+
+        void registrar(double valor, std::int64_t ms) {
+            std::int64_t clave = dividirHaciaAbajo(ms, ancho);
+            if (!cubetas.empty()) {
+                Cubeta& actual = ultima();
+                // Una lectura atrasada (p. ej. ajuste del reloj) se suma
+                // a la cubeta más reciente en vez de perderse
+                if (clave <= actual.clave) {
+                    actual.cantidad++;
+                    actual.suma += valor;
+                    if (valor < actual.minimo) actual.minimo = valor;
+                    if (valor > actual.maximo) actual.maximo = valor;
+                    return;
+                }
+            }
+            Cubeta nueva = { clave, 1, valor, valor, valor };
+            anexar(nueva);
+        }
+
+        /** Como registrar(), con n lecturas ya resumidas */
+        void registrarResumen(std::uint32_t n, double suma, double minimo, double maximo, std::int64_t ms) {
+            std::int64_t clave = dividirHaciaAbajo(ms, ancho);
+            if (!cubetas.empty()) {
+                Cubeta& actual = ultima();
+                if (clave <= actual.clave) {
+                    actual.cantidad += n;
+                    actual.suma += suma;
+                    if (minimo < actual.minimo) actual.minimo = minimo;
+                    if (maximo > actual.maximo) actual.maximo = maximo;
+                    return;
+                }
+            }
+            Cubeta nueva = { clave, n, suma, minimo, maximo };
+            anexar(nueva);
+        }
+
+        /** Agrega al final; con el anillo lleno reemplaza a la más antigua */
+        void anexar(const Cubeta& nueva) {
+            if (cubetas.size() < capacidad) {
+                cubetas.push_back(nueva);
+            } else {
+                cubetas[inicio] = nueva;
+                inicio = (inicio + 1 == cubetas.size()) ? 0 : inicio + 1;
+            }
+        }
+
+        /** true si no descartó ninguna cubeta que empiece en ms o después
+         *  (el anillo aún no se llenó o su cubeta más antigua no es posterior)
+         */
+        bool conservaDesde(std::int64_t ms) const {
+            return cubetas.size() < capacidad || en(0).clave * ancho <= ms;
+        }
+
+        /** Suma las cubetas con clave en [desde, hasta) */
+        void acumular(std::int64_t desde, std::int64_t hasta, ResumenRango& resumen) const {
+            std::size_t bajo = 0;
+            std::size_t alto = cubetas.size();
+            while (bajo < alto) {
+                std::size_t medio = bajo + (alto - bajo) / 2;
+                if (en(medio).clave < desde) bajo = medio + 1; else alto = medio;
+            }
+            for (std::size_t i = bajo; i < cubetas.size() && en(i).clave < hasta; i++) {
+                const Cubeta& c = en(i);
+                resumen.combinar(c.cantidad, c.suma, c.minimo, c.maximo);
+            }
+        }
+    };
+
+    static std::int64_t aMilisegundos(Reloj::time_point instante) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(instante.time_since_epoch()).count();
+    }
+
+    static std::int64_t dividirHaciaAbajo(std::int64_t a, std::int64_t b) {
+        std::int64_t q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+
+    static std::int64_t dividirHaciaArriba(std::int64_t a, std::int64_t b) {
+        return -dividirHaciaAbajo(-a, b);
+    }
+
+    void configurar(const NivelAgregacion* definicion, int n) {
+        if (definicion == nullptr || n < 1 || n > MAX_NIVELES) {
+            throw std::invalid_argument("Cantidad de niveles de agregación no válida");
+        }
+        for (int i = 0; i < n; i++) {
+            if (definicion[i].anchoMs <= 0 || definicion[i].capacidad == 0 ||
+                (i > 0 && definicion[i].anchoMs % definicion[i - 1].anchoMs != 0)) {
+                throw std::invalid_argument("Nivel de agregación no válido");
+            }
+            niveles[i].ancho = definicion[i].anchoMs;
+            niveles[i].capacidad = definicion[i].capacidad;
+        }
+        cantidadNiveles = n;
+    }
+
+    /**
+     * Cubre [a, b) con las cubetas completas del nivel indicado y delega
+     * los bordes al nivel inmediato más fino. En el nivel más fino entra
+     * toda cubeta que empiece dentro del rango.
+     */
+    void acumular(int nivel, std::int64_t a, std::int64_t b, ResumenRango& resumen) const {
+        const Nivel& n = niveles[nivel];
+        if (nivel == 0) {
+            n.acumular(dividirHaciaArriba(a, n.ancho), dividirHaciaArriba(b, n.ancho), resumen);
+            return;
+        }
+        std::int64_t primera = dividirHaciaArriba(a, n.ancho);
+        std::int64_t ultima = dividirHaciaAbajo(b, n.ancho);
+        if (primera >= ultima) {
+            acumularBorde(nivel, a, b, resumen);
+            return;
+        }
+        if (a < primera * n.ancho) {
+            acumularBorde(nivel, a, primera * n.ancho, resumen);
+        }
+        n.acumular(primera, ultima, resumen);
+        if (ultima * n.ancho < b) {
+            acumularBorde(nivel, ultima * n.ancho, b, resumen);
+        }
+    }
+
+    /**
+     * Un borde [a, b) sin cubetas completas del nivel. Lo resuelve el
+     * nivel más fino si aún lo conserva; si no, sumar lo que le queda
+     * daría un total parcial, así que entran las cubetas del nivel que
+     * lo contienen y el intervalo informado se amplía a ellas.
+     */
+    void acumularBorde(int nivel, std::int64_t a, std::int64_t b, ResumenRango& resumen) const {
+        if (niveles[nivel - 1].conservaDesde(a)) {
+            acumular(nivel - 1, a, b, resumen);
+            return;
+        }
+        const Nivel& n = niveles[nivel];
+        std::int64_t desde = dividirHaciaAbajo(a, n.ancho);
+        std::int64_t hasta = dividirHaciaArriba(b, n.ancho);
+        n.acumular(desde, hasta, resumen);
+        resumen.ampliar(desde * n.ancho, hasta * n.ancho);
+    }
+
+    Nivel niveles[MAX_NIVELES];
+    int cantidadNiveles;
+};
+
+#endif // AGREGADOS_TEMPORALES_HPP
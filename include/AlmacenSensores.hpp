@@ -0,0 +1,260 @@
+#ifndef ALMACEN_SENSORES_HPP
+#define ALMACEN_SENSORES_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "SensorBase.hpp"
+#include "SensorTemperatura.hpp"
+#include "SensorPresion.hpp"
+#include "AgregadosTemporales.hpp"
+#include "Bitacora.hpp"
+#include "InternadorNombres.hpp"
+
+/// Posición de S en la lista de tipos (error de compilación si no está)
+template <typename S, typename... Lista>
+struct IndiceTipoSensor;
+
+template <typename S, typename... Resto>
+struct IndiceTipoSensor<S, S, Resto...> {
+    static const std::uint32_t valor = 0;
+};
+
+template <typename S, typename Otro, typename... Resto>
+struct IndiceTipoSensor<S, Otro, Resto...> {
+    static const std::uint32_t valor = 1 + IndiceTipoSensor<S, Resto...>::valor;
+};
+
+/**
+ * Almacén de sensores segregado por tipo, con despacho estático.
+ *
+ * GestorSensores enlaza SensorBase* sueltos en el heap: cada pasada sigue
+ * un puntero y hace una llamada virtual por sensor, con temperaturas y
+ * presiones intercaladas. Aquí cada tipo concreto de Sensores... vive por
+ * valor en su propio std::vector y los recorridos avanzan tipo por tipo
+ * con una llamada calificada (s.S::procesarLectura), que no pasa por la
+ * tabla virtual y el compilador puede expandir en línea.
+ *
+ * Los sensores siguen derivando de SensorBase: buscarSensor y sensorPorId
+ * devuelven la interfaz polimórfica para el código que no conoce el tipo.
+ * Esos punteros se invalidan al emplazar otro sensor del mismo tipo (el
+ * vector crece); los identificadores no. Con reservar<S>() se evita que
+ * el arreglo se realoje durante la carga inicial.
+ *
+ * procesarTodos emite tipo por tipo (todas las temperaturas, luego las
+ * presiones), no en el orden de alta global de GestorSensores.
+ */
+template <typename... Sensores>
+class AlmacenSensoresGen {
+    static_assert(sizeof...(Sensores) > 0, "El almacén necesita al menos un tipo de sensor");
+
+public:
+    AlmacenSensoresGen() {}
+
+    AlmacenSensoresGen(const AlmacenSensoresGen&) = delete;
+    AlmacenSensoresGen& operator=(const AlmacenSensoresGen&) = delete;
+
+    /** Construye un sensor S en su arreglo. Los argumentos adicionales van
+     *  al constructor del sensor (p. ej. capacidad del historial circular).
+     *  Retorna su identificador, o -1 si el nombre ya existía.
+     */
+    template <typename S, typename... Args>
+    std::int32_t emplazar(const char* nombre, Args&&... args) {
+        // SensorBase conserva a lo sumo 49 caracteres del nombre
+        std::string_view clave(nombre);
+        clave = clave.substr(0, LARGO_NOMBRE);
+        if (ids.buscar(clave) != InternadorNombres::NO_ENCONTRADO) {
+            BitacoraPredeterminada::registrar([&](auto& os) {
+                os << "[Error] Sensor '" << clave << "' repetido; no se agrega al almacén.";
+            });
+            return -1;
+        }
+        std::vector<S>& arreglo = arregloDe<S>();
+        arreglo.emplace_back(nombre, std::forward<Args>(args)...);
+        Ubicacion ubicacion;
+        ubicacion.tipo = IndiceTipoSensor<S, Sensores...>::valor;
+        ubicacion.indice = static_cast<std::uint32_t>(arreglo.size() - 1);
+        ubicaciones.push_back(ubicacion);
+        std::uint32_t id = ids.internar(clave);
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Sensor '" << clave << "' emplazado en el almacén por tipo.";
+        });
+        return static_cast<std::int32_t>(id);
+    }
+
+    /** Reserva espacio para n sensores de tipo S */
+    template <typename S>
+    void reservar(std::size_t n) {
+        arregloDe<S>().reserve(n);
+    }
+
+    /** Busca por nombre en O(1) esperado; nullptr si no existe */
+    SensorBase* buscarSensor(std::string_view nombre) {
+        std::int32_t id = ids.buscar(nombre);
+        return (id == InternadorNombres::NO_ENCONTRADO) ? nullptr
+                                                        : sensorPorId(static_cast<std::uint32_t>(id));
+    }
+
+    /** Identificador compacto del sensor, o -1 si no existe */
+    std::int32_t obtenerIdSensor(std::string_view nombre) const {
+        return ids.buscar(nombre);
+    }
+
+    SensorBase* sensorPorId(std::uint32_t id) {
+        SensorBase* sensor = nullptr;
+        if (id < ubicaciones.size()) {
+            visitar(ubicaciones[id], [&sensor](SensorBase& s) { sensor = &s; });
+        }
+        return sensor;
+    }
+
+    /** Registra una lectura en el sensor del identificador sin llamada
+     *  virtual. Retorna false si el id no existe.
+     */
+    bool registrarLectura(std::uint32_t id, double valor) {
+        if (id >= ubicaciones.size()) {
+            return false;
+        }
+        std::int64_t instante = AgregadosTemporales::ahoraMilisegundos();
+        visitar(ubicaciones[id], [&](auto& sensor) {
+            registrarEstatico(sensor, valor, instante);
+        });
+        return true;
+    }
+
+    /** Registra n lecturas del mismo sensor en una llamada estática */
+    bool registrarLecturas(std::uint32_t id, const double* valores, std::size_t n) {
+        if (id >= ubicaciones.size()) {
+            return false;
+        }
+        std::int64_t instante = AgregadosTemporales::ahoraMilisegundos();
+        visitar(ubicaciones[id], [&](auto& sensor) {
+            registrarLoteEstatico(sensor, valores, n, instante);
+        });
+        return true;
+    }
+
+    /** Procesa todos los sensores, un arreglo homogéneo tras otro */
+    void procesarTodos(std::ostream& salida = std::cout) {
+        if (ubicaciones.empty()) {
+            salida << "[Advertencia] No hay sensores registrados." << std::endl;
+            return;
+        }
+
+        salida << "\n--- Procesando por tipo ---" << std::endl;
+
+        RedireccionBitacora redireccion(salida);
+        paraCada([&salida](auto& sensor) {
+            procesarEstatico(sensor, salida);
+        });
+    }
+
+    /** Llama funcion(S&) por cada sensor de tipo S, en orden de alta */
+    template <typename S, typename Funcion>
+    void paraCadaDe(Funcion funcion) {
+        for (S& sensor : arregloDe<S>()) {
+            funcion(sensor);
+        }
+    }
+
+    template <typename S, typename Funcion>
+    void paraCadaDe(Funcion funcion) const {
+        for (const S& sensor : arregloDe<S>()) {
+            funcion(sensor);
+        }
+    }
+
+    /** Llama funcion con el tipo concreto de cada sensor (lambda genérica),
+     *  recorriendo los tipos en el orden de Sensores...
+     */
+    template <typename Funcion>
+    void paraCada(Funcion funcion) {
+        (paraCadaDe<Sensores>(funcion), ...);
+    }
+
+    template <typename Funcion>
+    void paraCada(Funcion funcion) const {
+        (paraCadaDe<Sensores>(funcion), ...);
+    }
+
+    template <typename S>
+    std::size_t cantidadDe() const {
+        return arregloDe<S>().size();
+    }
+
+    int obtenerCantidad() const {
+        return static_cast<int>(ubicaciones.size());
+    }
+
+    bool estaVacio() const {
+        return ubicaciones.empty();
+    }
+
+private:
+    static const std::size_t LARGO_NOMBRE = 49;
+
+    /// Tipo (posición en Sensores...) e índice dentro de su arreglo
+    struct Ubicacion {
+        std::uint32_t tipo;
+        std::uint32_t indice;
+    };
+
+    template <typename S>
+    std::vector<S>& arregloDe() {
+        return std::get<IndiceTipoSensor<S, Sensores...>::valor>(arreglos);
+    }
+
+    template <typename S>
+    const std::vector<S>& arregloDe() const {
+        return std::get<IndiceTipoSensor<S, Sensores...>::valor>(arreglos);
+    }
+
+    // Llamadas calificadas: resueltas en compilación, sin tabla virtual
+
+    template <typename S>
+    static void procesarEstatico(S& sensor, std::ostream& salida) {
+        sensor.S::procesarLectura(salida);
+    }
+
+    template <typename S>
+    static void registrarEstatico(S& sensor, double valor, std::int64_t instanteMs) {
+        sensor.S::registrarLecturaEn(valor, instanteMs);
+    }
+
+    template <typename S>
+    static void registrarLoteEstatico(S& sensor, const double* valores, std::size_t n, std::int64_t instanteMs) {
+        sensor.S::registrarLecturasEn(valores, n, instanteMs);
+    }
+
+    /** Llama funcion con el sensor concreto de la ubicación */
+    template <typename Funcion>
+    void visitar(const Ubicacion& ubicacion, Funcion&& funcion) {
+        visitarDesde<0>(ubicacion, funcion);
+    }
+
+    template <std::size_t I, typename Funcion>
+    void visitarDesde(const Ubicacion& ubicacion, Funcion& funcion) {
+        if constexpr (I < sizeof...(Sensores)) {
+            if (ubicacion.tipo == I) {
+                funcion(std::get<I>(arreglos)[ubicacion.indice]);
+            } else {
+                visitarDesde<I + 1>(ubicacion, funcion);
+            }
+        }
+    }
+
+    std::tuple<std::vector<Sensores>...> arreglos;  ///< Un arreglo contiguo por tipo
+    std::vector<Ubicacion> ubicaciones;             ///< Identificador -> (tipo, índice)
+    InternadorNombres ids;                          ///< Nombre -> identificador
+};
+
+/// Los tipos predeterminados (historial en lista enlazada)
+typedef AlmacenSensoresGen<SensorTemperatura, SensorPresion> AlmacenSensores;
+
+/// Historiales acotados: memoria fija por sensor
+typedef AlmacenSensoresGen<SensorTemperaturaCircular, SensorPresionCircular> AlmacenSensoresCircular;
+
+#endif // ALMACEN_SENSORES_HPP
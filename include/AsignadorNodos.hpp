@@ -0,0 +1,364 @@
+#ifndef ASIGNADOR_NODOS_HPP
+#define ASIGNADOR_NODOS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * Nodo enlazado por puntero. Los nodos están alineados al menos a 2
+ * bytes, así que el bit bajo del enlace queda libre y guarda la marca de
+ * borrado diferido sin agrandar el nodo. La marca de tiempo va junto al
+ * dato, antes del enlace: con float/int ocupa el relleno y el nodo sigue
+ * en 16 bytes; con double el nodo pasa de 16 a 24.
+ */
+template <typename T>
+struct Nodo {
+    static const std::uintptr_t MARCA_ELIMINADO = 1;
+
+    T dato;
+    std::int32_t marca;         ///< Delta-de-delta del instante (MarcasTiempo.hpp)
+    std::uintptr_t siguiente;   ///< Dirección del siguiente | MARCA_ELIMINADO
+
+    /**
+param valor Valor a almacenar en el nodo
+     */
+    Nodo(const T& valor) : dato(valor), marca(0), siguiente(0) {}
+
+    /** Construye el nodo moviendo el valor (evita copias de T costosos) */
+    Nodo(T&& valor) : dato(std::move(valor)), marca(0), siguiente(0) {}
+
+    /** Construye el dato en su lugar con los argumentos de su constructor */
+    template <typename... Args>
+    Nodo(std::in_place_t, Args&&... args)
+        : dato(std::forward<Args>(args)...), marca(0), siguiente(0) {}
+
+    /** Siguiente nodo, sin la marca */
+    Nodo<T>* obtenerSiguiente() const {
+        return reinterpret_cast<Nodo<T>*>(siguiente & ~MARCA_ELIMINADO);
+    }
+
+    /** Cambia el enlace conservando la marca de borrado */
+    void fijarSiguiente(Nodo<T>* sig) {
+        siguiente = (siguiente & MARCA_ELIMINADO) | reinterpret_cast<std::uintptr_t>(sig);
+    }
+};
+
+/**
+ * Nodo compacto enlazado con un índice de 32 bits en lugar de un puntero.
+ * El índice 0 representa "sin siguiente"; el bit alto guarda la marca de
+ * borrado diferido. Aquí no hay relleno: la marca de tiempo lleva el
+ * nodo de float/int de 8 a 12 bytes.
+ */
+template <typename T>
+struct NodoIndexado {
+    static const std::uint32_t MARCA_ELIMINADO = 0x80000000u;
+
+    T dato;
+    std::uint32_t siguiente;
+    std::int32_t marca;   ///< Delta-de-delta del instante (MarcasTiempo.hpp); +4 bytes
+
+    NodoIndexado(const T& valor) : dato(valor), siguiente(0), marca(0) {}
+    NodoIndexado(T&& valor) : dato(std::move(valor)), siguiente(0), marca(0) {}
+
+    template <typename... Args>
+    NodoIndexado(std::in_place_t, Args&&... args)
+        : dato(std::forward<Args>(args)...), siguiente(0), marca(0) {}
+};
+
+/**
+ * Política de asignación clásica: un new/delete por nodo.
+ *
+ * Interfaz que ListaSensor espera de cualquier política:
+ *  - NodoT, crear(args...), destruir(nodo)
+ *  - siguiente(nodo), enlazar(nodo, sig)
+ *  - estaEliminado(nodo), marcarEliminado(nodo)
+ *  - liberarTodo(), intercambiar(otro) y la constante liberaEnBloque
+ *
+ * crear(args...) reenvía los argumentos al constructor del nodo: un valor
+ * (copia o movimiento) o std::in_place seguido de los argumentos de T.
+ * Con liberaEnBloque == false los nodos son independientes entre listas
+ * y pueden reenlazarse de una a otra (ListaSensor::empalmar).
+ */
+template <typename T>
+class AsignadorNew {
+public:
+    typedef Nodo<T> NodoT;
+
+    /// No hay bloques: cada nodo debe destruirse individualmente
+    static const bool liberaEnBloque = false;
+
+    AsignadorNew() {}
+    AsignadorNew(const AsignadorNew&) = delete;
+    AsignadorNew& operator=(const AsignadorNew&) = delete;
+
+    template <typename... Args>
+    NodoT* crear(Args&&... args) {
+        return new NodoT(std::forward<Args>(args)...);
+    }
+
+    void destruir(NodoT* nodo) {
+        delete nodo;
+    }
+
+    NodoT* siguiente(const NodoT* nodo) const {
+        return nodo->obtenerSiguiente();
+    }
+
+    void enlazar(NodoT* nodo, NodoT* sig) {
+        nodo->fijarSiguiente(sig);
+    }
+
+    bool estaEliminado(const NodoT* nodo) const {
+        return (nodo->siguiente & NodoT::MARCA_ELIMINADO) != 0;
+    }
+
+    void marcarEliminado(NodoT* nodo) {
+        nodo->siguiente |= NodoT::MARCA_ELIMINADO;
+    }
+
+    void liberarTodo() {}
+
+    void intercambiar(AsignadorNew&) {}
+};
+
+/**
+ * Base común de los asignadores por bloques (slab/arena).
+ *
+ * Reserva memoria en bloques contiguos cuyo tamaño se duplica
+ * (16, 16, 32, 64, ... nodos), de modo que un sensor con pocas lecturas
+ * no desperdicia memoria y uno con millones hace pocas reservas.
+ * El bloque k empieza en el índice global 16 * (2^k - 1), lo que permite
+ * traducir un índice de 32 bits a (bloque, posición) sin tablas extra.
+ * Los nodos liberados se reutilizan mediante una lista libre.
+ */
+template <typename NodoTipo>
+class BloquesNodos {
+public:
+    static const std::uint32_t NODOS_PRIMER_BLOQUE = 16;
+    static const int MAX_BLOQUES = 27;   ///< Índices por debajo de 2^31
+
+    BloquesNodos() : numBloques(0), usadosUltimo(0) {
+        for (int i = 0; i < MAX_BLOQUES; i++) {
+            bloques[i] = nullptr;
+        }
+    }
+
+    ~BloquesNodos() {
+        liberarBloques();
+    }
+
+    BloquesNodos(const BloquesNodos&) = delete;
+    BloquesNodos& operator=(const BloquesNodos&) = delete;
+
+    /** Cantidad de nodos que caben en el bloque k */
+    static std::uint32_t capacidadBloque(int k) {
+        return NODOS_PRIMER_BLOQUE << k;
+    }
+
+    /** Índice global (base 0) del primer nodo del bloque k */
+    static std::uint32_t inicioBloque(int k) {
+        return NODOS_PRIMER_BLOQUE * ((1u << k) - 1u);
+    }
+
+    /** Memoria reservada en bytes (para medir el costo por lectura) */
+    std::size_t bytesReservados() const {
+        if (numBloques == 0) {
+            return 0;
+        }
+        return static_cast<std::size_t>(inicioBloque(numBloques)) * sizeof(NodoTipo);
+    }
+
+protected:
+    /** Devuelve memoria sin construir para un nodo nuevo */
+    NodoTipo* reservarRanura() {
+        if (numBloques == 0 || usadosUltimo == capacidadBloque(numBloques - 1)) {
+            if (numBloques == MAX_BLOQUES) {
+                throw std::bad_alloc();
+            }
+            bloques[numBloques] = static_cast<NodoTipo*>(
+                ::operator new(capacidadBloque(numBloques) * sizeof(NodoTipo)));
+            numBloques++;
+            usadosUltimo = 0;
+        }
+        return bloques[numBloques - 1] + usadosUltimo++;
+    }
+
+    /** Traduce un índice base 1 a la dirección del nodo */
+    NodoTipo* direccion(std::uint32_t indice) const {
+        std::uint32_t i = indice - 1;
+        std::uint32_t q = i / NODOS_PRIMER_BLOQUE + 1;
+        int k = 31 - __builtin_clz(q);
+        return bloques[k] + (i - inicioBloque(k));
+    }
+
+    /** Traduce la dirección de un nodo a su índice base 1 */
+    std::uint32_t indiceDe(const NodoTipo* nodo) const {
+        for (int k = numBloques - 1; k >= 0; k--) {
+            if (nodo >= bloques[k] && nodo < bloques[k] + capacidadBloque(k)) {
+                return inicioBloque(k) + static_cast<std::uint32_t>(nodo - bloques[k]) + 1;
+            }
+        }
+        return 0;
+    }
+
+    /** Intercambia los bloques con otro asignador en O(MAX_BLOQUES) */
+    void intercambiarBloques(BloquesNodos& otro) {
+        for (int i = 0; i < MAX_BLOQUES; i++) {
+            std::swap(bloques[i], otro.bloques[i]);
+        }
+        std::swap(numBloques, otro.numBloques);
+        std::swap(usadosUltimo, otro.usadosUltimo);
+    }
+
+    void liberarBloques() {
+        for (int i = 0; i < numBloques; i++) {
+            ::operator delete(bloques[i]);
+            bloques[i] = nullptr;
+        }
+        numBloques = 0;
+        usadosUltimo = 0;
+    }
+
+private:
+    NodoTipo* bloques[MAX_BLOQUES];  ///< Bloques contiguos de nodos
+    int numBloques;                  ///< Bloques reservados
+    std::uint32_t usadosUltimo;      ///< Ranuras usadas del último bloque
+};
+
+/**
+ * Política slab con enlaces por puntero (predeterminada de ListaSensor).
+ *
+ * Los nodos viven en bloques contiguos y liberarTodo() devuelve un
+ * historial completo soltando sus bloques, sin recorrer nodo por nodo.
+ */
+template <typename T>
+class AsignadorSlab : public BloquesNodos<Nodo<T> > {
+public:
+    typedef Nodo<T> NodoT;
+
+    static const bool liberaEnBloque = true;
+
+    AsignadorSlab() : libres(nullptr) {}
+
+    template <typename... Args>
+    NodoT* crear(Args&&... args) {
+        void* memoria;
+        if (libres != nullptr) {
+            memoria = libres;
+            libres = libres->obtenerSiguiente();
+        } else {
+            memoria = this->reservarRanura();
+        }
+        return new (memoria) NodoT(std::forward<Args>(args)...);
+    }
+
+    void destruir(NodoT* nodo) {
+        // La ranura pasa a la lista libre reutilizando el campo de enlace
+        nodo->dato.~T();
+        nodo->siguiente = reinterpret_cast<std::uintptr_t>(libres);
+        libres = nodo;
+    }
+
+    NodoT* siguiente(const NodoT* nodo) const {
+        return nodo->obtenerSiguiente();
+    }
+
+    void enlazar(NodoT* nodo, NodoT* sig) {
+        nodo->fijarSiguiente(sig);
+    }
+
+    bool estaEliminado(const NodoT* nodo) const {
+        return (nodo->siguiente & NodoT::MARCA_ELIMINADO) != 0;
+    }
+
+    void marcarEliminado(NodoT* nodo) {
+        nodo->siguiente |= NodoT::MARCA_ELIMINADO;
+    }
+
+    void liberarTodo() {
+        this->liberarBloques();
+        libres = nullptr;
+    }
+
+    void intercambiar(AsignadorSlab& otro) {
+        this->intercambiarBloques(otro);
+        std::swap(libres, otro.libres);
+    }
+
+private:
+    NodoT* libres;  ///< Lista de ranuras liberadas
+};
+
+/**
+ * Política slab con enlaces de 32 bits.
+ *
+ * Igual que AsignadorSlab, pero cada nodo guarda el índice del siguiente
+ * (4 bytes) en lugar de un puntero (8 bytes). Para float/int el nodo pasa
+ * de 16 a 12 bytes (8 sin la marca de tiempo). El costo es una traducción índice -> dirección por salto.
+ */
+template <typename T>
+class AsignadorSlabIndices : public BloquesNodos<NodoIndexado<T> > {
+public:
+    typedef NodoIndexado<T> NodoT;
+
+    static const bool liberaEnBloque = true;
+
+    AsignadorSlabIndices() : libres(0) {}
+
+    template <typename... Args>
+    NodoT* crear(Args&&... args) {
+        void* memoria;
+        if (libres != 0) {
+            NodoT* ranura = this->direccion(libres);
+            libres = ranura->siguiente;
+            memoria = ranura;
+        } else {
+            memoria = this->reservarRanura();
+        }
+        return new (memoria) NodoT(std::forward<Args>(args)...);
+    }
+
+    void destruir(NodoT* nodo) {
+        std::uint32_t indice = this->indiceDe(nodo);
+        nodo->dato.~T();
+        nodo->siguiente = libres;
+        libres = indice;
+    }
+
+    NodoT* siguiente(const NodoT* nodo) const {
+        std::uint32_t indice = nodo->siguiente & ~NodoT::MARCA_ELIMINADO;
+        return indice == 0 ? nullptr : this->direccion(indice);
+    }
+
+    void enlazar(NodoT* nodo, NodoT* sig) {
+        std::uint32_t marca = nodo->siguiente & NodoT::MARCA_ELIMINADO;
+        nodo->siguiente = marca | ((sig == nullptr) ? 0 : this->indiceDe(sig));
+    }
+
+    bool estaEliminado(const NodoT* nodo) const {
+        return (nodo->siguiente & NodoT::MARCA_ELIMINADO) != 0;
+    }
+
+    void marcarEliminado(NodoT* nodo) {
+        nodo->siguiente |= NodoT::MARCA_ELIMINADO;
+    }
+
+    void liberarTodo() {
+        this->liberarBloques();
+        libres = 0;
+    }
+
+    void intercambiar(AsignadorSlabIndices& otro) {
+        this->intercambiarBloques(otro);
+        std::swap(libres, otro.libres);
+    }
+
+private:
+    std::uint32_t libres;  ///< Índice de la primera ranura libre (0 = ninguna)
+};
+
+#endif // ASIGNADOR_NODOS_HPP
@@ -0,0 +1,432 @@
+#ifndef BITACORA_HPP
+#define BITACORA_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "ColaSPSC.hpp"
+
+/**
+ * Políticas de bitácora (log) seleccionables en tiempo de compilación.
+ *
+ * Todas exponen registrar(funcion), donde funcion(auto& os) escribe una
+ * línea sin salto final con operator<<. El mensaje sólo se formatea si la
+ * política lo necesita, así que con BitacoraSilenciosa la llamada
+ * desaparece. `os` es un std::ostream o, con BitacoraBuffer, un
+ * RegistroBitacora; por eso la función es una lambda genérica.
+ *
+ * La política usada por ListaSensor, los sensores y GestorSensores se
+ * elige con SISTEMAIOT_BITACORA (opción de CMake del mismo nombre):
+ *  - 0: silenciosa   (sin costo en la ruta de ingesta)
+ *  - 1: con buffer   (registro binario por hilo; un hilo escritor formatea y escribe)
+ *  - 2: detallada    (std::cout << ... << std::endl, el comportamiento original)
+ */
+
+#define SISTEMAIOT_BITACORA_SILENCIOSA 0
+#define SISTEMAIOT_BITACORA_BUFFER     1
+#define SISTEMAIOT_BITACORA_DETALLADA  2
+
+#ifndef SISTEMAIOT_BITACORA
+#define SISTEMAIOT_BITACORA SISTEMAIOT_BITACORA_DETALLADA
+#endif
+
+/**
+ * Flujo alternativo de la bitácora para el hilo actual (nullptr: el de
+ * la política). Lo usa el procesamiento en paralelo para que los mensajes
+ * de cada sensor queden junto a su salida y se emitan en orden.
+ */
+inline std::ostream*& destinoBitacoraHilo() {
+    thread_local std::ostream* destino = nullptr;
+    return destino;
+}
+
+/** Redirige la bitácora del hilo actual a otro flujo mientras exista */
+class RedireccionBitacora {
+public:
+    explicit RedireccionBitacora(std::ostream& destino) : anterior(destinoBitacoraHilo()) {
+        destinoBitacoraHilo() = &destino;
+    }
+
+    ~RedireccionBitacora() {
+        destinoBitacoraHilo() = anterior;
+    }
+
+    RedireccionBitacora(const RedireccionBitacora&) = delete;
+    RedireccionBitacora& operator=(const RedireccionBitacora&) = delete;
+
+private:
+    std::ostream* anterior;
+};
+
+/** Descarta todos los mensajes; el compilador elimina la llamada */
+struct BitacoraSilenciosa {
+    template <typename Funcion>
+    static void registrar(Funcion&&) {}
+
+    static void vaciar() {}
+};
+
+/** Escribe cada mensaje en std::cout y vacía el flujo (una escritura por línea) */
+struct BitacoraDetallada {
+    template <typename Funcion>
+    static void registrar(Funcion&& escribir) {
+        if (std::ostream* destino = destinoBitacoraHilo()) {
+            escribir(*destino);
+            destino->put('\n');
+            return;
+        }
+        escribir(std::cout);
+        std::cout << std::endl;
+    }
+
+    static void vaciar() {
+        std::cout.flush();
+    }
+};
+
+/**
+ * Mensaje de bitácora sin formatear, de tamaño fijo. Lo que la llamada
+ * envía con << se guarda tal cual: el texto se copia y los números van en
+ * binario con una etiqueta, así que la ruta de ingesta no convierte nada
+ * a texto. El hilo escritor lo formatea con escribir(). Un mensaje que no
+ * cabe se trunca y termina en "...".
+ */
+class RegistroBitacora {
+public:
+    static const std::size_t CAPACIDAD = 252;   ///< Bytes de contenido (registro de 256)
+
+    RegistroBitacora() : usados(0), truncado(false) {}
+
+    void reiniciar() {
+        usados = 0;
+        truncado = false;
+    }
+
+    RegistroBitacora& operator<<(const char* texto) {
+        agregarTexto(texto, std::strlen(texto));
+        return *this;
+    }
+
+    RegistroBitacora& operator<<(const std::string& texto) {
+        agregarTexto(texto.data(), texto.size());
+        return *this;
+    }
+
+    RegistroBitacora& operator<<(char c) {
+        agregarTexto(&c, 1);
+        return *this;
+    }
+
+    template <typename U>
+    typename std::enable_if<std::is_integral<U>::value && std::is_signed<U>::value &&
+                                !std::is_same<U, signed char>::value, RegistroBitacora&>::type
+    operator<<(U valor) {
+        std::int64_t v = valor;
+        agregarValor(ENTERO, &v);
+        return *this;
+    }
+
+    template <typename U>
+    typename std::enable_if<std::is_integral<U>::value && std::is_unsigned<U>::value &&
+                                !std::is_same<U, unsigned char>::value, RegistroBitacora&>::type
+    operator<<(U valor) {
+        std::uint64_t v = valor;
+        agregarValor(SIN_SIGNO, &v);
+        return *this;
+    }
+
+    template <typename U>
+    typename std::enable_if<std::is_floating_point<U>::value, RegistroBitacora&>::type
+    operator<<(U valor) {
+        double v = static_cast<double>(valor);
+        agregarValor(REAL, &v);
+        return *this;
+    }
+
+    /** Otros tipos (con su operator<<) se formatean aquí; es la vía lenta */
+    template <typename U>
+    typename std::enable_if<!std::is_arithmetic<U>::value &&
+                                !std::is_convertible<const U&, const char*>::value &&
+                                !std::is_convertible<const U&, std::string>::value,
+                            RegistroBitacora&>::type
+    operator<<(const U& valor) {
+        thread_local std::ostringstream flujo;
+        flujo.str(std::string());
+        flujo << valor;
+        const std::string texto = flujo.str();
+        agregarTexto(texto.data(), texto.size());
+        return *this;
+    }
+
+    /** Convierte el registro en texto (en el hilo escritor) */
+    void escribir(std::ostream& os) const {
+        std::size_t i = 0;
+        while (i < usados) {
+            unsigned char etiqueta = datos[i++];
+            if (etiqueta == TEXTO) {
+                std::size_t n = datos[i++];
+                os.write(reinterpret_cast<const char*>(datos + i), static_cast<std::streamsize>(n));
+                i += n;
+            } else if (etiqueta == ENTERO) {
+                std::int64_t v;
+                std::memcpy(&v, datos + i, sizeof(v));
+                os << v;
+                i += sizeof(v);
+            } else if (etiqueta == SIN_SIGNO) {
+                std::uint64_t v;
+                std::memcpy(&v, datos + i, sizeof(v));
+                os << v;
+                i += sizeof(v);
+            } else {
+                double v;
+                std::memcpy(&v, datos + i, sizeof(v));
+                os << v;
+                i += sizeof(v);
+            }
+        }
+        if (truncado) {
+            os << "...";
+        }
+    }
+
+private:
+    enum Etiqueta : unsigned char { TEXTO = 1, ENTERO = 2, SIN_SIGNO = 3, REAL = 4 };
+
+    void agregarTexto(const char* texto, std::size_t n) {
+        while (n > 0) {
+            if (std::size_t(usados) + 2 >= CAPACIDAD) {
+                truncado = true;
+                return;
+            }
+            std::size_t tramo = CAPACIDAD - usados - 2;
+            if (tramo > 255) {
+                tramo = 255;
+            }
+            if (tramo > n) {
+                tramo = n;
+            }
+            datos[usados++] = TEXTO;
+            datos[usados++] = static_cast<unsigned char>(tramo);
+            std::memcpy(datos + usados, texto, tramo);
+            usados = static_cast<std::uint16_t>(usados + tramo);
+            texto += tramo;
+            n -= tramo;
+        }
+    }
+
+    void agregarValor(Etiqueta etiqueta, const void* valor) {
+        if (std::size_t(usados) + 9 > CAPACIDAD) {
+            truncado = true;
+            return;
+        }
+        datos[usados++] = etiqueta;
+        std::memcpy(datos + usados, valor, 8);
+        usados = static_cast<std::uint16_t>(usados + 8);
+    }
+
+    std::uint16_t usados;
+    bool truncado;
+    unsigned char datos[CAPACIDAD];
+};
+
+/**
+ * Hilo de fondo de BitacoraBuffer: recorre las colas de todos los hilos
+ * que registraron mensajes, los formatea y los envía a std::cout en un
+ * solo write por pasada (cada PERIODO, o antes si una cola se llena o se
+ * pide vaciar()). Al destruirse (fin del proceso) hace una última pasada.
+ */
+class EscritorBitacora {
+public:
+    static const std::size_t REGISTROS_POR_HILO = 1024;   ///< 256 KiB por hilo
+
+    /// Cola de un hilo productor; `terminado` indica que el hilo ya salió
+    struct CanalHilo {
+        ColaSPSC<RegistroBitacora> cola;
+        std::atomic<bool> terminado;
+
+        CanalHilo() : cola(REGISTROS_POR_HILO), terminado(false) {}
+    };
+
+    static EscritorBitacora& instancia() {
+        static EscritorBitacora escritor;
+        return escritor;
+    }
+
+    std::shared_ptr<CanalHilo> abrirCanal() {
+        std::shared_ptr<CanalHilo> canal = std::make_shared<CanalHilo>();
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        canales.push_back(canal);
+        return canal;
+    }
+
+    /** Adelanta la próxima pasada (un productor encontró su cola llena) */
+    void despertar() {
+        pendiente.store(true, std::memory_order_release);
+        aviso.notify_one();
+    }
+
+    /**
+     * Espera a que se escriban los mensajes que todos los hilos publicaron
+     * antes de la llamada: una pasada completa que empiece después de ella.
+     */
+    void vaciar() {
+        std::unique_lock<std::mutex> bloqueo(mutex);
+        std::uint64_t objetivo = pasadas + 2;
+        pendiente.store(true, std::memory_order_release);
+        aviso.notify_one();
+        terminada.wait(bloqueo, [&] { return pasadas >= objetivo || !activo; });
+    }
+
+    ~EscritorBitacora() {
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            activo = false;
+        }
+        aviso.notify_one();
+        hilo.join();
+    }
+
+    EscritorBitacora(const EscritorBitacora&) = delete;
+    EscritorBitacora& operator=(const EscritorBitacora&) = delete;
+
+private:
+    EscritorBitacora() : activo(true), pendiente(false), pasadas(0) {
+        hilo = std::thread(&EscritorBitacora::ejecutar, this);
+    }
+
+    void ejecutar() {
+        std::ostringstream texto;
+        std::vector<std::shared_ptr<CanalHilo> > copia;
+        bool seguir = true;
+        while (seguir) {
+            {
+                std::unique_lock<std::mutex> bloqueo(mutex);
+                aviso.wait_for(bloqueo, PERIODO, [this] {
+                    return !activo || pendiente.load(std::memory_order_acquire);
+                });
+                pendiente.store(false, std::memory_order_relaxed);
+                seguir = activo;
+                copia = canales;
+            }
+
+            for (std::size_t i = 0; i < copia.size(); i++) {
+                // Si el hilo ya salió, lo que queda en su cola es todo lo que publicó
+                bool terminado = copia[i]->terminado.load(std::memory_order_acquire);
+                while (const RegistroBitacora* registro = copia[i]->cola.frente()) {
+                    registro->escribir(texto);
+                    texto.put('\n');
+                    copia[i]->cola.soltar();
+                }
+                if (terminado) {
+                    quitarCanal(copia[i]);
+                }
+            }
+            copia.clear();
+
+            const std::string salida = texto.str();
+            if (!salida.empty()) {
+                std::cout.write(salida.data(), static_cast<std::streamsize>(salida.size()));
+                std::cout.flush();
+                texto.str(std::string());
+            }
+
+            {
+                std::lock_guard<std::mutex> bloqueo(mutex);
+                pasadas++;
+            }
+            terminada.notify_all();
+        }
+    }
+
+    void quitarCanal(const std::shared_ptr<CanalHilo>& canal) {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        for (std::size_t i = 0; i < canales.size(); i++) {
+            if (canales[i] == canal) {
+                canales[i] = canales.back();
+                canales.pop_back();
+                return;
+            }
+        }
+    }
+
+    static constexpr std::chrono::milliseconds PERIODO{50};
+
+    std::mutex mutex;
+    std::condition_variable aviso;       ///< Despierta al escritor
+    std::condition_variable terminada;   ///< Avisa el fin de cada pasada
+    std::vector<std::shared_ptr<CanalHilo> > canales;
+    bool activo;
+    std::atomic<bool> pendiente;
+    std::uint64_t pasadas;               ///< Pasadas completas (protegido por mutex)
+    std::thread hilo;
+};
+
+/**
+ * Bitácora asíncrona: cada hilo construye sus mensajes como registros
+ * binarios de tamaño fijo (RegistroBitacora) directamente en su propia
+ * cola SPSC, y EscritorBitacora los formatea y escribe desde otro hilo.
+ * En la ruta de ingesta no se formatean números ni hay llamadas al
+ * sistema; sólo si la cola del hilo se llena se espera al escritor.
+ * vaciar() y el fin del proceso escriben lo pendiente de todos los hilos.
+ */
+struct BitacoraBuffer {
+    template <typename Funcion>
+    static void registrar(Funcion&& escribir) {
+        if (std::ostream* destino = destinoBitacoraHilo()) {
+            escribir(*destino);
+            destino->put('\n');
+            return;
+        }
+        ColaSPSC<RegistroBitacora>& cola = canal().cola;
+        RegistroBitacora* registro;
+        while ((registro = cola.reservar()) == nullptr) {
+            EscritorBitacora::instancia().despertar();
+            std::this_thread::yield();
+        }
+        registro->reiniciar();
+        escribir(*registro);
+        cola.publicar();
+    }
+
+    /** Escribe lo que todos los hilos registraron hasta ahora */
+    static void vaciar() {
+        EscritorBitacora::instancia().vaciar();
+    }
+
+private:
+    /// Canal del hilo actual; al terminar el hilo se marca para que el escritor lo retire
+    struct CanalLocal {
+        std::shared_ptr<EscritorBitacora::CanalHilo> canal;
+
+        CanalLocal() : canal(EscritorBitacora::instancia().abrirCanal()) {}
+
+        ~CanalLocal() {
+            canal->terminado.store(true, std::memory_order_release);
+        }
+    };
+
+    static EscritorBitacora::CanalHilo& canal() {
+        thread_local CanalLocal local;
+        return *local.canal;
+    }
+};
+
+#if SISTEMAIOT_BITACORA == SISTEMAIOT_BITACORA_SILENCIOSA
+typedef BitacoraSilenciosa BitacoraPredeterminada;
+#elif SISTEMAIOT_BITACORA == SISTEMAIOT_BITACORA_BUFFER
+typedef BitacoraBuffer BitacoraPredeterminada;
+#else
+typedef BitacoraDetallada BitacoraPredeterminada;
+#endif
+
+#endif // BITACORA_HPP
@@ -0,0 +1,105 @@
+#ifndef COLA_MPSC_HPP
+#define COLA_MPSC_HPP
+
+#include <atomic>
+#include <cstddef>
+
+
+/**
+ * Cola acotada sin candados para varios productores y un consumidor (MPSC).
+ *
+ * Anillo de capacidad potencia de 2 en el que cada casilla lleva un
+ * número de secuencia (esquema de D. Vyukov): un productor reserva la
+ * posición con un compare-exchange sobre `cola` y publica el dato
+ * avanzando la secuencia de la casilla; el consumidor sólo lee casillas
+ * cuya secuencia ya fue publicada. Si la cola está llena, intentarEncolar
+ * retorna false en vez de esperar, así que ningún productor se bloquea.
+ */
+template <typename T>
+class ColaMPSC {
+public:
+    explicit ColaMPSC(std::size_t capacidadMinima = 4096)
+        : capacidad(potenciaDeDos(capacidadMinima)), mascara(capacidad - 1),
+          casillas(new Casilla[capacidad]), cabeza(0), cola(0) {
+        for (std::size_t i = 0; i < capacidad; i++) {
+            casillas[i].secuencia.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~ColaMPSC() {
+        delete[] casillas;
+    }
+
+    ColaMPSC(const ColaMPSC&) = delete;
+    ColaMPSC& operator=(const ColaMPSC&) = delete;
+
+    /** Productor (cualquier hilo): encola si hay espacio; false si está llena */
+    bool intentarEncolar(const T& valor) {
+        std::size_t posicion = cola.load(std::memory_order_relaxed);
+        Casilla* casilla;
+        while (true) {
+            casilla = &casillas[posicion & mascara];
+            std::size_t secuencia = casilla->secuencia.load(std::memory_order_acquire);
+            std::ptrdiff_t diferencia = static_cast<std::ptrdiff_t>(secuencia - posicion);
+            if (diferencia == 0) {
+                if (cola.compare_exchange_weak(posicion, posicion + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diferencia < 0) {
+                return false;  // La casilla aún guarda un dato sin consumir
+            } else {
+                posicion = cola.load(std::memory_order_relaxed);
+            }
+        }
+        casilla->valor = valor;
+        casilla->secuencia.store(posicion + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumidor (un solo hilo): desencola si hay datos publicados */
+    bool intentarDesencolar(T& salida) {
+        std::size_t posicion = cabeza.load(std::memory_order_relaxed);
+        Casilla& casilla = casillas[posicion & mascara];
+        if (casilla.secuencia.load(std::memory_order_acquire) != posicion + 1) {
+            return false;
+        }
+        salida = casilla.valor;
+        casilla.secuencia.store(posicion + capacidad, std::memory_order_release);
+        cabeza.store(posicion + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /** Elementos reservados y no consumidos (aproximado desde otro hilo) */
+    std::size_t tamanio() const {
+        std::size_t c = cola.load(std::memory_order_acquire);
+        std::size_t h = cabeza.load(std::memory_order_acquire);
+        return (c > h) ? c - h : 0;
+    }
+
+    std::size_t obtenerCapacidad() const {
+        return capacidad;
+    }
+
+private:
+    struct Casilla {
+        std::atomic<std::size_t> secuencia;
+        T valor;
+    };
+
+    static std::size_t potenciaDeDos(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    const std::size_t capacidad;
+    const std::size_t mascara;
+    Casilla* const casillas;
+
+    alignas(64) std::atomic<std::size_t> cabeza;   ///< Escrito por el consumidor
+    alignas(64) std::atomic<std::size_t> cola;     ///< Reservado por los productores
+};
+
+#endif // COLA_MPSC_HPP
@@ -0,0 +1,126 @@
+#ifndef COLA_SPSC_HPP
+#define COLA_SPSC_HPP
+
+#include <atomic>
+#include <cstddef>
+
+
+/**
+ * Cola acotada sin bloqueos para un productor y un consumidor (SPSC).
+ *
+ * Anillo de capacidad potencia de 2. Cada extremo sólo escribe su propio
+ * índice (con release) y lee el del otro (con acquire); además guarda una
+ * copia local del índice ajeno para no tocar su línea de caché en cada
+ * operación. Los índices viven en líneas de caché distintas para evitar
+ * falso compartir entre el hilo productor y el consumidor.
+ */
+template <typename T>
+class ColaSPSC {
+public:
+    explicit ColaSPSC(std::size_t capacidadMinima = 4096)
+        : capacidad(potenciaDeDos(capacidadMinima)), mascara(capacidad - 1),
+          datos(new T[capacidad]),
+          cabeza(0), colaCache(0), cola(0), cabezaCache(0) {}
+
+    ~ColaSPSC() {
+        delete[] datos;
+    }
+
+    ColaSPSC(const ColaSPSC&) = delete;
+    ColaSPSC& operator=(const ColaSPSC&) = delete;
+
+    /** Productor: encola si hay espacio; false si la cola está llena */
+    bool intentarEncolar(const T& valor) {
+        std::size_t c = cola.load(std::memory_order_relaxed);
+        if (c - cabezaCache == capacidad) {
+            cabezaCache = cabeza.load(std::memory_order_acquire);
+            if (c - cabezaCache == capacidad) {
+                return false;
+            }
+        }
+        datos[c & mascara] = valor;
+        cola.store(c + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumidor: desencola si hay datos; false si la cola está vacía */
+    bool intentarDesencolar(T& salida) {
+        std::size_t h = cabeza.load(std::memory_order_relaxed);
+        if (h == colaCache) {
+            colaCache = cola.load(std::memory_order_acquire);
+            if (h == colaCache) {
+                return false;
+            }
+        }
+        salida = datos[h & mascara];
+        cabeza.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Productor: ranura libre para construir el dato en su lugar, sin
+     *  copiarlo; nullptr si la cola está llena. Se hace visible con publicar()
+     */
+    T* reservar() {
+        std::size_t c = cola.load(std::memory_order_relaxed);
+        if (c - cabezaCache == capacidad) {
+            cabezaCache = cabeza.load(std::memory_order_acquire);
+            if (c - cabezaCache == capacidad) {
+                return nullptr;
+            }
+        }
+        return &datos[c & mascara];
+    }
+
+    /** Productor: publica la ranura obtenida con reservar() */
+    void publicar() {
+        cola.store(cola.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /** Consumidor: dato más antiguo sin copiarlo; nullptr si la cola está
+     *  vacía. La ranura se devuelve con soltar()
+     */
+    const T* frente() {
+        std::size_t h = cabeza.load(std::memory_order_relaxed);
+        if (h == colaCache) {
+            colaCache = cola.load(std::memory_order_acquire);
+            if (h == colaCache) {
+                return nullptr;
+            }
+        }
+        return &datos[h & mascara];
+    }
+
+    /** Consumidor: libera la ranura obtenida con frente() */
+    void soltar() {
+        cabeza.store(cabeza.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /** Elementos pendientes (aproximado si se llama desde otro hilo) */
+    std::size_t tamanio() const {
+        return cola.load(std::memory_order_acquire) - cabeza.load(std::memory_order_acquire);
+    }
+
+    std::size_t obtenerCapacidad() const {
+        return capacidad;
+    }
+
+private:
+    static std::size_t potenciaDeDos(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    const std::size_t capacidad;
+    const std::size_t mascara;
+    T* const datos;
+
+    alignas(64) std::atomic<std::size_t> cabeza;   ///< Escrito por el consumidor
+    std::size_t colaCache;                         ///< Copia de cola del consumidor
+    alignas(64) std::atomic<std::size_t> cola;     ///< Escrito por el productor
+    std::size_t cabezaCache;                       ///< Copia de cabeza del productor
+};
+
+#endif // COLA_SPSC_HPP
@@ -11,6 +11,7 @@
     #include <termios.h>
     #include <fcntl.h>
     #include <unistd.h>
+    #include <cerrno>
     typedef int PuertoSerial;
 #endif
 
@@ -42,8 +43,12 @@ public:
 
 
     bool conectar(const char* puerto_nombre, int velocidad = 9600) {
-        std::strncpy(puertoNombre, puerto_nombre, sizeof(puertoNombre) - 1);
-        puertoNombre[sizeof(puertoNombre) - 1] = '\0';
+        std::size_t largo = std::strlen(puerto_nombre);   // Se trunca si no cabe
+        if (largo >= sizeof(puertoNombre)) {
+            largo = sizeof(puertoNombre) - 1;
+        }
+        std::memcpy(puertoNombre, puerto_nombre, largo);
+        puertoNombre[largo] = '\0';
 
         #ifdef _WIN32
             return conectarWindows(velocidad);
@@ -53,6 +58,9 @@ public:
     }
 
 
+    /** Lee lo disponible sin bloquear (en Linux el puerto es O_NONBLOCK).
+     *  Retorna los bytes leídos, 0 si no hay datos y -1 en error.
+     */
     int leer(char* buffer, int tamanio) {
         if (!conectado) {
             std::cerr << "[Error] Puerto no conectado." << std::endl;
@@ -66,6 +74,9 @@ public:
             }
         #else
             int bytesLeidos = ::read(puerto, buffer, tamanio);
+            if (bytesLeidos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                return 0;
+            }
             return bytesLeidos;
         #endif
 
@@ -109,6 +120,16 @@ public:
         return conectado;
     }
 
+    /** Ruta o nombre con que se abrió el puerto */
+    const char* obtenerNombre() const {
+        return puertoNombre;
+    }
+
+    /** Descriptor/handle del puerto para esperar eventos (poll) */
+    PuertoSerial obtenerDescriptor() const {
+        return puerto;
+    }
+
 private:
     #ifdef _WIN32
     bool conectarWindows(int velocidad) {
@@ -177,7 +198,8 @@ private:
             return false;
         }
 
-        fcntl(puerto, F_SETFL, 0);
+        // Modo no bloqueante: la espera la hace poll() en MotorIngesta
+        fcntl(puerto, F_SETFL, fcntl(puerto, F_GETFL) | O_NONBLOCK);
 
         termios tty;
         if (tcgetattr(puerto, &tty) != 0) {
@@ -204,8 +226,13 @@ private:
 
         tty.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
         tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+        tty.c_iflag &= ~(INLCR | ICRNL | IGNCR);
         tty.c_oflag &= ~OPOST;
 
+        // read() devuelve de inmediato con lo que haya en el buffer
+        tty.c_cc[VMIN] = 0;
+        tty.c_cc[VTIME] = 0;
+
         if (tcsetattr(puerto, TCSANOW, &tty) != 0) {
             std::cerr << "[Error] No se pudo configurar el puerto." << std::endl;
             close(puerto);
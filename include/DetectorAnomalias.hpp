@@ -0,0 +1,337 @@
+#ifndef DETECTOR_ANOMALIAS_HPP
+#define DETECTOR_ANOMALIAS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "ColaMPSC.hpp"
+
+/// Regla que disparó una anomalía
+enum class TipoAnomalia : std::uint8_t {
+    Desviacion = 1,   ///< |z| de la lectura frente a la media móvil supera el umbral
+    Salto = 2         ///< Cambio respecto de la lectura anterior mayor que el permitido
+};
+
+/// Parámetros del modelo de un sensor
+struct ParametrosAnomalia {
+    double alfa;               ///< Peso de la lectura nueva en la media/varianza EWMA (0, 1]
+    double umbralZ;            ///< Desviaciones estándar a partir de las que se alerta (0: sin z)
+    std::uint32_t calentamiento;  ///< Lecturas que se observan antes de evaluar z
+    double variacionMaxima;    ///< Cambio máximo entre lecturas consecutivas (0: sin límite)
+    double desvioMinimo;       ///< σ mínimo del test z, en unidades de la lectura (p. ej. su resolución)
+};
+
+/// Anomalía detectada, tal como sale de la cola de eventos
+struct EventoAnomalia {
+    std::uint32_t idSensor;
+    TipoAnomalia tipo;
+    std::int64_t instanteMs;   ///< Instante de la lectura (ms del reloj del sistema)
+    double valor;              ///< Lectura anómala
+    double referencia;         ///< Media móvil (Desviacion) o lectura anterior (Salto)
+    double puntaje;            ///< z con signo (Desviacion) o valor - anterior (Salto)
+    char nombre[50];           ///< Nombre del sensor (el consumidor no toca el gestor)
+};
+
+/**
+ * Detección de anomalías en línea, lectura por lectura, en la ruta de
+ * ingesta.
+ *
+ * Cada sensor tiene un modelo de tamaño fijo: media y varianza con
+ * promedio móvil exponencial (EWMA) y la lectura anterior. Evaluar una
+ * lectura cuesta O(1) y no reserva memoria: compara desvío² con
+ * umbralZ²·varianza (la raíz sólo se calcula al alertar), revisa el salto
+ * frente a la lectura anterior y actualiza el modelo. Las lecturas
+ * anómalas también actualizan la media, así que un cambio de nivel
+ * sostenido deja de alertar en unas 1/alfa lecturas.
+ *
+ * La varianza se acota por abajo con desvioMinimo² antes del test z: tras
+ * un calentamiento constante la varianza EWMA es 0 y, sin piso, el primer
+ * cambio (aunque sea de una unidad de resolución) daría z = ±∞.
+ *
+ * Las detecciones van a una ColaMPSC acotada: varios hilos aplicadores
+ * pueden encolar sin candados y, si el consumidor se atrasa y la cola se
+ * llena, el evento se descarta y se cuenta en vez de frenar la ingesta.
+ * Un solo hilo las saca con drenar() (p. ej. AlertadorAnomalias).
+ *
+ * Igual que en GestorSensores, cada modelo lo escribe sólo el hilo que
+ * aplica las lecturas de su sensor; prepararSensor y configurar deben
+ * llamarse antes de iniciar la ingesta concurrente.
+ */
+class DetectorAnomalias {
+public:
+    explicit DetectorAnomalias(ParametrosAnomalia parametros = { 0.05, 4.0, 32, 0.0, 0.01 },
+                               std::size_t capacidadCola = 4096)
+        : predeterminados(parametros), eventos(capacidadCola), detectadas(0), descartadas(0) {}
+
+    DetectorAnomalias(const DetectorAnomalias&) = delete;
+    DetectorAnomalias& operator=(const DetectorAnomalias&) = delete;
+
+    /** Crea el modelo del sensor id con los parámetros predeterminados
+     *  (si ya existía sólo actualiza el nombre)
+     */
+    void prepararSensor(std::uint32_t id, const char* nombre) {
+        if (id >= modelos.size()) {
+            modelos.resize(id + 1);
+        }
+        ModeloAnomalia& modelo = modelos[id];
+        if (!modelo.preparado) {
+            modelo.parametros = predeterminados;
+            modelo.preparado = true;
+        }
+        std::size_t largo = std::strlen(nombre);   // Se trunca si no cabe
+        if (largo >= sizeof(modelo.nombre)) {
+            largo = sizeof(modelo.nombre) - 1;
+        }
+        std::memcpy(modelo.nombre, nombre, largo);
+        modelo.nombre[largo] = '\0';
+    }
+
+    /** Parámetros propios del sensor id (p. ej. el salto admisible según
+     *  sus unidades); conserva lo que el modelo ya aprendió
+     */
+    void configurar(std::uint32_t id, ParametrosAnomalia parametros) {
+        if (id >= modelos.size()) {
+            modelos.resize(id + 1);
+        }
+        modelos[id].parametros = parametros;
+        modelos[id].preparado = true;
+    }
+
+    /**
+     * Evalúa una lectura del sensor id contra su modelo y lo actualiza.
+     * Retorna cuántas anomalías se detectaron (0, 1 o 2); se encolan
+     * aunque luego se descarten por cola llena.
+     */
+    std::uint32_t evaluar(std::uint32_t id, double valor, std::int64_t instanteMs) {
+        if (id >= modelos.size() || !modelos[id].preparado || std::isnan(valor)) {
+            return 0;
+        }
+        ModeloAnomalia& m = modelos[id];
+        const ParametrosAnomalia& p = m.parametros;
+        if (m.observadas == 0) {
+            m.media = valor;
+            m.varianza = 0.0;
+            m.anterior = valor;
+            m.observadas = 1;
+            return 0;
+        }
+
+        std::uint32_t encontradas = 0;
+        double desvio = valor - m.media;
+        double piso = p.desvioMinimo * p.desvioMinimo;
+        double varianza = (m.varianza > piso) ? m.varianza : piso;
+        if (p.umbralZ > 0.0 && m.observadas >= p.calentamiento &&
+            desvio * desvio > p.umbralZ * p.umbralZ * varianza) {
+            // Sólo sin piso (desvioMinimo = 0) la varianza puede ser 0
+            double z = (varianza > 0.0) ? desvio / std::sqrt(varianza)
+                                        : std::copysign(std::numeric_limits<double>::infinity(), desvio);
+            emitir(m, id, TipoAnomalia::Desviacion, instanteMs, valor, m.media, z);
+            encontradas++;
+        }
+        double salto = valor - m.anterior;
+        if (p.variacionMaxima > 0.0 && std::fabs(salto) > p.variacionMaxima) {
+            emitir(m, id, TipoAnomalia::Salto, instanteMs, valor, m.anterior, salto);
+            encontradas++;
+        }
+
+        // EWMA de media y varianza (forma incremental de West/Finch)
+        double incremento = p.alfa * desvio;
+        m.media += incremento;
+        m.varianza = (1.0 - p.alfa) * (m.varianza + desvio * incremento);
+        m.anterior = valor;
+        if (m.observadas < std::numeric_limits<std::uint32_t>::max()) {
+            m.observadas++;
+        }
+        return encontradas;
+    }
+
+    /** Evalúa un lote de lecturas del mismo sensor tomadas en instanteMs */
+    std::uint32_t evaluarVarios(std::uint32_t id, const double* valores, std::size_t n, std::int64_t instanteMs) {
+        std::uint32_t encontradas = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            encontradas += evaluar(id, valores[i], instanteMs);
+        }
+        return encontradas;
+    }
+
+    /**
+     * Consumidor (un solo hilo): entrega a destino(const EventoAnomalia&)
+     * hasta `maximo` eventos pendientes. Retorna cuántos entregó.
+     */
+    template <typename Destino>
+    std::size_t drenar(Destino&& destino, std::size_t maximo = static_cast<std::size_t>(-1)) {
+        EventoAnomalia evento;
+        std::size_t entregados = 0;
+        while (entregados < maximo && eventos.intentarDesencolar(evento)) {
+            destino(static_cast<const EventoAnomalia&>(evento));
+            entregados++;
+        }
+        return entregados;
+    }
+
+    /** Media y desviación estándar móviles del sensor id (0 si no hay modelo) */
+    double obtenerMedia(std::uint32_t id) const {
+        return (id < modelos.size()) ? modelos[id].media : 0.0;
+    }
+
+    double obtenerDesviacion(std::uint32_t id) const {
+        return (id < modelos.size()) ? std::sqrt(modelos[id].varianza) : 0.0;
+    }
+
+    /** Anomalías detectadas (encoladas o no) */
+    std::uint64_t obtenerDetectadas() const {
+        return detectadas.load(std::memory_order_relaxed);
+    }
+
+    /** Anomalías perdidas porque la cola estaba llena */
+    std::uint64_t obtenerDescartadas() const {
+        return descartadas.load(std::memory_order_relaxed);
+    }
+
+    std::size_t obtenerPendientes() const {
+        return eventos.tamanio();
+    }
+
+private:
+    /// Estado de un sensor; una línea de caché por sensor para que dos
+    /// aplicadores no compartan línea al actualizar modelos vecinos
+    struct alignas(64) ModeloAnomalia {
+        double media;
+        double varianza;
+        double anterior;
+        std::uint32_t observadas;
+        bool preparado;
+        ParametrosAnomalia parametros;
+        char nombre[50];
+
+        ModeloAnomalia() : media(0.0), varianza(0.0), anterior(0.0), observadas(0), preparado(false),
+                           parametros{ 0.0, 0.0, 0, 0.0, 0.0 } {
+            nombre[0] = '\0';
+        }
+    };
+
+    void emitir(const ModeloAnomalia& m, std::uint32_t id, TipoAnomalia tipo, std::int64_t instanteMs,
+                double valor, double referencia, double puntaje) {
+        EventoAnomalia evento;
+        evento.idSensor = id;
+        evento.tipo = tipo;
+        evento.instanteMs = instanteMs;
+        evento.valor = valor;
+        evento.referencia = referencia;
+        evento.puntaje = puntaje;
+        std::memcpy(evento.nombre, m.nombre, sizeof(evento.nombre));
+        detectadas.fetch_add(1, std::memory_order_relaxed);
+        if (!eventos.intentarEncolar(evento)) {
+            descartadas.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    const ParametrosAnomalia predeterminados;
+    std::vector<ModeloAnomalia> modelos;   ///< Identificador -> modelo
+    ColaMPSC<EventoAnomalia> eventos;
+    std::atomic<std::uint64_t> detectadas;
+    std::atomic<std::uint64_t> descartadas;
+};
+
+/**
+ * Hilo consumidor de DetectorAnomalias: cada `periodo` drena la cola y
+ * escribe una línea de alerta por evento en `salida`. La ingesta nunca
+ * lo espera; al detenerse drena lo que quedó.
+ */
+class AlertadorAnomalias {
+public:
+    AlertadorAnomalias(DetectorAnomalias& detectorAnomalias, std::ostream& flujoSalida,
+                       std::chrono::milliseconds periodoDrenado = std::chrono::milliseconds(100))
+        : detector(detectorAnomalias), salida(flujoSalida), periodo(periodoDrenado),
+          activo(false), emitidas(0) {}
+
+    ~AlertadorAnomalias() {
+        detener();
+    }
+
+    AlertadorAnomalias(const AlertadorAnomalias&) = delete;
+    AlertadorAnomalias& operator=(const AlertadorAnomalias&) = delete;
+
+    void iniciar() {
+        std::lock_guard<std::mutex> guardia(candado);
+        if (activo) {
+            return;
+        }
+        activo = true;
+        hilo = std::thread(&AlertadorAnomalias::bucle, this);
+    }
+
+    void detener() {
+        {
+            std::lock_guard<std::mutex> guardia(candado);
+            if (!activo) {
+                return;
+            }
+            activo = false;
+        }
+        despertar.notify_one();
+        hilo.join();
+        drenar();
+    }
+
+    /** Alertas escritas hasta ahora */
+    std::uint64_t obtenerEmitidas() const {
+        return emitidas.load(std::memory_order_relaxed);
+    }
+
+    /** Formato de una alerta (sin salto de línea final) */
+    static void escribir(std::ostream& os, const EventoAnomalia& evento) {
+        os << "[Alerta] Sensor '" << evento.nombre << "': ";
+        if (evento.tipo == TipoAnomalia::Desviacion) {
+            os << "lectura " << evento.valor << " a " << evento.puntaje
+               << " desviaciones de la media móvil " << evento.referencia;
+        } else {
+            os << "salto de " << evento.puntaje << " (de " << evento.referencia
+               << " a " << evento.valor << ")";
+        }
+    }
+
+private:
+    void bucle() {
+        std::unique_lock<std::mutex> guardia(candado);
+        while (activo) {
+            if (despertar.wait_for(guardia, periodo, [this]() { return !activo; })) {
+                break;
+            }
+            guardia.unlock();
+            drenar();
+            guardia.lock();
+        }
+    }
+
+    void drenar() {
+        std::size_t n = detector.drenar([this](const EventoAnomalia& evento) {
+            escribir(salida, evento);
+            salida << '\n';
+        });
+        if (n > 0) {
+            salida.flush();
+            emitidas.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    DetectorAnomalias& detector;
+    std::ostream& salida;
+    const std::chrono::milliseconds periodo;
+
+    std::mutex candado;
+    std::condition_variable despertar;
+    std::thread hilo;
+    bool activo;
+    std::atomic<std::uint64_t> emitidas;
+};
+
+#endif // DETECTOR_ANOMALIAS_HPP
@@ -0,0 +1,575 @@
+#ifndef DIARIO_LECTURAS_HPP
+#define DIARIO_LECTURAS_HPP
+
+#include <iostream>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+
+/**
+ * Cuándo se fuerza a disco lo escrito en el diario (group commit).
+ *
+ * Sin esperarDurable, N y T sólo deciden cuándo se despierta al hilo de
+ * confirmación: son una cota de la frecuencia de fdatasync (a lo sumo uno
+ * cada N lecturas), no de lo que puede perderse. Mientras un fdatasync
+ * está en curso se siguen aceptando lecturas, así que las no confirmadas
+ * pueden llegar a LIMITE_BUFFER bytes (~335 000 lecturas).
+ *
+ * Con esperarDurable (y N > 0), registrar() no retorna mientras haya N o
+ * más lecturas sin confirmar: espera a que la suya esté en disco. Así,
+ * de lo que registrar() ya aceptó, nunca quedan más de N - 1 lecturas sin
+ * sincronizar (con N = 1, cada lectura es durable al retornar).
+ */
+struct PoliticaDiario {
+    std::uint32_t lecturasPorSync;   ///< Sincronizar cada N lecturas (0: no por cantidad)
+    std::uint32_t intervaloMs;       ///< Sincronizar cada T ms con pendientes (0: no por tiempo)
+    bool esperarDurable;             ///< registrar() espera al disco con N sin confirmar
+};
+
+/// Resultado de reproducir un diario existente
+struct ResumenReproduccion {
+    std::uint64_t sensores;          ///< Definiciones de sensor leídas
+    std::uint64_t lecturas;          ///< Lecturas aplicadas
+    std::uint64_t bytesDescartados;  ///< Cola incompleta o corrupta que se truncó
+    std::uint64_t generacion;        ///< Generación del diario leído
+    bool obsoleto;                   ///< Ya incluido en una instantánea: no se aplicó
+};
+
+/**
+ * Diario binario de sólo anexado (write-ahead log) de las lecturas.
+ *
+ * Registros de tamaño fijo o casi fijo, en el orden de bytes del equipo:
+ *  - Sensor:  'S' | id u32 | tipo u8 | historial u8 | capacidad u64 |
+ *             ventanaMs i64 | largo u8 | nombre | suma u32
+ *  - Lectura: 'L' | id u32 | instante i64 (ms) | valor f64 | suma u32 (25 bytes)
+ *  - Proceso: 'P' | id u32 | suma u32 (procesarLectura, que puede quitar lecturas)
+ *  - Generación: 'G' | generación u64 | suma u32 (sólo justo después de la firma)
+ * La suma (FNV-1a del registro) detecta escrituras cortadas por una caída.
+ *
+ * registrar() sólo copia el registro a un buffer en memoria bajo un
+ * candado. Un hilo de confirmación intercambia ese buffer por otro
+ * vacío, lo escribe con una sola llamada y hace fdatasync según la
+ * política (cada N lecturas y/o cada T ms): muchas lecturas comparten un
+ * mismo fsync, así que la durabilidad no limita la velocidad de ingesta.
+ * Si el disco se atrasa más de LIMITE_BUFFER bytes, registrar() espera;
+ * para acotar a N las lecturas no confirmadas, PoliticaDiario::esperarDurable.
+ *
+ * reproducir() debe llamarse antes de registrar nada: recorre el archivo,
+ * entrega cada registro válido al destino y trunca la cola dañada para
+ * que los registros nuevos queden contiguos a los buenos.
+ *
+ * Tras guardar una instantánea (InstantaneaSensores.hpp) con generación
+ * g, reiniciar(g) vacía el diario: lo que queda en él es sólo lo posterior
+ * a la instantánea. Si el proceso cae entre ambos pasos, el diario viejo
+ * tiene una generación menor que la instantánea y reproducir() lo descarta
+ * en vez de aplicar dos veces lecturas que ya están en ella.
+ */
+class DiarioLecturas {
+public:
+    static const std::size_t LIMITE_BUFFER = 8 * 1024 * 1024;
+
+    explicit DiarioLecturas(const char* ruta, PoliticaDiario politicaSync = { 4096, 200, false })
+        : politica(politicaSync), descriptor(-1), pendientes(0), enVuelo(0), secuenciaEscrita(0),
+          secuenciaDurable(0), solicitudSync(false), cerrando(false),
+          lecturasEscritas(0), sincronizaciones(0), falloEscritura(false), generacion(0) {
+        // O_APPEND: toda escritura va al final, aun después de truncar
+        #ifdef _WIN32
+            descriptor = ::_open(ruta, _O_RDWR | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+        #else
+            descriptor = ::open(ruta, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        #endif
+        if (descriptor < 0) {
+            std::cerr << "[Error] No se pudo abrir el diario " << ruta << std::endl;
+            return;
+        }
+        struct stat info;
+        if (::fstat(descriptor, &info) == 0 && info.st_size == 0) {
+            escribirTodo(MAGIA, sizeof(MAGIA));
+        }
+        confirmador = std::thread(&DiarioLecturas::bucleConfirmacion, this);
+    }
+
+    ~DiarioLecturas() {
+        if (descriptor < 0) {
+            return;
+        }
+        sincronizar();
+        detenerConfirmador();
+        cerrar(descriptor);
+    }
+
+    DiarioLecturas(const DiarioLecturas&) = delete;
+    DiarioLecturas& operator=(const DiarioLecturas&) = delete;
+
+    bool estaAbierto() const {
+        return descriptor >= 0;
+    }
+
+    /**
+     * Lee el diario desde el inicio. destino debe ofrecer
+     *   definirSensor(std::uint32_t id, std::uint8_t tipo, std::string_view nombre,
+     *                 std::uint8_t historial, std::uint64_t capacidad, std::int64_t ventanaMs)
+     *   aplicarLectura(std::uint32_t id, std::int64_t instanteMs, double valor)
+     *   aplicarProceso(std::uint32_t id)
+     * Un diario de generación menor que generacionMinima (la de la
+     * instantánea cargada) ya está contenido en ella: no se aplica y se
+     * reinicia con esa generación.
+     */
+    template <typename Destino>
+    ResumenReproduccion reproducir(Destino& destino, std::uint64_t generacionMinima = 0) {
+        ResumenReproduccion resumen = { 0, 0, 0, 0, false };
+        if (descriptor < 0) {
+            return resumen;
+        }
+
+        std::vector<char> contenido;
+        leerTodo(contenido);
+
+        if (contenido.size() < sizeof(MAGIA) || std::memcmp(contenido.data(), MAGIA, sizeof(MAGIA)) != 0) {
+            // No es un diario: no se toca ni se escribe en él
+            std::cerr << "[Error] El archivo no es un diario de lecturas." << std::endl;
+            detenerConfirmador();
+            cerrar(descriptor);
+            descriptor = -1;
+            return resumen;
+        }
+
+        std::size_t pos = sizeof(MAGIA);
+        std::uint64_t leida = 0;
+        if (interpretarGeneracion(contenido.data() + pos, contenido.size() - pos, leida)) {
+            pos += TAMANIO_GENERACION;
+        }
+        generacion = leida;
+        resumen.generacion = leida;
+
+        if (leida < generacionMinima) {
+            resumen.obsoleto = true;
+            reiniciar(generacionMinima);
+            return resumen;
+        }
+
+        while (pos < contenido.size()) {
+            std::size_t largo = interpretarRegistro(contenido.data() + pos, contenido.size() - pos,
+                                                    destino, resumen);
+            if (largo == 0) {
+                break;
+            }
+            pos += largo;
+        }
+
+        resumen.bytesDescartados = contenido.size() - pos;
+        if (resumen.bytesDescartados > 0) {
+            truncar(pos);
+        }
+        return resumen;
+    }
+
+    /**
+     * Vacía el diario y empieza la generación indicada, ya en disco al
+     * retornar. Se usa después de guardar una instantánea con esa misma
+     * generación, sólo si EscritorInstantanea::guardar() retornó true (el
+     * rename ya es durable); no debe haber lecturas registrándose en paralelo.
+     * Los sensores deben volver a definirse (GestorSensores::asignarDiario).
+     */
+    bool reiniciar(std::uint64_t nuevaGeneracion) {
+        if (descriptor < 0) {
+            return false;
+        }
+        sincronizar();
+        std::lock_guard<std::mutex> guardia(mutex);
+        // Todo lo intercambiado ya está durable y el hilo de confirmación
+        // no puede tomar otro lote mientras se tiene el candado
+        activo.clear();
+        pendientes = 0;
+        secuenciaDurable = secuenciaEscrita;
+
+        char registro[TAMANIO_GENERACION];
+        registro[0] = 'G';
+        std::memcpy(registro + 1, &nuevaGeneracion, 8);
+        std::uint32_t suma = resumir(registro, 9);
+        std::memcpy(registro + 9, &suma, 4);
+
+        truncar(0);
+        bool correcto = escribirTodo(MAGIA, sizeof(MAGIA)) &&
+                        escribirTodo(registro, TAMANIO_GENERACION) && sincronizarArchivo();
+        if (!correcto) {
+            falloEscritura = true;
+            std::cerr << "[Error] No se pudo reiniciar el diario de lecturas." << std::endl;
+            return false;
+        }
+        generacion = nuevaGeneracion;
+        definidos.clear();
+        return true;
+    }
+
+    std::uint64_t obtenerGeneracion() const {
+        std::lock_guard<std::mutex> guardia(mutex);
+        return generacion;
+    }
+
+    /**
+     * Anota la definición de un sensor (sólo la primera vez por id), con
+     * lo necesario para recrearlo igual: historial es un
+     * HistorialInstantanea; capacidad y ventanaMs, los de un anillo.
+     */
+    void definirSensor(std::uint32_t id, std::uint8_t tipo, std::string_view nombre,
+                       std::uint8_t historial = 0, std::uint64_t capacidad = 0, std::int64_t ventanaMs = 0) {
+        if (descriptor < 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> guardia(mutex);
+        if (id < definidos.size() && definidos[id]) {
+            return;
+        }
+        marcarDefinido(id);
+
+        std::uint8_t largo = static_cast<std::uint8_t>(nombre.size() > 255 ? 255 : nombre.size());
+        char registro[CABECERA_SENSOR + 255 + 4];
+        std::size_t n = 0;
+        registro[n++] = 'S';
+        std::memcpy(registro + n, &id, 4); n += 4;
+        registro[n++] = static_cast<char>(tipo);
+        registro[n++] = static_cast<char>(historial);
+        std::memcpy(registro + n, &capacidad, 8); n += 8;
+        std::memcpy(registro + n, &ventanaMs, 8); n += 8;
+        registro[n++] = static_cast<char>(largo);
+        std::memcpy(registro + n, nombre.data(), largo); n += largo;
+        std::uint32_t suma = resumir(registro, n);
+        std::memcpy(registro + n, &suma, 4); n += 4;
+        anexar(registro, n, false);
+    }
+
+    /** Agrega una lectura al buffer; el hilo de confirmación la lleva a disco */
+    void registrar(std::uint32_t id, double valor, std::int64_t instanteMs) {
+        if (descriptor < 0) {
+            return;
+        }
+        char registro[TAMANIO_LECTURA];
+        registro[0] = 'L';
+        std::memcpy(registro + 1, &id, 4);
+        std::memcpy(registro + 5, &instanteMs, 8);
+        std::memcpy(registro + 13, &valor, 8);
+        std::uint32_t suma = resumir(registro, 21);
+        std::memcpy(registro + 21, &suma, 4);
+
+        std::unique_lock<std::mutex> candado(mutex);
+        while (activo.size() >= LIMITE_BUFFER && !falloEscritura) {
+            // Buffer lleno: se adelanta la escritura sin esperar el intervalo
+            solicitudSync = true;
+            hayTrabajo.notify_one();
+            hayEspacio.wait(candado);
+        }
+        if (falloEscritura) {
+            return;   // El disco falló: ya se informó y no se acumula más
+        }
+        anexar(registro, TAMANIO_LECTURA, true);
+        if (politica.lecturasPorSync == 0) {
+            return;
+        }
+        if (politica.esperarDurable && pendientes + enVuelo >= politica.lecturasPorSync) {
+            // Ya hay N sin confirmar: ésta no se acepta hasta que esté en disco
+            std::uint64_t objetivo = secuenciaEscrita;
+            solicitudSync = true;   // Aunque el grupo en curso deje menos de N pendientes
+            hayTrabajo.notify_one();
+            confirmado.wait(candado, [&]() { return secuenciaDurable >= objetivo || falloEscritura; });
+        } else if (pendientes >= politica.lecturasPorSync) {
+            candado.unlock();
+            hayTrabajo.notify_one();
+        }
+    }
+
+    /** Anota que el sensor id procesó sus lecturas (p. ej. quitó el mínimo) */
+    void registrarProceso(std::uint32_t id) {
+        if (descriptor < 0) {
+            return;
+        }
+        char registro[TAMANIO_PROCESO];
+        registro[0] = 'P';
+        std::memcpy(registro + 1, &id, 4);
+        std::uint32_t suma = resumir(registro, 5);
+        std::memcpy(registro + 5, &suma, 4);
+
+        std::lock_guard<std::mutex> guardia(mutex);
+        if (!falloEscritura) {
+            anexar(registro, TAMANIO_PROCESO, false);
+        }
+    }
+
+    /** Espera a que todo lo registrado hasta ahora esté en disco */
+    void sincronizar() {
+        if (descriptor < 0) {
+            return;
+        }
+        std::unique_lock<std::mutex> candado(mutex);
+        std::uint64_t objetivo = secuenciaEscrita;
+        if (secuenciaDurable >= objetivo) {
+            return;
+        }
+        solicitudSync = true;
+        hayTrabajo.notify_one();
+        confirmado.wait(candado, [&]() { return secuenciaDurable >= objetivo || falloEscritura; });
+    }
+
+    std::uint64_t obtenerLecturasEscritas() const {
+        std::lock_guard<std::mutex> guardia(mutex);
+        return lecturasEscritas;
+    }
+
+    /** Cantidad de fdatasync realizados (cada uno confirma un grupo) */
+    std::uint64_t obtenerSincronizaciones() const {
+        std::lock_guard<std::mutex> guardia(mutex);
+        return sincronizaciones;
+    }
+
+private:
+    /// "WAL2": el registro 'S' lleva el historial (un diario WAL1 no se lee)
+    static constexpr char MAGIA[8] = { 'S', 'I', 'O', 'T', 'W', 'A', 'L', '2' };
+    static const std::size_t CABECERA_SENSOR = 24;   ///< 'S' hasta largo, inclusive
+    static const std::size_t TAMANIO_LECTURA = 25;
+    static const std::size_t TAMANIO_PROCESO = 9;
+    static const std::size_t TAMANIO_GENERACION = 13;
+
+    static std::uint32_t resumir(const char* datos, std::size_t n) {
+        std::uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i < n; i++) {
+            h ^= static_cast<unsigned char>(datos[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static void cerrar(int fd) {
+        #ifdef _WIN32
+            ::_close(fd);
+        #else
+            ::close(fd);
+        #endif
+    }
+
+    void detenerConfirmador() {
+        {
+            std::lock_guard<std::mutex> guardia(mutex);
+            cerrando = true;
+        }
+        hayTrabajo.notify_one();
+        confirmador.join();
+    }
+
+    /** Debe llamarse con el candado tomado */
+    void anexar(const char* registro, std::size_t n, bool esLectura) {
+        activo.insert(activo.end(), registro, registro + n);
+        secuenciaEscrita++;
+        if (esLectura) {
+            pendientes++;
+        }
+    }
+
+    void marcarDefinido(std::uint32_t id) {
+        if (id >= definidos.size()) {
+            definidos.resize(id + 1, false);
+        }
+        definidos[id] = true;
+    }
+
+    static bool interpretarGeneracion(const char* p, std::size_t disponibles, std::uint64_t& valor) {
+        if (disponibles < TAMANIO_GENERACION || p[0] != 'G') {
+            return false;
+        }
+        std::uint32_t suma;
+        std::memcpy(&suma, p + 9, 4);
+        if (suma != resumir(p, 9)) {
+            return false;
+        }
+        std::memcpy(&valor, p + 1, 8);
+        return true;
+    }
+
+    /** Interpreta un registro; retorna su largo o 0 si está incompleto o dañado */
+    template <typename Destino>
+    std::size_t interpretarRegistro(const char* p, std::size_t disponibles, Destino& destino,
+                                    ResumenReproduccion& resumen) {
+        std::uint32_t id;
+        std::uint32_t suma;
+        if (p[0] == 'L') {
+            if (disponibles < TAMANIO_LECTURA) return 0;
+            std::memcpy(&suma, p + 21, 4);
+            if (suma != resumir(p, 21)) return 0;
+            std::int64_t instante;
+            double valor;
+            std::memcpy(&id, p + 1, 4);
+            std::memcpy(&instante, p + 5, 8);
+            std::memcpy(&valor, p + 13, 8);
+            destino.aplicarLectura(id, instante, valor);
+            resumen.lecturas++;
+            return TAMANIO_LECTURA;
+        }
+        if (p[0] == 'P') {
+            if (disponibles < TAMANIO_PROCESO) return 0;
+            std::memcpy(&suma, p + 5, 4);
+            if (suma != resumir(p, 5)) return 0;
+            std::memcpy(&id, p + 1, 4);
+            destino.aplicarProceso(id);
+            return TAMANIO_PROCESO;
+        }
+        if (p[0] == 'S') {
+            if (disponibles < CABECERA_SENSOR) return 0;
+            std::size_t largo = static_cast<unsigned char>(p[CABECERA_SENSOR - 1]);
+            std::size_t total = CABECERA_SENSOR + largo + 4;
+            if (disponibles < total) return 0;
+            std::memcpy(&suma, p + CABECERA_SENSOR + largo, 4);
+            if (suma != resumir(p, CABECERA_SENSOR + largo)) return 0;
+            std::uint64_t capacidad;
+            std::int64_t ventanaMs;
+            std::memcpy(&id, p + 1, 4);
+            std::memcpy(&capacidad, p + 7, 8);
+            std::memcpy(&ventanaMs, p + 15, 8);
+            destino.definirSensor(id, static_cast<std::uint8_t>(p[5]),
+                                  std::string_view(p + CABECERA_SENSOR, largo),
+                                  static_cast<std::uint8_t>(p[6]), capacidad, ventanaMs);
+            marcarDefinido(id);
+            resumen.sensores++;
+            return total;
+        }
+        return 0;
+    }
+
+    void bucleConfirmacion() {
+        std::vector<char> escritura;
+        std::unique_lock<std::mutex> candado(mutex);
+        while (true) {
+            auto hayQueEscribir = [&]() {
+                return cerrando || solicitudSync ||
+                       (politica.lecturasPorSync > 0 && pendientes >= politica.lecturasPorSync);
+            };
+            if (politica.intervaloMs > 0) {
+                hayTrabajo.wait_for(candado, std::chrono::milliseconds(politica.intervaloMs), hayQueEscribir);
+            } else {
+                hayTrabajo.wait(candado, hayQueEscribir);
+            }
+            if (activo.empty()) {
+                solicitudSync = false;
+                if (cerrando) {
+                    return;
+                }
+                continue;
+            }
+
+            // Intercambio de buffers: los productores siguen anexando
+            // mientras este hilo escribe y sincroniza el grupo anterior
+            escritura.swap(activo);
+            std::uint64_t lote = secuenciaEscrita;
+            std::uint64_t lecturas = pendientes;
+            enVuelo = pendientes;
+            pendientes = 0;
+            solicitudSync = false;
+            candado.unlock();
+            hayEspacio.notify_all();
+
+            bool correcto = escribirTodo(escritura.data(), escritura.size()) && sincronizarArchivo();
+            escritura.clear();
+
+            candado.lock();
+            if (!correcto) {
+                falloEscritura = true;
+                std::cerr << "[Error] Falló la escritura del diario de lecturas." << std::endl;
+            }
+            secuenciaDurable = lote;
+            enVuelo = 0;
+            lecturasEscritas += lecturas;
+            sincronizaciones++;
+            confirmado.notify_all();
+            hayEspacio.notify_all();
+        }
+    }
+
+    bool escribirTodo(const char* datos, std::size_t n) {
+        while (n > 0) {
+            #ifdef _WIN32
+                int escritos = ::_write(descriptor, datos, static_cast<unsigned int>(n));
+            #else
+                ssize_t escritos = ::write(descriptor, datos, n);
+            #endif
+            if (escritos <= 0) {
+                return false;
+            }
+            datos += escritos;
+            n -= static_cast<std::size_t>(escritos);
+        }
+        return true;
+    }
+
+    bool sincronizarArchivo() {
+        #ifdef _WIN32
+            return ::_commit(descriptor) == 0;
+        #elif defined(__APPLE__)
+            return ::fsync(descriptor) == 0;
+        #else
+            return ::fdatasync(descriptor) == 0;
+        #endif
+    }
+
+    void leerTodo(std::vector<char>& contenido) {
+        std::vector<char> bloque(64 * 1024);
+        #ifdef _WIN32
+            ::_lseek(descriptor, 0, SEEK_SET);
+            int n;
+            while ((n = ::_read(descriptor, bloque.data(), static_cast<unsigned int>(bloque.size()))) > 0) {
+        #else
+            ::lseek(descriptor, 0, SEEK_SET);
+            ssize_t n;
+            while ((n = ::read(descriptor, bloque.data(), bloque.size())) > 0) {
+        #endif
+                contenido.insert(contenido.end(), bloque.data(), bloque.data() + n);
+            }
+    }
+
+    void truncar(std::size_t largo) {
+        #ifdef _WIN32
+            ::_chsize_s(descriptor, static_cast<long long>(largo));
+        #else
+            if (::ftruncate(descriptor, static_cast<off_t>(largo)) != 0) {
+                std::cerr << "[Error] No se pudo truncar el diario." << std::endl;
+            }
+        #endif
+    }
+
+    const PoliticaDiario politica;
+    int descriptor;
+
+    mutable std::mutex mutex;
+    std::condition_variable hayTrabajo;   ///< Despierta al hilo de confirmación
+    std::condition_variable confirmado;   ///< Avisa a quien espera en sincronizar()
+    std::condition_variable hayEspacio;   ///< Avisa a productores frenados
+    std::thread confirmador;
+
+    std::vector<char> activo;             ///< Registros aún no entregados al disco
+    std::uint64_t pendientes;             ///< Lecturas en activo
+    std::uint64_t enVuelo;                ///< Lecturas escribiéndose y sincronizándose
+    std::uint64_t secuenciaEscrita;       ///< Registros anexados
+    std::uint64_t secuenciaDurable;       ///< Registros ya sincronizados
+    bool solicitudSync;
+    bool cerrando;
+
+    std::uint64_t lecturasEscritas;
+    std::uint64_t sincronizaciones;
+    bool falloEscritura;
+
+    std::vector<bool> definidos;          ///< Ids con registro 'S' en el diario
+    std::uint64_t generacion;             ///< Instantánea a la que sigue este diario
+};
+
+#endif // DIARIO_LECTURAS_HPP
@@ -0,0 +1,161 @@
+#ifndef ESTADISTICAS_HISTORIAL_HPP
+#define ESTADISTICAS_HISTORIAL_HPP
+
+#include <stdexcept>
+#include <type_traits>
+
+
+/**
+ * Estadísticas de un historial mantenidas de forma incremental.
+ *
+ * Los contenedores de lecturas llaman agregar()/quitar() en cada
+ * inserción o eliminación, de modo que cantidad, suma y promedio
+ * se consultan en O(1). La suma usa un acumulador ancho (long long para
+ * enteros, double compensado de Neumaier para flotantes) para que un
+ * historial largo de int no desborde ni uno de float pierda precisión.
+ *
+ * Mínimo y máximo se mantienen al insertar. Al quitar un valor igual al
+ * extremo, éste deja de ser válido y el contenedor debe volver a fijarlo
+ * (fijarMinimo/fijarMaximo) desde su propio índice o con un recorrido.
+ */
+template <typename T>
+class EstadisticasHistorial {
+public:
+    typedef typename std::conditional<std::is_integral<T>::value,
+                                      long long, double>::type Acumulador;
+
+    EstadisticasHistorial() : minimo(), maximo() {
+        reiniciar();
+    }
+
+    void reiniciar() {
+        cantidad = 0;
+        suma = Acumulador();
+        compensacion = 0.0;
+        minimoValido = false;
+        maximoValido = false;
+    }
+
+    void agregar(const T& valor) {
+        if (cantidad == 0 || valor < minimo) {
+            minimo = valor;
+        }
+        if (cantidad == 0 || maximo < valor) {
+            maximo = valor;
+        }
+        if (cantidad == 0) {
+            minimoValido = true;
+            maximoValido = true;
+        }
+        cantidad++;
+        acumular(valor, 1);
+    }
+
+    void quitar(const T& valor) {
+        cantidad--;
+        acumular(valor, -1);
+        if (cantidad == 0) {
+            reiniciar();
+            return;
+        }
+        if (!(minimo < valor)) {
+            minimoValido = false;
+        }
+        if (!(valor < maximo)) {
+            maximoValido = false;
+        }
+    }
+
+    /** Une las estadísticas de otro historial (p. ej. al empalmar dos
+     *  listas). Un extremo queda válido sólo si lo era en ambos lados.
+     */
+    void combinar(const EstadisticasHistorial& otra) {
+        if (otra.cantidad == 0) {
+            return;
+        }
+        if (cantidad == 0) {
+            *this = otra;
+            return;
+        }
+        if (otra.minimo < minimo) {
+            minimo = otra.minimo;
+        }
+        if (maximo < otra.maximo) {
+            maximo = otra.maximo;
+        }
+        minimoValido = minimoValido && otra.minimoValido;
+        maximoValido = maximoValido && otra.maximoValido;
+        cantidad += otra.cantidad;
+        if constexpr (std::is_integral<T>::value) {
+            suma += otra.suma;
+        } else if constexpr (std::is_arithmetic<T>::value) {
+            double x = otra.suma;
+            double t = suma + x;
+            if ((suma < 0 ? -suma : suma) >= (x < 0 ? -x : x)) {
+                compensacion += (suma - t) + x;
+            } else {
+                compensacion += (x - t) + suma;
+            }
+            suma = t;
+            compensacion += otra.compensacion;
+        }
+    }
+
+    void fijarMinimo(const T& valor) {
+        minimo = valor;
+        minimoValido = true;
+    }
+
+    void fijarMaximo(const T& valor) {
+        maximo = valor;
+        maximoValido = true;
+    }
+
+    long long obtenerCantidad() const { return cantidad; }
+    bool tieneMinimo() const { return minimoValido; }
+    bool tieneMaximo() const { return maximoValido; }
+    const T& obtenerMinimo() const { return minimo; }
+    const T& obtenerMaximo() const { return maximo; }
+
+    /** Suma exacta para enteros; compensada para flotantes */
+    double obtenerSuma() const {
+        return static_cast<double>(suma) + compensacion;
+    }
+
+    double promedio() const {
+        if (cantidad == 0) {
+            throw std::runtime_error("Lista vacía");
+        }
+        return obtenerSuma() / static_cast<double>(cantidad);
+    }
+
+private:
+    void acumular(const T& valor, int signo) {
+        if constexpr (std::is_integral<T>::value) {
+            suma += signo * static_cast<long long>(valor);
+        } else if constexpr (std::is_arithmetic<T>::value) {
+            // Suma compensada de Neumaier: conserva los bits que se pierden
+            double x = signo * static_cast<double>(valor);
+            double t = suma + x;
+            if ((suma < 0 ? -suma : suma) >= (x < 0 ? -x : x)) {
+                compensacion += (suma - t) + x;
+            } else {
+                compensacion += (x - t) + suma;
+            }
+            suma = t;
+        } else {
+            (void)valor;
+            (void)signo;
+        }
+    }
+
+    long long cantidad;     ///< Lecturas vivas
+    Acumulador suma;        ///< Suma acumulada
+    double compensacion;    ///< Error acumulado (sólo flotantes)
+    T minimo;               ///< Menor lectura viva (si minimoValido)
+    T maximo;               ///< Mayor lectura viva (si maximoValido)
+    bool minimoValido;
+    bool maximoValido;
+};
+
+#endif // ESTADISTICAS_HISTORIAL_HPP
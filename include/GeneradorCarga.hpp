@@ -0,0 +1,335 @@
+#ifndef GENERADOR_CARGA_HPP
+#define GENERADOR_CARGA_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Parámetros de GeneradorCarga
+struct ConfiguracionCarga {
+    int puertos;                      ///< Pseudo-terminales a crear
+    int sensoresPorPuerto;            ///< Mitad temperatura, mitad presión
+    double lineasPorSegundo;          ///< Por puerto; 0 = tan rápido como se pueda
+    double fraccionMalformadas;       ///< Probabilidad de que una línea sea inválida
+    std::uint32_t lineasPorRafaga;    ///< Líneas extra de golpe (0 = sin ráfagas)
+    std::uint32_t periodoRafagaMs;    ///< Cada cuánto llega una ráfaga
+    std::uint64_t lineasPorPuerto;    ///< 0 = hasta detener()
+    std::uint32_t sondaCada;          ///< Cada N líneas una sonda de latencia (0 = no)
+    std::uint32_t semilla;
+
+    ConfiguracionCarga()
+        : puertos(1), sensoresPorPuerto(2), lineasPorSegundo(100.0), fraccionMalformadas(0.0),
+          lineasPorRafaga(0), periodoRafagaMs(1000), lineasPorPuerto(0), sondaCada(0), semilla(1) {}
+};
+
+/**
+ * Generador de carga que reemplaza al ESP32 con sensor.ino (sólo Linux).
+ *
+ * Crea pseudo-terminales en modo crudo y, por cada una, un hilo que
+ * escribe en el extremo maestro el mismo formato "ID:valor\r\n" que
+ * sensor.ino: temperaturas 20-40 °C con dos decimales y presiones enteras
+ * 95-104 kPa, con varios IDs por puerto (TEMP<p>_<k>, PRES<p>_<k>). El
+ * extremo esclavo (obtenerRutaPuerto) se abre como cualquier puerto serie
+ * desde ComunicacionSerial, MotorIngesta o ServicioMultipuerto.
+ *
+ * El ritmo se controla por puerto contra el reloj (sin acumular error);
+ * con lineasPorSegundo = 0 se escribe hasta saturar al lector, que frena
+ * al generador cuando se llena el buffer del pty. Opcionalmente se
+ * mezclan líneas malformadas de varias clases y ráfagas periódicas.
+ *
+ * Las sondas "LAT<p>:<µs>" llevan como valor CLOCK_MONOTONIC en µs al
+ * momento de escribir; quien las reciba calcula la latencia de extremo a
+ * extremo con relojMonotonoUs() (el reloj es común a todo el equipo).
+ */
+class GeneradorCarga {
+public:
+    explicit GeneradorCarga(const ConfiguracionCarga& configuracion)
+        : config(configuracion), deteniendo(false) {}
+
+    ~GeneradorCarga() {
+        detener();
+        for (std::unique_ptr<Puerto>& p : puertos) {
+            if (p->maestro >= 0) ::close(p->maestro);
+            if (p->esclavo >= 0) ::close(p->esclavo);
+        }
+    }
+
+    GeneradorCarga(const GeneradorCarga&) = delete;
+    GeneradorCarga& operator=(const GeneradorCarga&) = delete;
+
+    /** Crea las pseudo-terminales; retorna false si alguna falló */
+    bool crearPuertos() {
+        for (int i = 0; i < config.puertos; i++) {
+            std::unique_ptr<Puerto> p(new Puerto());
+            termios modo;
+            std::memset(&modo, 0, sizeof(modo));
+            ::cfmakeraw(&modo);   // Sin eco ni edición de línea
+            char ruta[128];
+            if (::openpty(&p->maestro, &p->esclavo, ruta, &modo, nullptr) != 0) {
+                std::cerr << "[Error] openpty falló" << std::endl;
+                return false;
+            }
+            ::fcntl(p->maestro, F_SETFL, ::fcntl(p->maestro, F_GETFL) | O_NONBLOCK);
+            // El esclavo queda abierto: si el consumidor cierra y reabre el
+            // puerto, el pty no se cuelga
+            p->ruta = ruta;
+            puertos.push_back(std::move(p));
+        }
+        return true;
+    }
+
+    int obtenerCantidadPuertos() const {
+        return static_cast<int>(puertos.size());
+    }
+
+    const char* obtenerRutaPuerto(int i) const {
+        return puertos[i]->ruta.c_str();
+    }
+
+    /** Nombre del sensor k del puerto p (el que el receptor debe registrar) */
+    static std::string nombreSensor(int puerto, int sensor) {
+        char nombre[32];
+        std::snprintf(nombre, sizeof(nombre), "%s%d_%d", (sensor % 2 == 0) ? "TEMP" : "PRES", puerto, sensor);
+        return nombre;
+    }
+
+    static std::string nombreSonda(int puerto) {
+        return "LAT" + std::to_string(puerto);
+    }
+
+    static bool esTemperatura(int sensor) {
+        return sensor % 2 == 0;
+    }
+
+    /** CLOCK_MONOTONIC en microsegundos (mismo reloj que las sondas) */
+    static std::int64_t relojMonotonoUs() {
+        timespec ts;
+        ::clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<std::int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    void iniciar() {
+        deteniendo.store(false);
+        for (std::size_t i = 0; i < puertos.size(); i++) {
+            hilos.emplace_back(&GeneradorCarga::bucleEmision, this, static_cast<int>(i));
+        }
+    }
+
+    /** Espera a que cada puerto envíe sus lineasPorPuerto */
+    void esperar() {
+        for (std::thread& h : hilos) {
+            h.join();
+        }
+        hilos.clear();
+    }
+
+    void detener() {
+        deteniendo.store(true);
+        esperar();
+    }
+
+    std::uint64_t obtenerLineasEnviadas() const { return sumar(&Puerto::lineas); }
+    std::uint64_t obtenerMalformadasEnviadas() const { return sumar(&Puerto::malformadas); }
+    std::uint64_t obtenerSondasEnviadas() const { return sumar(&Puerto::sondas); }
+    std::uint64_t obtenerBytesEnviados() const { return sumar(&Puerto::bytes); }
+    std::uint64_t obtenerRafagas() const { return sumar(&Puerto::rafagas); }
+
+private:
+    struct Puerto {
+        int maestro;
+        int esclavo;
+        std::string ruta;
+        std::atomic<std::uint64_t> lineas;        ///< Todas, incluidas malformadas y sondas
+        std::atomic<std::uint64_t> malformadas;
+        std::atomic<std::uint64_t> sondas;
+        std::atomic<std::uint64_t> bytes;
+        std::atomic<std::uint64_t> rafagas;
+
+        Puerto() : maestro(-1), esclavo(-1), lineas(0), malformadas(0), sondas(0), bytes(0), rafagas(0) {}
+    };
+
+    std::uint64_t sumar(std::atomic<std::uint64_t> Puerto::* campo) const {
+        std::uint64_t total = 0;
+        for (const std::unique_ptr<Puerto>& p : puertos) {
+            total += ((*p).*campo).load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /** xorshift32: barato y reproducible con la semilla */
+    static std::uint32_t azar(std::uint32_t& estado) {
+        estado ^= estado << 13;
+        estado ^= estado >> 17;
+        estado ^= estado << 5;
+        return estado;
+    }
+
+    /** Agrega una línea válida del sensor k con el patrón de sensor.ino */
+    void lineaValida(std::string& bloque, int puerto, int sensor, std::uint64_t ciclo, std::uint32_t& estado) {
+        char linea[64];
+        int n;
+        if (esTemperatura(sensor)) {
+            unsigned centesimas = azar(estado) % 100;
+            n = std::snprintf(linea, sizeof(linea), "TEMP%d_%d:%u.%02u\r\n", puerto, sensor,
+                              20u + static_cast<unsigned>(ciclo % 20), centesimas);
+        } else {
+            n = std::snprintf(linea, sizeof(linea), "PRES%d_%d:%u\r\n", puerto, sensor,
+                              95u + static_cast<unsigned>(ciclo % 10));
+        }
+        bloque.append(linea, static_cast<std::size_t>(n));
+    }
+
+    /** Clases de línea que ParserLecturas debe rechazar */
+    void lineaMalformada(std::string& bloque, int puerto, std::uint32_t& estado) {
+        switch (azar(estado) % 6) {
+            case 0: bloque += "TEMP" + std::to_string(puerto) + "_0 25.5\r\n"; break;      // sin ':'
+            case 1: bloque += "PRES" + std::to_string(puerto) + "_1:\r\n"; break;          // sin valor
+            case 2: bloque += "TEMP" + std::to_string(puerto) + "_0:abc\r\n"; break;       // no numérico
+            case 3: bloque += ":25.5\r\n"; break;                                          // sin ID
+            case 4: bloque += std::string(60, 'X') + ":1\r\n"; break;                      // ID largo
+            default: bloque += "TEMP" + std::to_string(puerto) + "_0:12.5xyz\r\n"; break;  // basura final
+        }
+    }
+
+    /** Arma n líneas; suma a malformadas y sondas las que lo fueron */
+    void armarBloque(std::string& bloque, int puerto, std::uint64_t n, std::uint64_t& enviadas,
+                     std::uint32_t& estado, std::uint64_t& malformadas, std::uint64_t& sondas) {
+        const int sensores = (config.sensoresPorPuerto < 1) ? 1 : config.sensoresPorPuerto;
+        const std::uint32_t umbral = static_cast<std::uint32_t>(config.fraccionMalformadas * 4294967295.0);
+        for (std::uint64_t i = 0; i < n; i++, enviadas++) {
+            if (config.sondaCada > 0 && enviadas % config.sondaCada == 0) {
+                bloque += "LAT" + std::to_string(puerto) + ":" + std::to_string(relojMonotonoUs()) + "\r\n";
+                sondas++;
+            } else if (umbral > 0 && azar(estado) < umbral) {
+                lineaMalformada(bloque, puerto, estado);
+                malformadas++;
+            } else {
+                int sensor = static_cast<int>(enviadas % static_cast<std::uint64_t>(sensores));
+                lineaValida(bloque, puerto, sensor, enviadas / static_cast<std::uint64_t>(sensores), estado);
+            }
+        }
+    }
+
+    /**
+     * Escribe el bloque y retorna cuántos bytes salieron. Al pedirse detener
+     * se da un segundo de gracia para que el lector vacíe el pty; si no lo
+     * hace, el bloque queda a medias.
+     */
+    std::size_t escribir(Puerto& p, const std::string& bloque) {
+        std::size_t escritos = 0;
+        std::int64_t limiteGracia = 0;
+        while (escritos < bloque.size()) {
+            ssize_t n = ::write(p.maestro, bloque.data() + escritos, bloque.size() - escritos);
+            if (n > 0) {
+                escritos += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                break;
+            }
+            // Buffer del pty lleno: el lector no da abasto (saturación)
+            if (deteniendo.load(std::memory_order_relaxed)) {
+                std::int64_t ahora = relojMonotonoUs();
+                if (limiteGracia == 0) {
+                    limiteGracia = ahora + 1000000;
+                } else if (ahora >= limiteGracia) {
+                    break;
+                }
+            }
+            pollfd espera = { p.maestro, POLLOUT, 0 };
+            ::poll(&espera, 1, 50);
+        }
+        p.bytes.fetch_add(escritos, std::memory_order_relaxed);
+        return escritos;
+    }
+
+    void bucleEmision(int puerto) {
+        typedef std::chrono::steady_clock Reloj;
+        Puerto& p = *puertos[puerto];
+        std::uint32_t estado = config.semilla * 2654435761u + static_cast<std::uint32_t>(puerto) + 1u;
+        if (estado == 0) estado = 1;
+
+        const std::uint64_t limite = config.lineasPorPuerto;
+        const Reloj::time_point inicio = Reloj::now();
+        Reloj::time_point proximaRafaga = inicio + std::chrono::milliseconds(config.periodoRafagaMs);
+        std::uint64_t enviadas = 0;        // Líneas escritas (define el patrón)
+        std::uint64_t ritmo = 0;           // Líneas a ritmo, sin contar ráfagas
+        std::string bloque;
+
+        while (!deteniendo.load(std::memory_order_relaxed) && (limite == 0 || enviadas < limite)) {
+            Reloj::time_point ahora = Reloj::now();
+            std::uint64_t n;
+            if (config.lineasPorSegundo > 0.0) {
+                double transcurrido = std::chrono::duration<double>(ahora - inicio).count();
+                std::uint64_t debidas = static_cast<std::uint64_t>(transcurrido * config.lineasPorSegundo);
+                n = (debidas > ritmo) ? debidas - ritmo : 0;
+                if (n > 4096) n = 4096;
+                ritmo += n;
+            } else {
+                n = 512;
+            }
+
+            std::uint64_t extra = 0;
+            if (config.lineasPorRafaga > 0 && ahora >= proximaRafaga) {
+                extra = config.lineasPorRafaga;
+                proximaRafaga += std::chrono::milliseconds(config.periodoRafagaMs);
+                p.rafagas.fetch_add(1, std::memory_order_relaxed);
+            }
+            n += extra;
+            if (limite > 0 && n > limite - enviadas) {
+                n = limite - enviadas;
+            }
+
+            if (n == 0) {
+                // Dormir hasta que toque la próxima línea (o la ráfaga)
+                double siguiente = static_cast<double>(ritmo + 1) / config.lineasPorSegundo;
+                Reloj::time_point despertar = inicio + std::chrono::duration_cast<Reloj::duration>(
+                    std::chrono::duration<double>(siguiente));
+                if (config.lineasPorRafaga > 0 && proximaRafaga < despertar) {
+                    despertar = proximaRafaga;
+                }
+                std::this_thread::sleep_until(despertar);
+                continue;
+            }
+
+            bloque.clear();
+            std::uint64_t malformadas = 0;
+            std::uint64_t sondas = 0;
+            armarBloque(bloque, puerto, n, enviadas, estado, malformadas, sondas);
+            std::size_t escritos = escribir(p, bloque);
+            if (escritos < bloque.size()) {
+                // Sólo cuentan las líneas completas que llegaron al pty
+                std::uint64_t completas = static_cast<std::uint64_t>(
+                    std::count(bloque.begin(), bloque.begin() + static_cast<std::ptrdiff_t>(escritos), '\n'));
+                p.lineas.fetch_add(completas, std::memory_order_relaxed);
+                break;
+            }
+            p.lineas.fetch_add(n, std::memory_order_relaxed);
+            p.malformadas.fetch_add(malformadas, std::memory_order_relaxed);
+            p.sondas.fetch_add(sondas, std::memory_order_relaxed);
+        }
+    }
+
+    const ConfiguracionCarga config;
+    std::vector<std::unique_ptr<Puerto> > puertos;
+    std::vector<std::thread> hilos;
+    std::atomic<bool> deteniendo;
+};
+
+#endif // GENERADOR_CARGA_HPP
@@ -2,107 +2,426 @@
 #define GESTOR_SENSORES_HPP
 
 #include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
 #include "SensorBase.hpp"
+#include "Bitacora.hpp"
+#include "DetectorAnomalias.hpp"
+#include "DiarioLecturas.hpp"
+#include "InstantaneaSensores.hpp"
+#include "InternadorNombres.hpp"
+#include "MetricasSistema.hpp"
+#include "PoolTrabajo.hpp"
 
 // Nodo para la lista polimórfica de sensores
 struct NodoSensor {
-    SensorBase* sensor;      ///< Puntero a sensor (polimórfico)
-    NodoSensor* siguiente;   ///< Puntero al siguiente nodo
+    std::unique_ptr<SensorBase> sensor;  ///< Sensor (polimórfico) del que el nodo es dueño
+    NodoSensor* siguiente;               ///< Puntero al siguiente nodo
 
     /**
      *  Constructor del nodo
-     * s Puntero a un SensorBase
+     * s Sensor cuya propiedad pasa al nodo
      */
-    NodoSensor(SensorBase* s) : sensor(s), siguiente(nullptr) {}
+    explicit NodoSensor(std::unique_ptr<SensorBase> s) : sensor(std::move(s)), siguiente(nullptr) {}
+};
+
+/// Lectura ya resuelta a su identificador, pendiente de registrar en lote
+struct LecturaPorId {
+    std::uint32_t idSensor;
+    double valor;
 };
 
 /**
  *  Gestor polimórfico de sensores
  * 
  * Gestiona una lista de sensores de diferentes tipos de forma
- * polimórfica. Implementa la Regla de los Tres/Cinco.
+ * polimórfica. Implementa la Regla de los Cinco: cada nodo es dueño de
+ * su sensor (std::unique_ptr), la copia clona los sensores y el
+ * movimiento traspasa la lista, el índice y los arreglos en O(1).
+ *
+ * Además de la lista mantiene un índice hash (InternadorNombres) que
+ * asigna a cada nombre un identificador compacto, y un arreglo
+ * identificador -> sensor. buscarSensor cuesta O(1) esperado y la ruta
+ * de ingesta puede resolver el nombre una vez y usar el identificador.
  */
 class GestorSensores {
 private:
     NodoSensor* cabeza;     ///< Puntero al primer sensor
+    NodoSensor* cola;       ///< Puntero al último sensor (anexado O(1))
     int cantidad;           ///< Cantidad de sensores
 
+    InternadorNombres ids;          ///< Nombre -> identificador compacto
+    SensorBase** porId;             ///< Identificador -> sensor
+    std::uint32_t capacidadPorId;   ///< Tamaño reservado de porId
+
+    DiarioLecturas* diario;         ///< Diario de lecturas (opcional, no propio)
+    DetectorAnomalias* detector;    ///< Detección de anomalías (opcional, no propio)
+    RegistroMetricas* metricas;     ///< Registro de métricas (opcional, no propio)
+    MetricasSensor** metricasPorId; ///< Identificador -> ranura en metricas
+
 public:
     /** Constructor por defecto
      */
-    GestorSensores() : cabeza(nullptr), cantidad(0) {}
+    GestorSensores() : cabeza(nullptr), cola(nullptr), cantidad(0),
+                       porId(nullptr), capacidadPorId(0), diario(nullptr), detector(nullptr),
+                       metricas(nullptr), metricasPorId(nullptr) {}
 
     /** Destructor - Libera todos los sensores*/
     ~GestorSensores() {
         limpiar();
+        delete[] porId;
+        delete[] metricasPorId;
     }
 
-    /** Constructor de copia (Regla de los Tres)  otro Referencia a otro GestorSensores
+    /** Constructor de copia  otro Referencia a otro GestorSensores
+     *
+     * Clona cada sensor con su tipo concreto (SensorBase::clonar) en el
+     * mismo orden, así que los ids también coinciden. La copia no anota
+     * en el diario, el detector ni las métricas del original.
      */
-    GestorSensores(const GestorSensores& otro) : cabeza(nullptr), cantidad(0) {
-        // Copiar sensores (nota: esto requeriría métodos de clonación)
-        std::cout << "[Advertencia] Constructor de copia no completamente implementado." << std::endl;
+    GestorSensores(const GestorSensores& otro)
+        : cabeza(nullptr), cola(nullptr), cantidad(0), porId(nullptr), capacidadPorId(0),
+          diario(nullptr), detector(nullptr), metricas(nullptr), metricasPorId(nullptr) {
+        copiarDesde(otro);
     }
 
 
+    /** Asignación por copia: como en el constructor de copia, los sensores
+     *  clonados no se anotan en el diario, así que el destino lo suelta
+     *  (sus ids vuelven a empezar y el historial clonado no está en él).
+     *  Para volver a anotar, guardarPuntoControl() escribe la instantánea
+     *  y reinicia el diario antes de asignarlo otra vez.
+     */
     GestorSensores& operator=(const GestorSensores& otro) {
         if (this != &otro) {
             limpiar();
+            diario = nullptr;
+            copiarDesde(otro);
+        }
+        return *this;
+    }
+
+    /** Constructor de movimiento: traspasa sensores, índice, diario,
+     *  detector y métricas sin clonar nada; el origen queda vacío
+     */
+    GestorSensores(GestorSensores&& otro) noexcept
+        : cabeza(nullptr), cola(nullptr), cantidad(0), porId(nullptr), capacidadPorId(0),
+          diario(nullptr), detector(nullptr), metricas(nullptr), metricasPorId(nullptr) {
+        intercambiar(otro);
+    }
+
+    GestorSensores& operator=(GestorSensores&& otro) noexcept {
+        if (this != &otro) {
+            limpiar();
+            diario = nullptr;     // El origen no hereda nuestro diario, detector ni métricas
+            detector = nullptr;
+            metricas = nullptr;
+            intercambiar(otro);
         }
         return *this;
     }
 
- 
+    void intercambiar(GestorSensores& otro) noexcept {
+        std::swap(cabeza, otro.cabeza);
+        std::swap(cola, otro.cola);
+        std::swap(cantidad, otro.cantidad);
+        ids.intercambiar(otro.ids);
+        std::swap(porId, otro.porId);
+        std::swap(capacidadPorId, otro.capacidadPorId);
+        std::swap(diario, otro.diario);
+        std::swap(detector, otro.detector);
+        std::swap(metricas, otro.metricas);
+        std::swap(metricasPorId, otro.metricasPorId);
+    }
+
+    /** Toma la propiedad de un sensor creado con new (interfaz original) */
     void agregarSensor(SensorBase* sensor) {
-        if (sensor == nullptr) {
+        agregarSensor(std::unique_ptr<SensorBase>(sensor));
+    }
+
+    void agregarSensor(std::unique_ptr<SensorBase> propio) {
+        if (propio == nullptr) {
             std::cout << "[Error] Intento de agregar sensor nulo." << std::endl;
             return;
         }
 
-        NodoSensor* nuevoNodo = new NodoSensor(sensor);
-        
-        if (cabeza == nullptr) {
+        SensorBase* sensor = propio.get();
+        NodoSensor* nuevoNodo = new NodoSensor(std::move(propio));
+
+        if (cola == nullptr) {
             cabeza = nuevoNodo;
         } else {
-            NodoSensor* actual = cabeza;
-            while (actual->siguiente != nullptr) {
-                actual = actual->siguiente;
-            }
-            actual->siguiente = nuevoNodo;
+            cola->siguiente = nuevoNodo;
         }
+        cola = nuevoNodo;
         cantidad++;
-        std::cout << "[Log] Sensor '" << sensor->obtenerNombre() 
-                  << "' insertado en la lista de gestión." << std::endl;
+        std::int32_t id = indexar(sensor);
+        if (diario != nullptr && id >= 0) {
+            definirEnDiario(static_cast<std::uint32_t>(id));
+        }
+        if (detector != nullptr && id >= 0) {
+            detector->prepararSensor(static_cast<std::uint32_t>(id), sensor->obtenerNombre());
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Sensor '" << sensor->obtenerNombre()
+               << "' insertado en la lista de gestión.";
+        });
     }
 
 
-    SensorBase* buscarSensor(const char* nombre) {
-        NodoSensor* actual = cabeza;
-        while (actual != nullptr) {
-            if (std::strcmp(actual->sensor->obtenerNombre(), nombre) == 0) {
-                return actual->sensor;
+    /** Construye un sensor S con args y lo agrega; retorna el sensor (el
+     *  gestor sigue siendo su dueño)
+     */
+    template <typename S, typename... Args>
+    S* emplazarSensor(Args&&... args) {
+        std::unique_ptr<S> sensor(new S(std::forward<Args>(args)...));
+        S* crudo = sensor.get();
+        agregarSensor(std::unique_ptr<SensorBase>(std::move(sensor)));
+        return crudo;
+    }
+
+    /** Busca por nombre en O(1) esperado; con nombres repetidos
+     *  devuelve el primero que se agregó
+     */
+    SensorBase* buscarSensor(std::string_view nombre) {
+        std::int32_t id = ids.buscar(nombre);
+        return (id == InternadorNombres::NO_ENCONTRADO) ? nullptr : porId[id];
+    }
+
+    /** Identificador compacto del sensor, o -1 si no existe */
+    std::int32_t obtenerIdSensor(std::string_view nombre) const {
+        return ids.buscar(nombre);
+    }
+
+    /** Sensor asociado a un identificador obtenido con obtenerIdSensor */
+    SensorBase* sensorPorId(std::uint32_t id) {
+        return (id < ids.obtenerCantidad()) ? porId[id] : nullptr;
+    }
+
+    /**
+     * Registra una lectura aceptada en el sensor del identificador; si hay
+     * diario la anota con su instante y si hay detector la evalúa. Retorna
+     * false si el id no existe.
+     */
+    bool registrarLectura(std::uint32_t id, double valor) {
+        SensorBase* sensor = sensorPorId(id);
+        if (sensor == nullptr) {
+            return false;
+        }
+        std::uint32_t anomalias = 0;
+        if (diario != nullptr || detector != nullptr) {
+            std::int64_t instante = AgregadosTemporales::ahoraMilisegundos();
+            if (diario != nullptr) {
+                diario->registrar(id, valor, instante);
+            }
+            sensor->registrarLecturaEn(valor, instante);
+            if (detector != nullptr) {
+                anomalias = detector->evaluar(id, valor, instante);
+            }
+        } else {
+            sensor->registrarLectura(valor);
+        }
+        if (metricas != nullptr && metricasPorId[id] != nullptr) {
+            sumarUnEscritor(metricasPorId[id]->aceptadas, 1);
+            if (anomalias > 0) {
+                sumarUnEscritor(metricasPorId[id]->anomalias, anomalias);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Registra n lecturas del mismo sensor con un solo instante: una
+     * llamada virtual por lote (SensorBase::registrarLecturasEn). Con
+     * diario, cada lectura se anota igual que en registrarLectura.
+     */
+    bool registrarLecturas(std::uint32_t id, const double* valores, std::size_t n) {
+        SensorBase* sensor = sensorPorId(id);
+        if (sensor == nullptr) {
+            return false;
+        }
+        if (n == 0) {
+            return true;
+        }
+        std::int64_t instante = AgregadosTemporales::ahoraMilisegundos();
+        if (diario != nullptr) {
+            for (std::size_t i = 0; i < n; i++) {
+                diario->registrar(id, valores[i], instante);
+            }
+        }
+        sensor->registrarLecturasEn(valores, n, instante);
+        std::uint32_t anomalias = 0;
+        if (detector != nullptr) {
+            anomalias = detector->evaluarVarios(id, valores, n, instante);
+        }
+        if (metricas != nullptr && metricasPorId[id] != nullptr) {
+            sumarUnEscritor(metricasPorId[id]->aceptadas, n);
+            if (anomalias > 0) {
+                sumarUnEscritor(metricasPorId[id]->anomalias, anomalias);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Registra un ciclo de lecturas de varios sensores: las agrupa por id
+     * (orden estable, así cada sensor las recibe en su orden de llegada)
+     * y entrega a cada sensor su tramo con registrarLecturas. Reordena el
+     * arreglo. Retorna cuántas se registraron (las de ids válidos).
+     */
+    std::size_t registrarAgrupadas(LecturaPorId* lecturas, std::size_t n) {
+        std::stable_sort(lecturas, lecturas + n, [](const LecturaPorId& a, const LecturaPorId& b) {
+            return a.idSensor < b.idSensor;
+        });
+        static const std::size_t TRAMO = 256;
+        double valores[TRAMO];
+        std::size_t registradas = 0;
+        std::size_t i = 0;
+        while (i < n) {
+            std::uint32_t id = lecturas[i].idSensor;
+            std::size_t m = 0;
+            while (i < n && lecturas[i].idSensor == id && m < TRAMO) {
+                valores[m++] = lecturas[i++].valor;
+            }
+            if (registrarLecturas(id, valores, m)) {
+                registradas += m;
             }
-            actual = actual->siguiente;
         }
-        return nullptr;
+        return registradas;
     }
 
+    /** Cuenta una línea dirigida al sensor `nombre` que no se pudo
+     *  interpretar (sólo con métricas; puede llamarse desde varios hilos)
+     */
+    void contarRechazada(std::string_view nombre) {
+        if (metricas == nullptr) {
+            return;
+        }
+        std::int32_t id = ids.buscar(nombre);
+        if (id >= 0 && metricasPorId[id] != nullptr) {
+            metricasPorId[id]->rechazadas.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
 
-    void procesarTodosSensores() {
+    /**
+     * Desde ahora cuenta lecturas aceptadas y rechazadas por sensor y mide
+     * procesarLectura en el registro. Igual que el diario, debe asignarse
+     * antes de iniciar la ingesta concurrente.
+     */
+    void asignarMetricas(RegistroMetricas* registro) {
+        metricas = registro;
+        if (metricas == nullptr) {
+            return;
+        }
+        for (std::uint32_t id = 0; id < ids.obtenerCantidad(); id++) {
+            metricasPorId[id] = metricas->sensor(porId[id]->obtenerNombre());
+        }
+    }
+
+    RegistroMetricas* obtenerMetricas() const {
+        return metricas;
+    }
+
+    /**
+     * Desde ahora cada lectura aceptada se anota en el diario. Los
+     * sensores ya registrados se definen en él (los que vinieron de una
+     * reproducción del mismo diario ya lo están y no se repiten).
+     */
+    void asignarDiario(DiarioLecturas* nuevoDiario) {
+        diario = nuevoDiario;
+        if (diario == nullptr) {
+            return;
+        }
+        for (std::uint32_t id = 0; id < ids.obtenerCantidad(); id++) {
+            definirEnDiario(id);
+        }
+    }
+
+    /**
+     * Desde ahora cada lectura aceptada se evalúa en el detector, que
+     * encola las anomalías sin bloquear la ingesta. Los sensores ya
+     * registrados reciben un modelo con los parámetros predeterminados.
+     * Debe asignarse antes de iniciar la ingesta concurrente.
+     */
+    void asignarDetector(DetectorAnomalias* nuevoDetector) {
+        detector = nuevoDetector;
+        if (detector == nullptr) {
+            return;
+        }
+        for (std::uint32_t id = 0; id < ids.obtenerCantidad(); id++) {
+            detector->prepararSensor(id, porId[id]->obtenerNombre());
+        }
+    }
+
+    DetectorAnomalias* obtenerDetector() const {
+        return detector;
+    }
+
+    /** Cantidad de identificadores asignados (ids válidos: [0, n)) */
+    std::uint32_t obtenerCantidadIds() const {
+        return ids.obtenerCantidad();
+    }
+
+
+    void procesarTodosSensores(std::ostream& salida = std::cout) {
         if (cabeza == nullptr) {
-            std::cout << "[Advertencia] No hay sensores registrados." << std::endl;
+            salida << "[Advertencia] No hay sensores registrados." << std::endl;
             return;
         }
 
-        std::cout << "\n--- Ejecutando Polimorfismo ---" << std::endl;
-        
+        salida << "\n--- Ejecutando Polimorfismo ---" << std::endl;
+
+        // La bitácora va al mismo flujo que la salida, igual que en paralelo
+        RedireccionBitacora redireccion(salida);
         NodoSensor* actual = cabeza;
         while (actual != nullptr) {
-            actual->sensor->procesarLectura();
+            anotarProceso(actual->sensor.get());
+            procesarMedido(actual->sensor.get(), salida);
             actual = actual->siguiente;
         }
     }
 
+    /**
+     * Igual que procesarTodosSensores(), pero reparte los sensores entre
+     * los hilos del pool. La salida de cada sensor (incluida su bitácora)
+     * se acumula aparte y se emite al final en el orden de la lista, así
+     * que el texto es idéntico al del recorrido secuencial.
+     */
+    void procesarTodosSensores(PoolTrabajo& pool, std::ostream& salida = std::cout) {
+        if (cabeza == nullptr) {
+            salida << "[Advertencia] No hay sensores registrados." << std::endl;
+            return;
+        }
+
+        salida << "\n--- Ejecutando Polimorfismo ---" << std::endl;
+
+        std::vector<SensorBase*> sensores;
+        sensores.reserve(static_cast<std::size_t>(cantidad));
+        for (NodoSensor* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            anotarProceso(actual->sensor.get());
+            sensores.push_back(actual->sensor.get());
+        }
+
+        std::vector<std::string> resultados(sensores.size());
+        pool.paraCada(sensores.size(), [&](std::size_t i, int) {
+            std::ostringstream texto;
+            RedireccionBitacora redireccion(texto);
+            procesarMedido(sensores[i], texto);
+            resultados[i] = texto.str();
+        });
+
+        for (const std::string& texto : resultados) {
+            salida << texto;
+        }
+        salida.flush();
+    }
+
 
     void imprimirTodosSensores() const {
         if (cabeza == nullptr) {
@@ -126,6 +445,35 @@ public:
         return cantidad;
     }
 
+    /** Vuelca todos los sensores, en el orden de la lista, a una instantánea */
+    void volcarInstantanea(EscritorInstantanea& escritor) const {
+        for (NodoSensor* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            actual->sensor->serializar(escritor);
+        }
+    }
+
+    /** Percentiles conjuntos de todos los sensores de un tipo: combina sus
+     *  bocetos (los de los últimos `ultimos`, o todos si es cero). Incluyen
+     *  las lecturas ya eliminadas de los historiales
+     */
+    BocetoCuantiles cuantilesPorTipo(TipoSensor tipo,
+                                     CuantilesTemporales::Reloj::duration ultimos =
+                                         CuantilesTemporales::Reloj::duration::zero()) const {
+        BocetoCuantiles resultado;
+        for (NodoSensor* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            const CuantilesTemporales* cuantiles = actual->sensor->obtenerCuantiles();
+            if (cuantiles == nullptr || actual->sensor->obtenerTipo() != tipo) {
+                continue;
+            }
+            if (ultimos == CuantilesTemporales::Reloj::duration::zero()) {
+                resultado.combinar(cuantiles->consultarTodo());
+            } else {
+                resultado.combinar(cuantiles->consultarUltimos(ultimos));
+            }
+        }
+        return resultado;
+    }
+
 
     bool estaVacio() const {
         return cabeza == nullptr;
@@ -133,22 +481,97 @@ public:
 
 private:
 
+    /** procesarLectura con su duración en el histograma de métricas */
+    void procesarMedido(SensorBase* sensor, std::ostream& salida) {
+        if (metricas == nullptr) {
+            sensor->procesarLectura(salida);
+            return;
+        }
+        std::int64_t inicio = relojMetricasNs();
+        sensor->procesarLectura(salida);
+        metricas->duracionProcesamiento().registrar(relojMetricasNs() - inicio);
+    }
+
+    /** Define el sensor id en el diario con su tipo e historial, para que
+     *  la reproducción lo recree igual aunque no esté en la instantánea
+     */
+    void definirEnDiario(std::uint32_t id) {
+        FichaInstantanea ficha;
+        std::memset(&ficha, 0, sizeof(ficha));
+        porId[id]->describirHistorial(ficha);
+        diario->definirSensor(id, static_cast<std::uint8_t>(porId[id]->obtenerTipo()),
+                              porId[id]->obtenerNombre(), ficha.historial, ficha.capacidad, ficha.ventanaMs);
+    }
+
+    /** Anota en el diario que el sensor se va a procesar */
+    void anotarProceso(SensorBase* sensor) {
+        if (diario == nullptr) {
+            return;
+        }
+        std::int32_t id = ids.buscar(sensor->obtenerNombre());
+        if (id >= 0 && porId[id] == sensor) {
+            diario->registrarProceso(static_cast<std::uint32_t>(id));
+        }
+    }
+
+    /** Registra el nombre del sensor en el índice hash; retorna su id
+     *  o -1 si el nombre ya existía
+     */
+    std::int32_t indexar(SensorBase* sensor) {
+        std::string_view nombre(sensor->obtenerNombre());
+        if (ids.buscar(nombre) != InternadorNombres::NO_ENCONTRADO) {
+            return -1;  // Nombre repetido: se conserva el primero
+        }
+        std::uint32_t id = ids.internar(nombre);
+        if (id >= capacidadPorId) {
+            std::uint32_t nuevaCapacidad = (capacidadPorId == 0) ? 16 : capacidadPorId * 2;
+            SensorBase** nuevo = new SensorBase*[nuevaCapacidad];
+            MetricasSensor** nuevasMetricas = new MetricasSensor*[nuevaCapacidad];
+            for (std::uint32_t i = 0; i < capacidadPorId; i++) {
+                nuevo[i] = porId[i];
+                nuevasMetricas[i] = metricasPorId[i];
+            }
+            delete[] porId;
+            delete[] metricasPorId;
+            porId = nuevo;
+            metricasPorId = nuevasMetricas;
+            capacidadPorId = nuevaCapacidad;
+        }
+        porId[id] = sensor;
+        metricasPorId[id] = (metricas != nullptr) ? metricas->sensor(nombre) : nullptr;
+        return static_cast<std::int32_t>(id);
+    }
+
+    void copiarDesde(const GestorSensores& otro) {
+        for (NodoSensor* actual = otro.cabeza; actual != nullptr; actual = actual->siguiente) {
+            agregarSensor(actual->sensor->clonar());
+        }
+    }
+
     void limpiar() {
-        std::cout << "\n--- Liberación de Memoria en Cascada ---" << std::endl;
+        BitacoraPredeterminada::registrar([](auto& os) {
+            os << "\n--- Liberación de Memoria en Cascada ---";
+        });
         
         NodoSensor* actual = cabeza;
         while (actual != nullptr) {
             NodoSensor* temp = actual;
             actual = actual->siguiente;
             
-            std::cout << "[Destructor General] Liberando Nodo: " 
-                      << temp->sensor->obtenerNombre() << "." << std::endl;
-            delete temp->sensor;  // Llama al destructor virtual correcto
-            delete temp;
+            BitacoraPredeterminada::registrar([&](auto& os) {
+                os << "[Destructor General] Liberando Nodo: "
+                   << temp->sensor->obtenerNombre() << ".";
+            });
+            delete temp;  // unique_ptr llama al destructor virtual correcto
         }
         cabeza = nullptr;
+        cola = nullptr;
         cantidad = 0;
-        std::cout << "Sistema cerrado. Memoria limpia." << std::endl;
+        ids.limpiar();
+        BitacoraPredeterminada::registrar([](auto& os) {
+            os << "Sistema cerrado. Memoria limpia.";
+        });
+        BitacoraPredeterminada::vaciar();
     }
 };
 
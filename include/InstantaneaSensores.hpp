@@ -0,0 +1,542 @@
+#ifndef INSTANTANEA_SENSORES_HPP
+#define INSTANTANEA_SENSORES_HPP
+
+#include <iostream>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#include "AgregadosTemporales.hpp"
+#include "ListaSensor.hpp"
+#include "ListaSensorBloques.hpp"
+#include "ListaSensorCircular.hpp"
+
+enum class TipoSensor : std::uint8_t;
+
+/// Contenedor de historial con el que se recrea un sensor
+enum class HistorialInstantanea : std::uint8_t {
+    Lista = 0,
+    Bloques = 1,
+    Circular = 2
+};
+
+/// Cabecera del archivo (desplazamientos en bytes desde el inicio)
+struct CabeceraInstantanea {
+    char magia[8];                      ///< "SIOTSNP1"
+    std::uint32_t version;
+    std::uint32_t sensores;             ///< Fichas en la tabla
+    std::uint64_t generacion;           ///< Diario que continúa esta instantánea
+    std::uint64_t desplazamientoFichas;
+    std::uint64_t desplazamientoFlotantes;
+    std::uint64_t cantidadFlotantes;
+    std::uint64_t desplazamientoEnteros;
+    std::uint64_t cantidadEnteros;
+    std::uint64_t desplazamientoCubetas;
+    std::uint64_t cantidadCubetas;
+    std::uint64_t tamanioTotal;         ///< Detecta archivos cortados
+    std::uint64_t desplazamientoInstantes;  ///< Desde la versión 2 (0 en la 1)
+};
+
+/// Una fila de la tabla de sensores; las lecturas van en su columna
+struct FichaInstantanea {
+    char nombre[56];
+    std::uint8_t tipo;                  ///< TipoSensor
+    std::uint8_t historial;             ///< HistorialInstantanea
+    std::uint8_t entero;                ///< 1: columna int32, 0: columna float
+    std::uint8_t reservado[5];
+    std::uint64_t inicioLecturas;       ///< Índice en la columna, no bytes
+    std::uint64_t cantidadLecturas;
+    std::uint64_t capacidad;            ///< ListaSensorCircular (0 en otros)
+    std::int64_t ventanaMs;             ///< ListaSensorCircular (0: sin ventana)
+    std::uint64_t inicioCubetas;
+    std::uint64_t cantidadCubetas;
+    std::uint8_t reservadoEstadisticas[24];  ///< Antes suma/mín/máx (nunca se leían): en cero
+};
+
+/// Cubeta de AgregadosTemporales
+struct CubetaInstantanea {
+    std::int64_t clave;
+    std::int64_t anchoMs;               ///< Para no mezclar niveles distintos
+    std::uint32_t nivel;
+    std::uint32_t cantidad;
+    double suma;
+    double minimo;
+    double maximo;
+};
+
+static_assert(sizeof(CabeceraInstantanea) == 96, "Cabecera con relleno inesperado");
+static_assert(sizeof(FichaInstantanea) == 136, "Ficha con relleno inesperado");
+static_assert(sizeof(CubetaInstantanea) == 48, "Cubeta con relleno inesperado");
+
+/**
+ * Instantánea columnar de todos los sensores (punto de control).
+ *
+ *   cabecera | fichas[sensores] | float[] | int32[] | cubetas[] | int64[]
+ *
+ * Cada sección empieza alineada a 64 bytes y todo va en el orden de bytes
+ * del equipo, así que al mapear el archivo las columnas se usan tal cual:
+ * un historial es un arreglo contiguo que se pasa directo a insertarVarios
+ * sin interpretar texto ni registros (se copia, ver InstantaneaMapeada). Los sensores se vuelcan con
+ * SensorBase::serializar() y se recargan con SensorBase::restaurar().
+ *
+ * La última sección (versión 2) guarda el instante en ms de cada lectura,
+ * paralela a las columnas: primero los de float[] y luego los de int32[].
+ * Una instantánea de la versión 1 se sigue leyendo, sin instantes.
+ *
+ * guardar() escribe un archivo temporal, lo sincroniza y lo renombra sobre
+ * el anterior: una caída deja la instantánea vieja o la nueva, nunca una
+ * mezcla.
+ */
+class EscritorInstantanea {
+public:
+    EscritorInstantanea() {}
+
+    /**
+     * Vuelca un sensor. T es el tipo de sus lecturas (float o int) y
+     * Historial cualquier contenedor con paraCadaConInstante().
+     */
+    template <typename T, typename Historial>
+    void agregarSensor(TipoSensor tipo, const char* nombre, const Historial& historial,
+                       const AgregadosTemporales& agregados) {
+        static_assert(std::is_same<T, float>::value || std::is_same<T, int>::value,
+                      "Sólo hay columnas float e int32");
+        FichaInstantanea ficha;
+        std::memset(&ficha, 0, sizeof(ficha));
+        std::size_t largo = std::strlen(nombre);   // Se trunca si no cabe
+        if (largo >= sizeof(ficha.nombre)) {
+            largo = sizeof(ficha.nombre) - 1;
+        }
+        std::memcpy(ficha.nombre, nombre, largo);
+        ficha.nombre[largo] = '\0';
+        ficha.tipo = static_cast<std::uint8_t>(tipo);
+        ficha.entero = std::is_same<T, int>::value ? 1 : 0;
+        describir(historial, ficha);
+
+        std::vector<T>& columna = columnaDe(static_cast<T*>(nullptr));
+        std::vector<std::int64_t>& instantes = instantesDe(static_cast<T*>(nullptr));
+        ficha.inicioLecturas = columna.size();
+        historial.paraCadaConInstante([&](const T& valor, std::int64_t instante) {
+            columna.push_back(valor);
+            instantes.push_back(instante);
+        });
+        ficha.cantidadLecturas = columna.size() - ficha.inicioLecturas;
+
+        ficha.inicioCubetas = cubetas.size();
+        agregados.paraCadaCubeta([&](int nivel, std::int64_t clave, std::uint32_t cantidad,
+                                     double suma, double minimo, double maximo) {
+            CubetaInstantanea c = { clave, agregados.obtenerAnchoMs(nivel),
+                                    static_cast<std::uint32_t>(nivel), cantidad, suma, minimo, maximo };
+            cubetas.push_back(c);
+        });
+        ficha.cantidadCubetas = cubetas.size() - ficha.inicioCubetas;
+
+        fichas.push_back(ficha);
+    }
+
+    std::size_t obtenerCantidad() const {
+        return fichas.size();
+    }
+
+    /** Escribe el archivo de forma atómica; retorna false si algo falló.
+     *  Al retornar true el archivo y su entrada en el directorio (el
+     *  rename) ya están en disco, así que se puede reiniciar el diario.
+     */
+    bool guardar(const char* ruta, std::uint64_t generacion) const {
+        CabeceraInstantanea cabecera;
+        std::memset(&cabecera, 0, sizeof(cabecera));
+        std::memcpy(cabecera.magia, MAGIA, sizeof(MAGIA));
+        cabecera.version = VERSION;
+        cabecera.sensores = static_cast<std::uint32_t>(fichas.size());
+        cabecera.generacion = generacion;
+
+        std::uint64_t pos = alinear(sizeof(cabecera));
+        cabecera.desplazamientoFichas = pos;
+        pos = alinear(pos + fichas.size() * sizeof(FichaInstantanea));
+        cabecera.desplazamientoFlotantes = pos;
+        cabecera.cantidadFlotantes = flotantes.size();
+        pos = alinear(pos + flotantes.size() * sizeof(float));
+        cabecera.desplazamientoEnteros = pos;
+        cabecera.cantidadEnteros = enteros.size();
+        pos = alinear(pos + enteros.size() * sizeof(std::int32_t));
+        cabecera.desplazamientoCubetas = pos;
+        cabecera.cantidadCubetas = cubetas.size();
+        pos = alinear(pos + cubetas.size() * sizeof(CubetaInstantanea));
+        cabecera.desplazamientoInstantes = pos;
+        std::uint64_t posEnteros = pos + instantesFlotantes.size() * sizeof(std::int64_t);
+        cabecera.tamanioTotal = posEnteros + instantesEnteros.size() * sizeof(std::int64_t);
+
+        std::string temporal = std::string(ruta) + ".tmp";
+        #ifdef _WIN32
+            int fd = ::_open(temporal.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+        #else
+            int fd = ::open(temporal.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        #endif
+        if (fd < 0) {
+            std::cerr << "[Error] No se pudo crear la instantánea " << temporal << std::endl;
+            return false;
+        }
+
+        std::uint64_t escrito = 0;
+        bool correcto = escribirSeccion(fd, escrito, 0, &cabecera, sizeof(cabecera)) &&
+            escribirSeccion(fd, escrito, cabecera.desplazamientoFichas, fichas.data(),
+                            fichas.size() * sizeof(FichaInstantanea)) &&
+            escribirSeccion(fd, escrito, cabecera.desplazamientoFlotantes, flotantes.data(),
+                            flotantes.size() * sizeof(float)) &&
+            escribirSeccion(fd, escrito, cabecera.desplazamientoEnteros, enteros.data(),
+                            enteros.size() * sizeof(std::int32_t)) &&
+            escribirSeccion(fd, escrito, cabecera.desplazamientoCubetas, cubetas.data(),
+                            cubetas.size() * sizeof(CubetaInstantanea)) &&
+            escribirSeccion(fd, escrito, cabecera.desplazamientoInstantes, instantesFlotantes.data(),
+                            instantesFlotantes.size() * sizeof(std::int64_t)) &&
+            escribirSeccion(fd, escrito, posEnteros, instantesEnteros.data(),
+                            instantesEnteros.size() * sizeof(std::int64_t));
+        #ifdef _WIN32
+            correcto = correcto && ::_commit(fd) == 0;
+            ::_close(fd);
+            std::remove(ruta);
+        #else
+            correcto = correcto && ::fsync(fd) == 0;
+            ::close(fd);
+        #endif
+        if (!correcto || std::rename(temporal.c_str(), ruta) != 0) {
+            std::cerr << "[Error] No se pudo escribir la instantánea " << ruta << std::endl;
+            std::remove(temporal.c_str());
+            return false;
+        }
+        if (!sincronizarDirectorio(ruta)) {
+            // El archivo nuevo puede no sobrevivir a una caída: el diario no debe reiniciarse
+            std::cerr << "[Error] No se pudo confirmar en disco el directorio de " << ruta << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    static constexpr char MAGIA[8] = { 'S', 'I', 'O', 'T', 'S', 'N', 'P', '1' };
+    static const std::uint32_t VERSION = 2;
+    static const std::uint32_t VERSION_SIN_INSTANTES = 1;   ///< Aún se lee
+
+    /** Anota en ficha el historial del contenedor y, si es acotado, su
+     *  capacidad y ventana (también lo usa el registro 'S' del diario)
+     */
+    template <typename T, typename A>
+    static void describir(const ListaSensor<T, A>&, FichaInstantanea& ficha) {
+        ficha.historial = static_cast<std::uint8_t>(HistorialInstantanea::Lista);
+    }
+
+    template <typename T, int N>
+    static void describir(const ListaSensorBloques<T, N>&, FichaInstantanea& ficha) {
+        ficha.historial = static_cast<std::uint8_t>(HistorialInstantanea::Bloques);
+    }
+
+    template <typename T>
+    static void describir(const ListaSensorCircular<T>& historial, FichaInstantanea& ficha) {
+        ficha.historial = static_cast<std::uint8_t>(HistorialInstantanea::Circular);
+        ficha.capacidad = historial.obtenerCapacidad();
+        ficha.ventanaMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            historial.obtenerVentana()).count();
+    }
+
+private:
+    static std::uint64_t alinear(std::uint64_t n) {
+        return (n + 63) & ~static_cast<std::uint64_t>(63);
+    }
+
+    std::vector<float>& columnaDe(float*) { return flotantes; }
+    std::vector<int>& columnaDe(int*) { return enteros; }
+    std::vector<std::int64_t>& instantesDe(float*) { return instantesFlotantes; }
+    std::vector<std::int64_t>& instantesDe(int*) { return instantesEnteros; }
+
+    /** Rellena con ceros hasta desplazamiento y escribe la sección */
+    static bool escribirSeccion(int fd, std::uint64_t& escrito, std::uint64_t desplazamiento,
+                                const void* datos, std::size_t n) {
+        static const char ceros[64] = {};
+        if (escrito < desplazamiento &&
+            !escribirTodo(fd, ceros, static_cast<std::size_t>(desplazamiento - escrito))) {
+            return false;
+        }
+        escrito = desplazamiento + n;
+        return n == 0 || escribirTodo(fd, static_cast<const char*>(datos), n);
+    }
+
+    static bool escribirTodo(int fd, const char* datos, std::size_t n) {
+        while (n > 0) {
+            #ifdef _WIN32
+                int escritos = ::_write(fd, datos, static_cast<unsigned int>(n));
+            #else
+                ssize_t escritos = ::write(fd, datos, n);
+            #endif
+            if (escritos <= 0) {
+                return false;
+            }
+            datos += escritos;
+            n -= static_cast<std::size_t>(escritos);
+        }
+        return true;
+    }
+
+    /** El rename sólo es durable cuando el directorio está en disco.
+     *  EINVAL indica un sistema de archivos que no sincroniza directorios
+     *  (ahí el rename ya es durable); cualquier otro error se informa.
+     */
+    static bool sincronizarDirectorio(const char* ruta) {
+        #ifndef _WIN32
+            std::string directorio(ruta);
+            std::size_t barra = directorio.find_last_of('/');
+            directorio = (barra == std::string::npos) ? "." : directorio.substr(0, barra + 1);
+            int fd = ::open(directorio.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return false;
+            }
+            bool correcto = ::fsync(fd) == 0 || errno == EINVAL;
+            ::close(fd);
+            return correcto;
+        #else
+            (void)ruta;
+            return true;
+        #endif
+    }
+
+    std::vector<FichaInstantanea> fichas;
+    std::vector<float> flotantes;
+    std::vector<int> enteros;
+    std::vector<CubetaInstantanea> cubetas;
+    std::vector<std::int64_t> instantesFlotantes;   ///< Paralelo a flotantes
+    std::vector<std::int64_t> instantesEnteros;     ///< Paralelo a enteros
+};
+
+/**
+ * Instantánea abierta para lectura. En POSIX el archivo se mapea en
+ * memoria (mmap) y fichas y columnas se leen en su lugar; sólo se
+ * validan la cabecera y los rangos. En otros sistemas se lee completo.
+ *
+ * Los historiales no se sirven desde el mapeo: cargarSensor() copia cada
+ * lectura a los nodos (o al anillo) del historial, que después se
+ * modifica con cada lectura nueva. El mapeo evita el análisis y una
+ * copia intermedia, no la carga; lecturas<T>() sí da acceso sin copiar
+ * mientras la instantánea siga abierta.
+ */
+class InstantaneaMapeada {
+public:
+    explicit InstantaneaMapeada(const char* ruta)
+        : base(nullptr), tamanio(0), cabecera(nullptr), mapeado(false) {
+        abrir(ruta);
+    }
+
+    ~InstantaneaMapeada() {
+        #ifndef _WIN32
+            if (mapeado) {
+                ::munmap(const_cast<char*>(base), tamanio);
+            }
+        #endif
+    }
+
+    InstantaneaMapeada(const InstantaneaMapeada&) = delete;
+    InstantaneaMapeada& operator=(const InstantaneaMapeada&) = delete;
+
+    bool estaAbierta() const {
+        return cabecera != nullptr;
+    }
+
+    /** Generación del diario que continúa esta instantánea (0 si no hay) */
+    std::uint64_t obtenerGeneracion() const {
+        return estaAbierta() ? cabecera->generacion : 0;
+    }
+
+    std::uint32_t obtenerCantidad() const {
+        return estaAbierta() ? cabecera->sensores : 0;
+    }
+
+    const FichaInstantanea& ficha(std::uint32_t indice) const {
+        return fichas()[indice];
+    }
+
+    /** Lecturas del sensor indice sin copiar, o nullptr si T no es su columna */
+    template <typename T>
+    const T* lecturas(std::uint32_t indice) const {
+        const FichaInstantanea& f = ficha(indice);
+        if (f.entero != (std::is_same<T, int>::value ? 1 : 0)) {
+            return nullptr;
+        }
+        std::uint64_t desplazamiento = f.entero ? cabecera->desplazamientoEnteros
+                                                : cabecera->desplazamientoFlotantes;
+        return reinterpret_cast<const T*>(base + desplazamiento) + f.inicioLecturas;
+    }
+
+    /** Instantes (ms) de las lecturas del sensor indice, paralelos a
+     *  lecturas<T>(), o nullptr en una instantánea de la versión 1
+     */
+    const std::int64_t* instantes(std::uint32_t indice) const {
+        if (cabecera->version == EscritorInstantanea::VERSION_SIN_INSTANTES) {
+            return nullptr;
+        }
+        const FichaInstantanea& f = ficha(indice);
+        std::uint64_t primero = (f.entero ? cabecera->cantidadFlotantes : 0) + f.inicioLecturas;
+        return reinterpret_cast<const std::int64_t*>(base + cabecera->desplazamientoInstantes) + primero;
+    }
+
+    const CubetaInstantanea* cubetas(std::uint32_t indice) const {
+        return reinterpret_cast<const CubetaInstantanea*>(base + cabecera->desplazamientoCubetas) +
+               ficha(indice).inicioCubetas;
+    }
+
+    /**
+     * Carga el sensor indice en un historial y sus agregados, copiando
+     * las lecturas de la columna mapeada (O(lecturas)); las estadísticas
+     * del historial se recalculan al insertarlas. Es lo que llaman los
+     * sensores desde SensorBase::restaurar().
+     */
+    template <typename T, typename Historial>
+    bool cargarSensor(std::uint32_t indice, Historial& historial, AgregadosTemporales& agregados) const {
+        const T* valores = lecturas<T>(indice);
+        if (valores == nullptr) {
+            return false;
+        }
+        const FichaInstantanea& f = ficha(indice);
+        const std::int64_t* marcas = instantes(indice);
+        // insertarVarios recibe int: historiales enormes se cargan por tramos
+        std::uint64_t restantes = f.cantidadLecturas;
+        while (restantes > 0) {
+            int n = restantes > (1u << 30) ? (1 << 30) : static_cast<int>(restantes);
+            if (marcas != nullptr) {
+                historial.insertarVariosEn(valores, marcas, n);
+                marcas += n;
+            } else {
+                historial.insertarVarios(valores, n);
+            }
+            valores += n;
+            restantes -= static_cast<std::uint64_t>(n);
+        }
+
+        const CubetaInstantanea* c = cubetas(indice);
+        for (std::uint64_t i = 0; i < f.cantidadCubetas; i++) {
+            if (static_cast<int>(c[i].nivel) < agregados.obtenerCantidadNiveles() &&
+                agregados.obtenerAnchoMs(static_cast<int>(c[i].nivel)) == c[i].anchoMs) {
+                agregados.restaurarCubeta(static_cast<int>(c[i].nivel), c[i].clave, c[i].cantidad,
+                                          c[i].suma, c[i].minimo, c[i].maximo);
+            }
+        }
+        return true;
+    }
+
+private:
+    const FichaInstantanea* fichas() const {
+        return reinterpret_cast<const FichaInstantanea*>(base + cabecera->desplazamientoFichas);
+    }
+
+    void abrir(const char* ruta) {
+        #ifdef _WIN32
+            int fd = ::_open(ruta, _O_RDONLY | _O_BINARY);
+        #else
+            int fd = ::open(ruta, O_RDONLY | O_CLOEXEC);
+        #endif
+        if (fd < 0) {
+            return;   // Sin instantánea: no es un error
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(CabeceraInstantanea))) {
+            cerrarDescriptor(fd);
+            std::cerr << "[Error] Instantánea " << ruta << " incompleta; se ignora." << std::endl;
+            return;
+        }
+        tamanio = static_cast<std::size_t>(info.st_size);
+
+        #ifdef _WIN32
+            copia.resize(tamanio);
+            std::size_t leidos = 0;
+            int n;
+            while (leidos < tamanio &&
+                   (n = ::_read(fd, &copia[leidos], static_cast<unsigned int>(tamanio - leidos))) > 0) {
+                leidos += static_cast<std::size_t>(n);
+            }
+            base = copia.data();
+        #else
+            void* mapa = ::mmap(nullptr, tamanio, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapa != MAP_FAILED) {
+                base = static_cast<const char*>(mapa);
+                mapeado = true;
+                ::madvise(mapa, tamanio, MADV_WILLNEED);
+            }
+        #endif
+        cerrarDescriptor(fd);   // El mapeo sigue válido sin el descriptor
+
+        if (base == nullptr || !validar()) {
+            std::cerr << "[Error] Instantánea " << ruta << " no válida; se ignora." << std::endl;
+            cabecera = nullptr;
+        }
+    }
+
+    /** Comprueba que cada sección y cada rango de ficha caben en el archivo */
+    bool validar() {
+        const CabeceraInstantanea* c = reinterpret_cast<const CabeceraInstantanea*>(base);
+        if (std::memcmp(c->magia, EscritorInstantanea::MAGIA, sizeof(c->magia)) != 0 ||
+            (c->version != EscritorInstantanea::VERSION &&
+             c->version != EscritorInstantanea::VERSION_SIN_INSTANTES) ||
+            c->tamanioTotal != tamanio) {
+            return false;
+        }
+        if (c->version != EscritorInstantanea::VERSION_SIN_INSTANTES &&
+            (c->cantidadFlotantes > tamanio || c->cantidadEnteros > tamanio ||
+             !cabe(c->desplazamientoInstantes, c->cantidadFlotantes + c->cantidadEnteros,
+                   sizeof(std::int64_t)) ||
+             c->desplazamientoInstantes % 64 != 0)) {
+            return false;
+        }
+        if (!cabe(c->desplazamientoFichas, c->sensores, sizeof(FichaInstantanea)) ||
+            !cabe(c->desplazamientoFlotantes, c->cantidadFlotantes, sizeof(float)) ||
+            !cabe(c->desplazamientoEnteros, c->cantidadEnteros, sizeof(std::int32_t)) ||
+            !cabe(c->desplazamientoCubetas, c->cantidadCubetas, sizeof(CubetaInstantanea)) ||
+            (c->desplazamientoFichas | c->desplazamientoFlotantes |
+             c->desplazamientoEnteros | c->desplazamientoCubetas) % 64 != 0) {
+            return false;
+        }
+        const FichaInstantanea* f = reinterpret_cast<const FichaInstantanea*>(base + c->desplazamientoFichas);
+        for (std::uint32_t i = 0; i < c->sensores; i++) {
+            std::uint64_t columna = f[i].entero ? c->cantidadEnteros : c->cantidadFlotantes;
+            if (f[i].inicioLecturas > columna || f[i].cantidadLecturas > columna - f[i].inicioLecturas ||
+                f[i].inicioCubetas > c->cantidadCubetas ||
+                f[i].cantidadCubetas > c->cantidadCubetas - f[i].inicioCubetas ||
+                f[i].nombre[sizeof(f[i].nombre) - 1] != '\0') {
+                return false;
+            }
+        }
+        cabecera = c;
+        return true;
+    }
+
+    bool cabe(std::uint64_t desplazamiento, std::uint64_t cantidad, std::size_t tamElemento) const {
+        return desplazamiento <= tamanio && cantidad <= (tamanio - desplazamiento) / tamElemento;
+    }
+
+    static void cerrarDescriptor(int fd) {
+        #ifdef _WIN32
+            ::_close(fd);
+        #else
+            ::close(fd);
+        #endif
+    }
+
+    const char* base;
+    std::size_t tamanio;
+    const CabeceraInstantanea* cabecera;   ///< nullptr si no se abrió o no es válida
+    bool mapeado;
+    #ifdef _WIN32
+        std::vector<char> copia;
+    #endif
+};
+
+#endif // INSTANTANEA_SENSORES_HPP
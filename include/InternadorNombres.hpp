@@ -0,0 +1,227 @@
+#ifndef INTERNADOR_NOMBRES_HPP
+#define INTERNADOR_NOMBRES_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+
+/**
+ * Tabla hash de direccionamiento abierto que asigna a cada nombre de
+ * sensor un identificador entero compacto (0, 1, 2, ...).
+ *
+ * El nombre se resume una sola vez (FNV-1a) y se compara completo sólo
+ * cuando coinciden los 32 bits del resumen, así que una búsqueda cuesta
+ * O(1) esperado sin importar cuántos sensores existan. Los nombres se
+ * copian a un área contigua propia; el resto del sistema puede trabajar
+ * con el identificador en lugar de la cadena.
+ */
+class InternadorNombres {
+public:
+    static const std::int32_t NO_ENCONTRADO = -1;
+
+    InternadorNombres()
+        : ranuras(nullptr), capacidadRanuras(0),
+          desplazamientos(nullptr), longitudes(nullptr), cantidad(0), capacidadIds(0),
+          texto(nullptr), usadoTexto(0), capacidadTexto(0) {}
+
+    ~InternadorNombres() {
+        liberar();
+    }
+
+    InternadorNombres(const InternadorNombres&) = delete;
+    InternadorNombres& operator=(const InternadorNombres&) = delete;
+
+    /** Traspasa tabla y nombres en O(1); el origen queda vacío */
+    InternadorNombres(InternadorNombres&& otro) noexcept
+        : ranuras(nullptr), capacidadRanuras(0),
+          desplazamientos(nullptr), longitudes(nullptr), cantidad(0), capacidadIds(0),
+          texto(nullptr), usadoTexto(0), capacidadTexto(0) {
+        intercambiar(otro);
+    }
+
+    InternadorNombres& operator=(InternadorNombres&& otro) noexcept {
+        if (this != &otro) {
+            liberar();
+            intercambiar(otro);
+        }
+        return *this;
+    }
+
+    void intercambiar(InternadorNombres& otro) noexcept {
+        std::swap(ranuras, otro.ranuras);
+        std::swap(capacidadRanuras, otro.capacidadRanuras);
+        std::swap(desplazamientos, otro.desplazamientos);
+        std::swap(longitudes, otro.longitudes);
+        std::swap(cantidad, otro.cantidad);
+        std::swap(capacidadIds, otro.capacidadIds);
+        std::swap(texto, otro.texto);
+        std::swap(usadoTexto, otro.usadoTexto);
+        std::swap(capacidadTexto, otro.capacidadTexto);
+    }
+
+    /** Devuelve el identificador del nombre o NO_ENCONTRADO */
+    std::int32_t buscar(std::string_view nombre) const {
+        if (cantidad == 0) {
+            return NO_ENCONTRADO;
+        }
+        std::uint32_t resumen = resumir(nombre);
+        std::uint32_t mascara = capacidadRanuras - 1;
+        for (std::uint32_t i = resumen & mascara;; i = (i + 1) & mascara) {
+            const Ranura& r = ranuras[i];
+            if (r.id == NO_ENCONTRADO) {
+                return NO_ENCONTRADO;
+            }
+            if (r.resumen == resumen && coincide(r.id, nombre)) {
+                return r.id;
+            }
+        }
+    }
+
+    /** Devuelve el identificador del nombre, creándolo si no existe */
+    std::uint32_t internar(std::string_view nombre) {
+        std::int32_t existente = buscar(nombre);
+        if (existente != NO_ENCONTRADO) {
+            return static_cast<std::uint32_t>(existente);
+        }
+
+        // Factor de carga máximo de 1/2 para sondeos lineales cortos
+        if (2 * (cantidad + 1) > capacidadRanuras) {
+            crecerRanuras(capacidadRanuras == 0 ? 16 : capacidadRanuras * 2);
+        }
+        if (cantidad == capacidadIds) {
+            crecerIds(capacidadIds == 0 ? 16 : capacidadIds * 2);
+        }
+        while (usadoTexto + nombre.size() + 1 > capacidadTexto) {
+            crecerTexto(capacidadTexto == 0 ? 256 : capacidadTexto * 2);
+        }
+
+        std::uint32_t id = cantidad++;
+        desplazamientos[id] = usadoTexto;
+        longitudes[id] = static_cast<std::uint32_t>(nombre.size());
+        std::memcpy(texto + usadoTexto, nombre.data(), nombre.size());
+        texto[usadoTexto + nombre.size()] = '\0';
+        usadoTexto += nombre.size() + 1;
+
+        colocar(resumir(nombre), static_cast<std::int32_t>(id));
+        return id;
+    }
+
+    /** Nombre (terminado en '\0') asociado a un identificador */
+    const char* nombre(std::uint32_t id) const {
+        return texto + desplazamientos[id];
+    }
+
+    std::uint32_t obtenerCantidad() const {
+        return cantidad;
+    }
+
+    /** Olvida todos los nombres (conserva la memoria reservada) */
+    void limpiar() {
+        for (std::uint32_t i = 0; i < capacidadRanuras; i++) {
+            ranuras[i].id = NO_ENCONTRADO;
+        }
+        cantidad = 0;
+        usadoTexto = 0;
+    }
+
+private:
+    struct Ranura {
+        std::uint32_t resumen;  ///< FNV-1a del nombre
+        std::int32_t id;        ///< NO_ENCONTRADO = ranura vacía
+    };
+
+    static std::uint32_t resumir(std::string_view nombre) {
+        std::uint32_t h = 2166136261u;
+        for (char c : nombre) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    bool coincide(std::int32_t id, std::string_view nombre) const {
+        return longitudes[id] == nombre.size() &&
+               std::memcmp(texto + desplazamientos[id], nombre.data(), nombre.size()) == 0;
+    }
+
+    void colocar(std::uint32_t resumen, std::int32_t id) {
+        std::uint32_t mascara = capacidadRanuras - 1;
+        std::uint32_t i = resumen & mascara;
+        while (ranuras[i].id != NO_ENCONTRADO) {
+            i = (i + 1) & mascara;
+        }
+        ranuras[i].resumen = resumen;
+        ranuras[i].id = id;
+    }
+
+    void crecerRanuras(std::uint32_t nuevaCapacidad) {
+        Ranura* anteriores = ranuras;
+        std::uint32_t capacidadAnterior = capacidadRanuras;
+
+        ranuras = new Ranura[nuevaCapacidad];
+        capacidadRanuras = nuevaCapacidad;
+        for (std::uint32_t i = 0; i < nuevaCapacidad; i++) {
+            ranuras[i].id = NO_ENCONTRADO;
+        }
+        for (std::uint32_t i = 0; i < capacidadAnterior; i++) {
+            if (anteriores[i].id != NO_ENCONTRADO) {
+                colocar(anteriores[i].resumen, anteriores[i].id);
+            }
+        }
+        delete[] anteriores;
+    }
+
+    void crecerIds(std::uint32_t nuevaCapacidad) {
+        std::size_t* nuevosDesp = new std::size_t[nuevaCapacidad];
+        std::uint32_t* nuevasLong = new std::uint32_t[nuevaCapacidad];
+        for (std::uint32_t i = 0; i < cantidad; i++) {
+            nuevosDesp[i] = desplazamientos[i];
+            nuevasLong[i] = longitudes[i];
+        }
+        delete[] desplazamientos;
+        delete[] longitudes;
+        desplazamientos = nuevosDesp;
+        longitudes = nuevasLong;
+        capacidadIds = nuevaCapacidad;
+    }
+
+    void crecerTexto(std::size_t nuevaCapacidad) {
+        char* nuevo = new char[nuevaCapacidad];
+        if (usadoTexto > 0) {
+            std::memcpy(nuevo, texto, usadoTexto);
+        }
+        delete[] texto;
+        texto = nuevo;
+        capacidadTexto = nuevaCapacidad;
+    }
+
+    void liberar() {
+        delete[] ranuras;
+        delete[] desplazamientos;
+        delete[] longitudes;
+        delete[] texto;
+        ranuras = nullptr;
+        desplazamientos = nullptr;
+        longitudes = nullptr;
+        texto = nullptr;
+        capacidadRanuras = 0;
+        capacidadIds = 0;
+        capacidadTexto = 0;
+        cantidad = 0;
+        usadoTexto = 0;
+    }
+
+    Ranura* ranuras;                 ///< Tabla hash (potencia de 2)
+    std::uint32_t capacidadRanuras;
+    std::size_t* desplazamientos;    ///< id -> posición del nombre en texto
+    std::uint32_t* longitudes;       ///< id -> longitud del nombre
+    std::uint32_t cantidad;          ///< Identificadores asignados
+    std::uint32_t capacidadIds;
+    char* texto;                     ///< Nombres contiguos terminados en '\0'
+    std::size_t usadoTexto;
+    std::size_t capacidadTexto;
+};
+
+#endif // INTERNADOR_NOMBRES_HPP
@@ -0,0 +1,743 @@
+#ifndef KERNELES_ANALITICA_HPP
+#define KERNELES_ANALITICA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "EstadisticasHistorial.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define SISTEMAIOT_SIMD_X86 1
+    #include <immintrin.h>
+    #define SISTEMAIOT_OBJETIVO(objetivo) __attribute__((target(objetivo)))
+#else
+    #define SISTEMAIOT_SIMD_X86 0
+    #define SISTEMAIOT_OBJETIVO(objetivo)
+#endif
+
+/**
+ * Kernels de análisis sobre lecturas contiguas (float, int, double):
+ * resumen (cantidad, suma, mínimo, máximo), suma de cuadrados de las
+ * desviaciones (varianza) y conteo dentro de un rango.
+ *
+ * Hay tres versiones de cada kernel: escalar, SSE4.1 y AVX2. La versión
+ * se elige en tiempo de ejecución según la CPU (nivelSimdDisponible), así
+ * que el mismo binario corre en cualquier x86-64; fuera de x86 sólo se
+ * compila la escalar. SISTEMAIOT_SIMD=escalar|sse|avx2 limita el nivel
+ * (p. ej. para comparar resultados).
+ *
+ * Acumuladores: los int se suman en carriles de 64 bits (exacto); los
+ * float se convierten a double antes de sumar; los double usan suma
+ * compensada de Neumaier por carril, igual que EstadisticasHistorial.
+ */
+
+enum class NivelSimd { Escalar = 0, Sse41 = 1, Avx2 = 2 };
+
+inline const char* nombreNivelSimd(NivelSimd nivel) {
+    switch (nivel) {
+        case NivelSimd::Avx2:  return "avx2";
+        case NivelSimd::Sse41: return "sse4.1";
+        default:               return "escalar";
+    }
+}
+
+/** Mejor nivel que soporta la CPU */
+inline NivelSimd nivelSimdDisponible() {
+    #if SISTEMAIOT_SIMD_X86
+        static const NivelSimd nivel = __builtin_cpu_supports("avx2") ? NivelSimd::Avx2
+                                     : __builtin_cpu_supports("sse4.1") ? NivelSimd::Sse41
+                                     : NivelSimd::Escalar;
+        return nivel;
+    #else
+        return NivelSimd::Escalar;
+    #endif
+}
+
+inline std::atomic<int>& nivelSimdConfigurado() {
+    static std::atomic<int> nivel([]() {
+        int n = static_cast<int>(nivelSimdDisponible());
+        const char* variable = std::getenv("SISTEMAIOT_SIMD");
+        if (variable != nullptr) {
+            int pedido = (std::strcmp(variable, "escalar") == 0) ? 0
+                       : (std::strcmp(variable, "sse") == 0) ? 1 : 2;
+            n = (pedido < n) ? pedido : n;
+        }
+        return n;
+    }());
+    return nivel;
+}
+
+/** Nivel que usan los kernels */
+inline NivelSimd nivelSimdActivo() {
+    return static_cast<NivelSimd>(nivelSimdConfigurado().load(std::memory_order_relaxed));
+}
+
+/** Fija el nivel (acotado al disponible); lo usan los benchmarks */
+inline void fijarNivelSimd(NivelSimd nivel) {
+    int n = static_cast<int>(nivel);
+    int maximo = static_cast<int>(nivelSimdDisponible());
+    nivelSimdConfigurado().store(n < maximo ? n : maximo, std::memory_order_relaxed);
+}
+
+/** s += x con el error de redondeo acumulado en c (Neumaier) */
+inline void sumarNeumaier(double& s, double& c, double x) {
+    double t = s + x;
+    if ((s < 0 ? -s : s) >= (x < 0 ? -x : x)) {
+        c += (s - t) + x;
+    } else {
+        c += (x - t) + s;
+    }
+    s = t;
+}
+
+/// Cantidad, suma y extremos de un conjunto de lecturas
+template <typename T>
+struct ResumenSegmento {
+    typedef typename EstadisticasHistorial<T>::Acumulador Acumulador;
+
+    std::size_t cantidad;
+    Acumulador suma;
+    double compensacion;   ///< Sólo flotantes
+    T minimo;              ///< Válido si cantidad > 0
+    T maximo;
+
+    ResumenSegmento() : cantidad(0), suma(), compensacion(0.0), minimo(), maximo() {}
+
+    void agregar(const T& valor) {
+        if (cantidad == 0 || valor < minimo) {
+            minimo = valor;
+        }
+        if (cantidad == 0 || maximo < valor) {
+            maximo = valor;
+        }
+        cantidad++;
+        acumular(valor);
+    }
+
+    /** Une el resumen de otro segmento */
+    void combinar(const ResumenSegmento& otro) {
+        if (otro.cantidad == 0) {
+            return;
+        }
+        if (cantidad == 0 || otro.minimo < minimo) {
+            minimo = otro.minimo;
+        }
+        if (cantidad == 0 || maximo < otro.maximo) {
+            maximo = otro.maximo;
+        }
+        cantidad += otro.cantidad;
+        acumular(otro.suma);
+        compensacion += otro.compensacion;
+    }
+
+    double obtenerSuma() const {
+        return static_cast<double>(suma) + compensacion;
+    }
+
+    double promedio() const {
+        return (cantidad == 0) ? 0.0 : obtenerSuma() / static_cast<double>(cantidad);
+    }
+
+private:
+    void acumular(Acumulador valor) {
+        if constexpr (std::is_integral<T>::value) {
+            suma += valor;
+        } else {
+            double s = static_cast<double>(suma);
+            sumarNeumaier(s, compensacion, static_cast<double>(valor));
+            suma = s;
+        }
+    }
+};
+
+class KernelesAnalitica {
+public:
+    /** Cantidad, suma y extremos de datos[0, n) */
+    template <typename T>
+    static ResumenSegmento<T> resumir(const T* datos, std::size_t n) {
+        #if SISTEMAIOT_SIMD_X86
+            switch (nivelSimdActivo()) {
+                case NivelSimd::Avx2:  return resumirAvx2(datos, n);
+                case NivelSimd::Sse41: return resumirSse41(datos, n);
+                default: break;
+            }
+        #endif
+        return resumirEscalar(datos, n);
+    }
+
+    /** Suma de (x - media)^2 sobre datos[0, n), acumulada en double */
+    template <typename T>
+    static double sumaCuadradosDesviacion(const T* datos, std::size_t n, double media) {
+        #if SISTEMAIOT_SIMD_X86
+            switch (nivelSimdActivo()) {
+                case NivelSimd::Avx2:  return desviacionAvx2(datos, n, media);
+                case NivelSimd::Sse41: return desviacionSse41(datos, n, media);
+                default: break;
+            }
+        #endif
+        return desviacionEscalar(datos, n, media);
+    }
+
+    /** Cuántas lecturas cumplen minimo <= x <= maximo */
+    template <typename T>
+    static std::size_t contarEnRango(const T* datos, std::size_t n, T minimo, T maximo) {
+        #if SISTEMAIOT_SIMD_X86
+            switch (nivelSimdActivo()) {
+                case NivelSimd::Avx2:  return contarAvx2(datos, n, minimo, maximo);
+                case NivelSimd::Sse41: return contarSse41(datos, n, minimo, maximo);
+                default: break;
+            }
+        #endif
+        return contarEscalar(datos, n, minimo, maximo);
+    }
+
+    // Versiones escalares: referencia y colas que no llenan un vector
+
+    template <typename T>
+    static ResumenSegmento<T> resumirEscalar(const T* datos, std::size_t n) {
+        ResumenSegmento<T> r;
+        for (std::size_t i = 0; i < n; i++) {
+            r.agregar(datos[i]);
+        }
+        return r;
+    }
+
+    template <typename T>
+    static double desviacionEscalar(const T* datos, std::size_t n, double media) {
+        double suma = 0.0;
+        for (std::size_t i = 0; i < n; i++) {
+            double d = static_cast<double>(datos[i]) - media;
+            suma += d * d;
+        }
+        return suma;
+    }
+
+    template <typename T>
+    static std::size_t contarEscalar(const T* datos, std::size_t n, T minimo, T maximo) {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            total += (!(datos[i] < minimo) && !(maximo < datos[i])) ? 1 : 0;
+        }
+        return total;
+    }
+
+private:
+    /** Los contadores de 32 bits por carril se vacían cada BLOQUE_CONTEO elementos */
+    static const std::size_t BLOQUE_CONTEO = std::size_t(1) << 28;
+
+    /** Reúne carriles ya reducidos con la cola escalar */
+    template <typename T>
+    static ResumenSegmento<T> cerrar(std::size_t cantidad, typename ResumenSegmento<T>::Acumulador suma,
+                                     double compensacion, T minimo, T maximo,
+                                     const T* cola, std::size_t restantes) {
+        ResumenSegmento<T> r;
+        if (cantidad > 0) {
+            r.cantidad = cantidad;
+            r.suma = suma;
+            r.compensacion = compensacion;
+            r.minimo = minimo;
+            r.maximo = maximo;
+        }
+        r.combinar(resumirEscalar(cola, restantes));
+        return r;
+    }
+
+    template <typename T, int CARRILES>
+    static void extremos(const T (&minimos)[CARRILES], const T (&maximos)[CARRILES], T& minimo, T& maximo) {
+        minimo = minimos[0];
+        maximo = maximos[0];
+        for (int k = 1; k < CARRILES; k++) {
+            if (minimos[k] < minimo) minimo = minimos[k];
+            if (maximo < maximos[k]) maximo = maximos[k];
+        }
+    }
+
+    /** Suma con Neumaier los carriles (y sus compensaciones) */
+    template <int CARRILES>
+    static void reducirCompensado(const double (&sumas)[CARRILES], const double (&errores)[CARRILES],
+                                  double& suma, double& compensacion) {
+        suma = 0.0;
+        compensacion = 0.0;
+        for (int k = 0; k < CARRILES; k++) {
+            sumarNeumaier(suma, compensacion, sumas[k]);
+            compensacion += errores[k];
+        }
+    }
+
+#if SISTEMAIOT_SIMD_X86
+    // ---------------------------------------------------------------- SSE4.1
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static ResumenSegmento<float> resumirSse41(const float* datos, std::size_t n) {
+        std::size_t i = 0;
+        __m128 mn = _mm_set1_ps(0.0f), mx = mn;
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        if (n >= 4) {
+            mn = mx = _mm_loadu_ps(datos);
+            for (; i + 4 <= n; i += 4) {
+                __m128 v = _mm_loadu_ps(datos + i);
+                mn = _mm_min_ps(mn, v);
+                mx = _mm_max_ps(mx, v);
+                s0 = _mm_add_pd(s0, _mm_cvtps_pd(v));
+                s1 = _mm_add_pd(s1, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+            }
+        }
+        float minimos[4], maximos[4];
+        double sumas[4], errores[4] = { 0.0, 0.0, 0.0, 0.0 };
+        _mm_storeu_ps(minimos, mn);
+        _mm_storeu_ps(maximos, mx);
+        _mm_storeu_pd(sumas, s0);
+        _mm_storeu_pd(sumas + 2, s1);
+        float minimo, maximo;
+        double suma, compensacion;
+        extremos(minimos, maximos, minimo, maximo);
+        reducirCompensado(sumas, errores, suma, compensacion);
+        return cerrar<float>(i, suma, compensacion, minimo, maximo, datos + i, n - i);
+    }
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static ResumenSegmento<int> resumirSse41(const int* datos, std::size_t n) {
+        std::size_t i = 0;
+        __m128i mn = _mm_setzero_si128(), mx = mn;
+        __m128i s0 = _mm_setzero_si128(), s1 = _mm_setzero_si128();
+        if (n >= 4) {
+            mn = mx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos));
+            for (; i + 4 <= n; i += 4) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i));
+                mn = _mm_min_epi32(mn, v);
+                mx = _mm_max_epi32(mx, v);
+                s0 = _mm_add_epi64(s0, _mm_cvtepi32_epi64(v));
+                s1 = _mm_add_epi64(s1, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+            }
+        }
+        int minimos[4], maximos[4];
+        long long sumas[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(minimos), mn);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(maximos), mx);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sumas), s0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sumas + 2), s1);
+        int minimo, maximo;
+        extremos(minimos, maximos, minimo, maximo);
+        return cerrar<int>(i, sumas[0] + sumas[1] + sumas[2] + sumas[3], 0.0, minimo, maximo,
+                           datos + i, n - i);
+    }
+
+    /** Neumaier por carril: c += (|s| >= |x|) ? (s - t) + x : (x - t) + s */
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static void neumaierSse41(__m128d& s, __m128d& c, __m128d x) {
+        const __m128d signo = _mm_set1_pd(-0.0);
+        __m128d t = _mm_add_pd(s, x);
+        __m128d mayor = _mm_cmpge_pd(_mm_andnot_pd(signo, s), _mm_andnot_pd(signo, x));
+        __m128d a = _mm_add_pd(_mm_sub_pd(s, t), x);
+        __m128d b = _mm_add_pd(_mm_sub_pd(x, t), s);
+        c = _mm_add_pd(c, _mm_blendv_pd(b, a, mayor));
+        s = t;
+    }
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static ResumenSegmento<double> resumirSse41(const double* datos, std::size_t n) {
+        std::size_t i = 0;
+        __m128d mn = _mm_setzero_pd(), mx = mn;
+        __m128d s0 = _mm_setzero_pd(), c0 = _mm_setzero_pd();
+        __m128d s1 = _mm_setzero_pd(), c1 = _mm_setzero_pd();
+        if (n >= 4) {
+            mn = mx = _mm_loadu_pd(datos);
+            for (; i + 4 <= n; i += 4) {
+                __m128d v0 = _mm_loadu_pd(datos + i);
+                __m128d v1 = _mm_loadu_pd(datos + i + 2);
+                mn = _mm_min_pd(mn, _mm_min_pd(v0, v1));
+                mx = _mm_max_pd(mx, _mm_max_pd(v0, v1));
+                neumaierSse41(s0, c0, v0);
+                neumaierSse41(s1, c1, v1);
+            }
+        }
+        double minimos[2], maximos[2], sumas[4], errores[4];
+        _mm_storeu_pd(minimos, mn);
+        _mm_storeu_pd(maximos, mx);
+        _mm_storeu_pd(sumas, s0);
+        _mm_storeu_pd(sumas + 2, s1);
+        _mm_storeu_pd(errores, c0);
+        _mm_storeu_pd(errores + 2, c1);
+        double minimo, maximo, suma, compensacion;
+        extremos(minimos, maximos, minimo, maximo);
+        reducirCompensado(sumas, errores, suma, compensacion);
+        return cerrar<double>(i, suma, compensacion, minimo, maximo, datos + i, n - i);
+    }
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static double desviacionSse41(const float* datos, std::size_t n, double media) {
+        const __m128d m = _mm_set1_pd(media);
+        __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 v = _mm_loadu_ps(datos + i);
+            __m128d d0 = _mm_sub_pd(_mm_cvtps_pd(v), m);
+            __m128d d1 = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), m);
+            a0 = _mm_add_pd(a0, _mm_mul_pd(d0, d0));
+            a1 = _mm_add_pd(a1, _mm_mul_pd(d1, d1));
+        }
+        double sumas[2];
+        _mm_storeu_pd(sumas, _mm_add_pd(a0, a1));
+        return sumas[0] + sumas[1] + desviacionEscalar(datos + i, n - i, media);
+    }
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static double desviacionSse41(const int* datos, std::size_t n, double media) {
+        const __m128d m = _mm_set1_pd(media);
+        __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i));
+            __m128d d0 = _mm_sub_pd(_mm_cvtepi32_pd(v), m);
+            __m128d d1 = _mm_sub_pd(_mm_cvtepi32_pd(_mm_srli_si128(v, 8)), m);
+            a0 = _mm_add_pd(a0, _mm_mul_pd(d0, d0));
+            a1 = _mm_add_pd(a1, _mm_mul_pd(d1, d1));
+        }
+        double sumas[2];
+        _mm_storeu_pd(sumas, _mm_add_pd(a0, a1));
+        return sumas[0] + sumas[1] + desviacionEscalar(datos + i, n - i, media);
+    }
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static double desviacionSse41(const double* datos, std::size_t n, double media) {
+        const __m128d m = _mm_set1_pd(media);
+        __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128d d0 = _mm_sub_pd(_mm_loadu_pd(datos + i), m);
+            __m128d d1 = _mm_sub_pd(_mm_loadu_pd(datos + i + 2), m);
+            a0 = _mm_add_pd(a0, _mm_mul_pd(d0, d0));
+            a1 = _mm_add_pd(a1, _mm_mul_pd(d1, d1));
+        }
+        double sumas[2];
+        _mm_storeu_pd(sumas, _mm_add_pd(a0, a1));
+        return sumas[0] + sumas[1] + desviacionEscalar(datos + i, n - i, media);
+    }
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static std::size_t contarSse41(const float* datos, std::size_t n, float minimo, float maximo) {
+        const __m128 lo = _mm_set1_ps(minimo), hi = _mm_set1_ps(maximo);
+        std::size_t total = 0;
+        std::size_t i = 0;
+        while (i + 4 <= n) {
+            std::size_t fin = (n - i > BLOQUE_CONTEO) ? i + BLOQUE_CONTEO : n;
+            __m128i cuenta = _mm_setzero_si128();
+            for (; i + 4 <= fin; i += 4) {
+                __m128 v = _mm_loadu_ps(datos + i);
+                __m128 dentro = _mm_and_ps(_mm_cmpge_ps(v, lo), _mm_cmple_ps(v, hi));
+                cuenta = _mm_sub_epi32(cuenta, _mm_castps_si128(dentro));   // máscara = -1
+            }
+            std::uint32_t carriles[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(carriles), cuenta);
+            total += std::size_t(carriles[0]) + carriles[1] + carriles[2] + carriles[3];
+        }
+        return total + contarEscalar(datos + i, n - i, minimo, maximo);
+    }
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static std::size_t contarSse41(const int* datos, std::size_t n, int minimo, int maximo) {
+        const __m128i lo = _mm_set1_epi32(minimo), hi = _mm_set1_epi32(maximo);
+        std::size_t fuera = 0;
+        std::size_t i = 0;
+        while (i + 4 <= n) {
+            std::size_t fin = (n - i > BLOQUE_CONTEO) ? i + BLOQUE_CONTEO : n;
+            __m128i cuenta = _mm_setzero_si128();
+            for (; i + 4 <= fin; i += 4) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i));
+                __m128i afuera = _mm_or_si128(_mm_cmplt_epi32(v, lo), _mm_cmpgt_epi32(v, hi));
+                cuenta = _mm_sub_epi32(cuenta, afuera);
+            }
+            std::uint32_t carriles[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(carriles), cuenta);
+            fuera += std::size_t(carriles[0]) + carriles[1] + carriles[2] + carriles[3];
+        }
+        return (i - fuera) + contarEscalar(datos + i, n - i, minimo, maximo);
+    }
+
+    SISTEMAIOT_OBJETIVO("sse4.1")
+    static std::size_t contarSse41(const double* datos, std::size_t n, double minimo, double maximo) {
+        const __m128d lo = _mm_set1_pd(minimo), hi = _mm_set1_pd(maximo);
+        __m128i cuenta = _mm_setzero_si128();   // Carriles de 64 bits: no desbordan
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            __m128d v = _mm_loadu_pd(datos + i);
+            __m128d dentro = _mm_and_pd(_mm_cmpge_pd(v, lo), _mm_cmple_pd(v, hi));
+            cuenta = _mm_sub_epi64(cuenta, _mm_castpd_si128(dentro));
+        }
+        std::uint64_t carriles[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(carriles), cuenta);
+        return static_cast<std::size_t>(carriles[0] + carriles[1]) +
+               contarEscalar(datos + i, n - i, minimo, maximo);
+    }
+
+    // ------------------------------------------------------------------ AVX2
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static ResumenSegmento<float> resumirAvx2(const float* datos, std::size_t n) {
+        std::size_t i = 0;
+        __m256 mn = _mm256_setzero_ps(), mx = mn;
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        if (n >= 8) {
+            mn = mx = _mm256_loadu_ps(datos);
+            for (; i + 8 <= n; i += 8) {
+                __m256 v = _mm256_loadu_ps(datos + i);
+                mn = _mm256_min_ps(mn, v);
+                mx = _mm256_max_ps(mx, v);
+                s0 = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+                s1 = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+            }
+        }
+        float minimos[8], maximos[8];
+        double sumas[8], errores[8] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        _mm256_storeu_ps(minimos, mn);
+        _mm256_storeu_ps(maximos, mx);
+        _mm256_storeu_pd(sumas, s0);
+        _mm256_storeu_pd(sumas + 4, s1);
+        float minimo, maximo;
+        double suma, compensacion;
+        extremos(minimos, maximos, minimo, maximo);
+        reducirCompensado(sumas, errores, suma, compensacion);
+        return cerrar<float>(i, suma, compensacion, minimo, maximo, datos + i, n - i);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static ResumenSegmento<int> resumirAvx2(const int* datos, std::size_t n) {
+        std::size_t i = 0;
+        __m256i mn = _mm256_setzero_si256(), mx = mn;
+        __m256i s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256();
+        if (n >= 8) {
+            mn = mx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos));
+            for (; i + 8 <= n; i += 8) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i));
+                mn = _mm256_min_epi32(mn, v);
+                mx = _mm256_max_epi32(mx, v);
+                s0 = _mm256_add_epi64(s0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+                s1 = _mm256_add_epi64(s1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+            }
+        }
+        int minimos[8], maximos[8];
+        long long sumas[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(minimos), mn);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(maximos), mx);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sumas), s0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sumas + 4), s1);
+        int minimo, maximo;
+        extremos(minimos, maximos, minimo, maximo);
+        long long suma = 0;
+        for (int k = 0; k < 8; k++) {
+            suma += sumas[k];
+        }
+        return cerrar<int>(i, suma, 0.0, minimo, maximo, datos + i, n - i);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static void neumaierAvx2(__m256d& s, __m256d& c, __m256d x) {
+        const __m256d signo = _mm256_set1_pd(-0.0);
+        __m256d t = _mm256_add_pd(s, x);
+        __m256d mayor = _mm256_cmp_pd(_mm256_andnot_pd(signo, s), _mm256_andnot_pd(signo, x), _CMP_GE_OQ);
+        __m256d a = _mm256_add_pd(_mm256_sub_pd(s, t), x);
+        __m256d b = _mm256_add_pd(_mm256_sub_pd(x, t), s);
+        c = _mm256_add_pd(c, _mm256_blendv_pd(b, a, mayor));
+        s = t;
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static ResumenSegmento<double> resumirAvx2(const double* datos, std::size_t n) {
+        std::size_t i = 0;
+        __m256d mn = _mm256_setzero_pd(), mx = mn;
+        __m256d s0 = _mm256_setzero_pd(), c0 = _mm256_setzero_pd();
+        __m256d s1 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+        if (n >= 8) {
+            mn = mx = _mm256_loadu_pd(datos);
+            for (; i + 8 <= n; i += 8) {
+                __m256d v0 = _mm256_loadu_pd(datos + i);
+                __m256d v1 = _mm256_loadu_pd(datos + i + 4);
+                mn = _mm256_min_pd(mn, _mm256_min_pd(v0, v1));
+                mx = _mm256_max_pd(mx, _mm256_max_pd(v0, v1));
+                neumaierAvx2(s0, c0, v0);
+                neumaierAvx2(s1, c1, v1);
+            }
+        }
+        double minimos[4], maximos[4], sumas[8], errores[8];
+        _mm256_storeu_pd(minimos, mn);
+        _mm256_storeu_pd(maximos, mx);
+        _mm256_storeu_pd(sumas, s0);
+        _mm256_storeu_pd(sumas + 4, s1);
+        _mm256_storeu_pd(errores, c0);
+        _mm256_storeu_pd(errores + 4, c1);
+        double minimo, maximo, suma, compensacion;
+        extremos(minimos, maximos, minimo, maximo);
+        reducirCompensado(sumas, errores, suma, compensacion);
+        return cerrar<double>(i, suma, compensacion, minimo, maximo, datos + i, n - i);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static double reducirAvx2(__m256d a) {
+        double sumas[4];
+        _mm256_storeu_pd(sumas, a);
+        return (sumas[0] + sumas[1]) + (sumas[2] + sumas[3]);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static double desviacionAvx2(const float* datos, std::size_t n, double media) {
+        const __m256d m = _mm256_set1_pd(media);
+        __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 v = _mm256_loadu_ps(datos + i);
+            __m256d d0 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), m);
+            __m256d d1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), m);
+            a0 = _mm256_add_pd(a0, _mm256_mul_pd(d0, d0));
+            a1 = _mm256_add_pd(a1, _mm256_mul_pd(d1, d1));
+        }
+        return reducirAvx2(_mm256_add_pd(a0, a1)) + desviacionEscalar(datos + i, n - i, media);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static double desviacionAvx2(const int* datos, std::size_t n, double media) {
+        const __m256d m = _mm256_set1_pd(media);
+        __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i));
+            __m256d d0 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(v)), m);
+            __m256d d1 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)), m);
+            a0 = _mm256_add_pd(a0, _mm256_mul_pd(d0, d0));
+            a1 = _mm256_add_pd(a1, _mm256_mul_pd(d1, d1));
+        }
+        return reducirAvx2(_mm256_add_pd(a0, a1)) + desviacionEscalar(datos + i, n - i, media);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static double desviacionAvx2(const double* datos, std::size_t n, double media) {
+        const __m256d m = _mm256_set1_pd(media);
+        __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(datos + i), m);
+            __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(datos + i + 4), m);
+            a0 = _mm256_add_pd(a0, _mm256_mul_pd(d0, d0));
+            a1 = _mm256_add_pd(a1, _mm256_mul_pd(d1, d1));
+        }
+        return reducirAvx2(_mm256_add_pd(a0, a1)) + desviacionEscalar(datos + i, n - i, media);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static std::size_t contarAvx2(const float* datos, std::size_t n, float minimo, float maximo) {
+        const __m256 lo = _mm256_set1_ps(minimo), hi = _mm256_set1_ps(maximo);
+        std::size_t total = 0;
+        std::size_t i = 0;
+        while (i + 8 <= n) {
+            std::size_t fin = (n - i > BLOQUE_CONTEO) ? i + BLOQUE_CONTEO : n;
+            __m256i cuenta = _mm256_setzero_si256();
+            for (; i + 8 <= fin; i += 8) {
+                __m256 v = _mm256_loadu_ps(datos + i);
+                __m256 dentro = _mm256_and_ps(_mm256_cmp_ps(v, lo, _CMP_GE_OQ), _mm256_cmp_ps(v, hi, _CMP_LE_OQ));
+                cuenta = _mm256_sub_epi32(cuenta, _mm256_castps_si256(dentro));
+            }
+            std::uint32_t carriles[8];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(carriles), cuenta);
+            for (int k = 0; k < 8; k++) {
+                total += carriles[k];
+            }
+        }
+        return total + contarEscalar(datos + i, n - i, minimo, maximo);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static std::size_t contarAvx2(const int* datos, std::size_t n, int minimo, int maximo) {
+        const __m256i lo = _mm256_set1_epi32(minimo), hi = _mm256_set1_epi32(maximo);
+        std::size_t fuera = 0;
+        std::size_t i = 0;
+        while (i + 8 <= n) {
+            std::size_t fin = (n - i > BLOQUE_CONTEO) ? i + BLOQUE_CONTEO : n;
+            __m256i cuenta = _mm256_setzero_si256();
+            for (; i + 8 <= fin; i += 8) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i));
+                __m256i afuera = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+                cuenta = _mm256_sub_epi32(cuenta, afuera);
+            }
+            std::uint32_t carriles[8];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(carriles), cuenta);
+            for (int k = 0; k < 8; k++) {
+                fuera += carriles[k];
+            }
+        }
+        return (i - fuera) + contarEscalar(datos + i, n - i, minimo, maximo);
+    }
+
+    SISTEMAIOT_OBJETIVO("avx2")
+    static std::size_t contarAvx2(const double* datos, std::size_t n, double minimo, double maximo) {
+        const __m256d lo = _mm256_set1_pd(minimo), hi = _mm256_set1_pd(maximo);
+        __m256i cuenta = _mm256_setzero_si256();
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d v = _mm256_loadu_pd(datos + i);
+            __m256d dentro = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ), _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+            cuenta = _mm256_sub_epi64(cuenta, _mm256_castpd_si256(dentro));
+        }
+        std::uint64_t carriles[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(carriles), cuenta);
+        return static_cast<std::size_t>(carriles[0] + carriles[1] + carriles[2] + carriles[3]) +
+               contarEscalar(datos + i, n - i, minimo, maximo);
+    }
+#endif
+};
+
+/**
+ * Tramo contiguo [inicio, fin) de un historial. Sus iteradores son
+ * punteros (acceso aleatorio), así que admite cualquier algoritmo de la
+ * biblioteca estándar, incluidas las políticas std::execution.
+ */
+template <typename T>
+struct TramoLecturas {
+    const T* inicio;
+    const T* fin;
+
+    TramoLecturas() : inicio(nullptr), fin(nullptr) {}
+    TramoLecturas(const T* desde, const T* hasta) : inicio(desde), fin(hasta) {}
+
+    const T* begin() const { return inicio; }
+    const T* end() const { return fin; }
+    std::size_t size() const { return static_cast<std::size_t>(fin - inicio); }
+    bool empty() const { return inicio == fin; }
+};
+
+/**
+ * Recorridos de un historial completo por segmentos contiguos. Historial
+ * es cualquier contenedor con paraCadaSegmento(f(const T*, n)).
+ */
+template <typename T, typename Historial>
+ResumenSegmento<T> resumirHistorial(const Historial& historial) {
+    ResumenSegmento<T> total;
+    historial.paraCadaSegmento([&](const T* datos, int n) {
+        total.combinar(KernelesAnalitica::resumir(datos, static_cast<std::size_t>(n)));
+    });
+    return total;
+}
+
+/** Varianza poblacional con la media ya conocida (segunda pasada) */
+template <typename T, typename Historial>
+double varianzaHistorial(const Historial& historial, double media, std::size_t cantidad) {
+    if (cantidad == 0) {
+        return 0.0;
+    }
+    double suma = 0.0;
+    historial.paraCadaSegmento([&](const T* datos, int n) {
+        suma += KernelesAnalitica::sumaCuadradosDesviacion(datos, static_cast<std::size_t>(n), media);
+    });
+    return suma / static_cast<double>(cantidad);
+}
+
+template <typename T, typename Historial>
+std::size_t contarEnRangoHistorial(const Historial& historial, T minimo, T maximo) {
+    std::size_t total = 0;
+    historial.paraCadaSegmento([&](const T* datos, int n) {
+        total += KernelesAnalitica::contarEnRango(datos, static_cast<std::size_t>(n), minimo, maximo);
+    });
+    return total;
+}
+
+#endif // KERNELES_ANALITICA_HPP
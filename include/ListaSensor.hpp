@@ -2,185 +2,370 @@
 #define LISTA_SENSOR_HPP
 
 #include <iostream>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AsignadorNodos.hpp"
+#include "Bitacora.hpp"
+#include "EstadisticasHistorial.hpp"
+#include "MarcasTiempo.hpp"
 
 
-template <typename T>
-struct Nodo {
-    T dato;              
-    Nodo<T>* siguiente;  
-
-    /**
-param valor Valor a almacenar en el nodo
-     */
-    Nodo(T valor) : dato(valor), siguiente(nullptr) {}
-};
-
 /**
 
  * Implementa operaciones básicas de una lista enlazada simple
  * incluyendo inserción, búsqueda y eliminación de nodos.
  * Cumple con la Regla de los Tres: Destructor, Constructor de Copia
  * y Operador de Asignación.
+ *
+ * Mantiene un puntero a la cola, por lo que anexar al final es O(1)
+ * y llenar (o copiar) un historial de N lecturas cuesta O(N).
+ *
+ * Los nodos se obtienen de una política de asignación (ver
+ * AsignadorNodos.hpp). Memoria por lectura con float en x86-64/glibc,
+ * medida con 10^6 lecturas:
+ *  - AsignadorNew:         32.0 bytes (nodo de 16 + cabecera de malloc)
+ *  - AsignadorSlab:        16.8 bytes (predeterminado, bloques contiguos)
+ *  - AsignadorSlabIndices: 12.6 bytes (enlaces de 32 bits; 8.4 sin la marca de tiempo)
+ *
+ * Suma, cantidad, mínimo y máximo se mantienen al insertar y eliminar
+ * (EstadisticasHistorial), así que calcularPromedio y obtenerMinimo son
+ * O(1). El primer eliminarMinimo construye un monticulo de nodos vivos;
+ * desde entonces cada eliminación es O(log n): el nodo sólo se marca y
+ * se desenlaza en lote cuando las marcas superan a los nodos vivos.
+ *
+ * Cada nodo lleva el instante de su lectura como delta-de-delta de 32
+ * bits (MarcasTiempo.hpp); con float/int ocupa el relleno de Nodo. El
+ * índice disperso `puntos` guarda un nodo cada LECTURAS_POR_PUNTO con su
+ * instante, así que paraCadaEnIntervalo busca el tramo inicial en
+ * O(log n) y sólo recorre las lecturas del intervalo (más las de un
+ * tramo). insertar() sin instante repite el de la lectura anterior.
  */
-template <typename T>
+template <typename T, typename Asignador = AsignadorSlab<T> >
 class ListaSensor {
 private:
-    Nodo<T>* cabeza;     ///< Puntero al primer nodo
-    int cantidad;        ///< Cantidad de elementos en la lista
+    typedef typename Asignador::NodoT NodoT;
+
+    Asignador asignador; ///< Política que crea y libera los nodos
+    NodoT* cabeza;       ///< Puntero al primer nodo
+    NodoT* cola;         ///< Puntero al último nodo (anexado O(1))
+    int cantidad;        ///< Cantidad de elementos vivos en la lista
+    int eliminados;      ///< Nodos marcados pendientes de desenlazar
+
+    EstadisticasHistorial<T> estadisticas;  ///< Suma/mín/máx incrementales
+    /// Entrada del montículo; `orden` es su posición en la lista para
+    /// que entre iguales salga siempre la primera aparición
+    struct EntradaMinimo {
+        NodoT* nodo;
+        std::uint64_t orden;
+    };
+    std::vector<EntradaMinimo> monticulo;   ///< Montículo de mínimos (perezoso)
+    std::uint64_t proximoOrden;             ///< Orden del próximo nodo anexado
+    bool indiceActivo;                      ///< true si monticulo está vigente
+
+    CodificadorMarcas marcas;                   ///< Instante y delta de la última lectura
+    std::vector<PuntoTiempo<NodoT*> > puntos;   ///< Índice temporal disperso (un punto por tramo)
+    int enTramo;                                ///< Nodos del tramo actual
 
 public:
+    static const int LECTURAS_POR_PUNTO = 64;   ///< Nodos por tramo del índice temporal
 
-    ListaSensor() : cabeza(nullptr), cantidad(0) {}
+    ListaSensor() : cabeza(nullptr), cola(nullptr), cantidad(0), eliminados(0),
+                    proximoOrden(0), indiceActivo(false), enTramo(0) {}
 
 
     ~ListaSensor() {
         limpiar();
     }
 
-    ListaSensor(const ListaSensor& otra) : cabeza(nullptr), cantidad(0) {
-        Nodo<T>* actual = otra.cabeza;
-        while (actual != nullptr) {
-            insertar(actual->dato);
-            actual = actual->siguiente;
-        }
+    ListaSensor(const ListaSensor& otra)
+        : cabeza(nullptr), cola(nullptr), cantidad(0), eliminados(0), proximoOrden(0), indiceActivo(false), enTramo(0) {
+        copiarDesde(otra);
     }
 
 
     ListaSensor& operator=(const ListaSensor& otra) {
         if (this != &otra) {
             limpiar();
-            cantidad = 0;
-            Nodo<T>* actual = otra.cabeza;
-            while (actual != nullptr) {
-                insertar(actual->dato);
-                actual = actual->siguiente;
-            }
+            copiarDesde(otra);
         }
         return *this;
     }
 
+    /** Constructor de movimiento: traspasa nodos, asignador y estadísticas
+     *  en O(1); la otra lista queda vacía
+     */
+    ListaSensor(ListaSensor&& otra) noexcept
+        : cabeza(nullptr), cola(nullptr), cantidad(0), eliminados(0), proximoOrden(0), indiceActivo(false), enTramo(0) {
+        intercambiar(otra);
+    }
+
+    ListaSensor& operator=(ListaSensor&& otra) noexcept {
+        if (this != &otra) {
+            limpiar();
+            intercambiar(otra);
+        }
+        return *this;
+    }
+
+    /** Intercambia el contenido completo con otra lista en O(1) */
+    void intercambiar(ListaSensor& otra) noexcept {
+        asignador.intercambiar(otra.asignador);
+        std::swap(cabeza, otra.cabeza);
+        std::swap(cola, otra.cola);
+        std::swap(cantidad, otra.cantidad);
+        std::swap(eliminados, otra.eliminados);
+        std::swap(estadisticas, otra.estadisticas);
+        monticulo.swap(otra.monticulo);
+        std::swap(proximoOrden, otra.proximoOrden);
+        std::swap(indiceActivo, otra.indiceActivo);
+        std::swap(marcas, otra.marcas);
+        puntos.swap(otra.puntos);
+        std::swap(enTramo, otra.enTramo);
+    }
+
 
     void insertar(T valor) {
-        Nodo<T>* nuevoNodo = new Nodo<T>(valor);
-        
-        if (cabeza == nullptr) {
-            cabeza = nuevoNodo;
+        anexar(std::move(valor));
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Nodo insertado. Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta una lectura tomada en instanteMs (ms del reloj del sistema) */
+    void insertarEn(T valor, std::int64_t instanteMs) {
+        anexarEn(instanteMs, std::move(valor));
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Nodo insertado. Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Construye la lectura directamente en el nodo con los argumentos
+     *  del constructor de T (sin temporal intermedio)
+     */
+    template <typename... Args>
+    void emplazar(Args&&... args) {
+        anexar(std::in_place, std::forward<Args>(args)...);
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Nodo emplazado. Cantidad actual: " << cantidad;
+        });
+    }
+
+    /**
+     * Mueve al final de esta lista todas las lecturas de otra, que queda
+     * vacía. Si esta lista está vacía, o con nodos independientes
+     * (AsignadorNew), es O(1): se traspasan o reenlazan los nodos. Con los
+     * asignadores por bloques los nodos viven en los bloques de la otra
+     * lista, así que los valores se mueven uno a uno (sin copiar T) y la
+     * otra suelta sus bloques.
+     */
+    void empalmar(ListaSensor& otra) {
+        if (&otra == this || otra.cantidad == 0) {
+            return;
+        }
+        int movidas = otra.cantidad;
+        if (cantidad == 0) {
+            limpiar();
+            intercambiar(otra);
+        } else if (!Asignador::liberaEnBloque && otra.puntos.front().instanteMs >= marcas.obtenerUltimo()) {
+            // Los tramos de la otra lista siguen a los nuestros sin romper el orden temporal
+            asignador.enlazar(cola, otra.cabeza);
+            cola = otra.cola;
+            cantidad += otra.cantidad;
+            eliminados += otra.eliminados;
+            estadisticas.combinar(otra.estadisticas);
+            puntos.insert(puntos.end(), otra.puntos.begin(), otra.puntos.end());
+            marcas = otra.marcas;
+            enTramo = otra.enTramo;
+            // El montículo se vuelve a construir en el próximo eliminarMinimo
+            monticulo.clear();
+            indiceActivo = false;
+            otra.cabeza = nullptr;
+            otra.cola = nullptr;
+            otra.limpiar();
         } else {
-            Nodo<T>* actual = cabeza;
-            while (actual->siguiente != nullptr) {
-                actual = actual->siguiente;
-            }
-            actual->siguiente = nuevoNodo;
+            otra.recorrerConInstante(0, [&](NodoT* n, std::int64_t instante) {
+                if (!otra.asignador.estaEliminado(n)) {
+                    anexarEn(instante, std::move(n->dato));
+                }
+                return true;
+            });
+            otra.limpiar();
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << movidas << " nodo(s) empalmado(s). Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta en bloque n valores consecutivos (un solo mensaje de log)
+     */
+    void insertarVarios(const T* valores, int n) {
+        if (valores == nullptr || n <= 0) {
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            anexar(valores[i]);
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << n << " nodo(s) insertado(s). Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta en bloque n valores tomados en el mismo instante */
+    void insertarVariosEn(const T* valores, int n, std::int64_t instanteMs) {
+        if (valores == nullptr || n <= 0) {
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            anexarEn(instanteMs, valores[i]);
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << n << " nodo(s) insertado(s). Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta en bloque n valores, cada uno con su instante (p. ej. al restaurar) */
+    void insertarVariosEn(const T* valores, const std::int64_t* instantes, int n) {
+        if (valores == nullptr || instantes == nullptr || n <= 0) {
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            anexarEn(instantes[i], valores[i]);
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << n << " nodo(s) insertado(s). Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta en bloque el rango [primero, ultimo). Con std::make_move_iterator
+     *  los valores se mueven en lugar de copiarse.
+     */
+    template <typename Iterador>
+    void insertarRango(Iterador primero, Iterador ultimo) {
+        int insertados = 0;
+        for (; primero != ultimo; ++primero) {
+            anexar(*primero);
+            insertados++;
+        }
+        if (insertados > 0) {
+            BitacoraPredeterminada::registrar([&](auto& os) {
+                os << "[Log] " << insertados << " nodo(s) insertado(s). Cantidad actual: "
+                   << cantidad;
+            });
         }
-        cantidad++;
-        std::cout << "[Log] Nodo insertado. Cantidad actual: " << cantidad << std::endl;
     }
 
     bool buscar(T valor) const {
-        Nodo<T>* actual = cabeza;
+        NodoT* actual = cabeza;
         while (actual != nullptr) {
-            if (actual->dato == valor) {
+            if (actual->dato == valor && !asignador.estaEliminado(actual)) {
                 return true;
             }
-            actual = actual->siguiente;
+            actual = asignador.siguiente(actual);
         }
         return false;
     }
 
     T& obtenerPrimero() {
-        if (cabeza == nullptr) {
+        NodoT* actual = cabeza;
+        while (actual != nullptr && asignador.estaEliminado(actual)) {
+            actual = asignador.siguiente(actual);
+        }
+        if (actual == nullptr) {
             throw std::runtime_error("Lista vacía");
         }
-        return cabeza->dato;
+        return actual->dato;
     }
 
 
     T obtenerMinimo() const {
-        if (cabeza == nullptr) {
+        if (cantidad == 0) {
             throw std::runtime_error("Lista vacía");
         }
-        
-        T minimo = cabeza->dato;
-        Nodo<T>* actual = cabeza->siguiente;
-        
-        while (actual != nullptr) {
-            if (actual->dato < minimo) {
-                minimo = actual->dato;
-            }
-            actual = actual->siguiente;
+        return estadisticas.obtenerMinimo();
+    }
+
+    T obtenerMaximo() const {
+        if (cantidad == 0) {
+            throw std::runtime_error("Lista vacía");
         }
-        return minimo;
+        return estadisticas.obtenerMaximo();
     }
 
     bool eliminarMinimo() {
-        if (cabeza == nullptr) {
+        if (cantidad == 0) {
             return false;
         }
 
-        if (cantidad == 1) {
-            T valorEliminado = cabeza->dato;
-            delete cabeza;
-            cabeza = nullptr;
-            cantidad = 0;
-            std::cout << "[Log] Nodo<T> " << valorEliminado << " liberado." << std::endl;
-            return true;
+        if (!indiceActivo) {
+            construirIndice();
         }
 
-        // Si el mínimo es la cabeza
-        if (cabeza->dato <= (cabeza->siguiente != nullptr ? cabeza->siguiente->dato : cabeza->dato)) {
-            Nodo<T>* temp = cabeza;
-            T valorEliminado = cabeza->dato;
-            cabeza = cabeza->siguiente;
-            delete temp;
-            cantidad--;
-            std::cout << "[Log] Nodo<T> " << valorEliminado << " liberado." << std::endl;
-            return true;
-        }
+        std::pop_heap(monticulo.begin(), monticulo.end(), MayorDato());
+        NodoT* nodoMinimo = monticulo.back().nodo;
+        monticulo.pop_back();
 
-        // Buscar el mínimo en el resto
-        Nodo<T>* actual = cabeza;
-        Nodo<T>* anterior = nullptr;
-        T minimo = cabeza->dato;
-        Nodo<T>* nodoMinimo = cabeza;
-        Nodo<T>* anteriorMinimo = nullptr;
+        T minimo = nodoMinimo->dato;
+        asignador.marcarEliminado(nodoMinimo);
+        cantidad--;
+        eliminados++;
+        estadisticas.quitar(minimo);
 
-        while (actual != nullptr) {
-            if (actual->dato < minimo) {
-                minimo = actual->dato;
-                nodoMinimo = actual;
-                anteriorMinimo = anterior;
+        if (cantidad == 0) {
+            limpiar();
+        } else {
+            estadisticas.fijarMinimo(monticulo.front().nodo->dato);
+            if (!estadisticas.tieneMaximo()) {
+                // Sólo ocurre si todas las lecturas eran iguales al mínimo
+                estadisticas.fijarMaximo(minimo);
+            }
+            if (eliminados > cantidad) {
+                compactar();
             }
-            anterior = actual;
-            actual = actual->siguiente;
         }
 
-        if (anteriorMinimo != nullptr) {
-            anteriorMinimo->siguiente = nodoMinimo->siguiente;
-        }
-        delete nodoMinimo;
-        cantidad--;
-        std::cout << "[Log] Nodo<T> " << minimo << " liberado." << std::endl;
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Nodo<T> " << minimo << " liberado.";
+        });
         return true;
     }
 
 
     double calcularPromedio() const {
-        if (cabeza == nullptr) {
-            throw std::runtime_error("Lista vacía");
-        }
+        return estadisticas.promedio();
+    }
 
-        T suma = 0;
-        Nodo<T>* actual = cabeza;
-        int contador = 0;
+    /** Estadísticas incrementales del historial (suma, mín, máx) */
+    const EstadisticasHistorial<T>& obtenerEstadisticas() const {
+        return estadisticas;
+    }
 
-        while (actual != nullptr) {
-            suma += actual->dato;
-            contador++;
-            actual = actual->siguiente;
-        }
+    /** Varianza poblacional. Los nodos no son contiguos, así que es un
+     *  recorrido escalar; las variantes por bloques usan los kernels SIMD.
+     */
+    double calcularVarianza() const {
+        double media = estadisticas.promedio();
+        double suma = 0.0;
+        paraCada([&](const T& valor) {
+            double d = static_cast<double>(valor) - media;
+            suma += d * d;
+        });
+        return suma / static_cast<double>(cantidad);
+    }
 
-        return static_cast<double>(suma) / contador;
+    /** Cantidad de lecturas con minimo <= x <= maximo */
+    int contarEnRango(const T& minimo, const T& maximo) const {
+        int total = 0;
+        paraCada([&](const T& valor) {
+            total += (!(valor < minimo) && !(maximo < valor)) ? 1 : 0;
+        });
+        return total;
     }
 
     int obtenerCantidad() const {
@@ -190,16 +375,18 @@ public:
     /** Imprime todos los elementos de la lista
      */
     void imprimir() const {
-        if (cabeza == nullptr) {
+        if (cantidad == 0) {
             std::cout << "[Lista vacía]" << std::endl;
             return;
         }
 
-        Nodo<T>* actual = cabeza;
+        NodoT* actual = cabeza;
         std::cout << "Elementos: ";
         while (actual != nullptr) {
-            std::cout << actual->dato << " ";
-            actual = actual->siguiente;
+            if (!asignador.estaEliminado(actual)) {
+                std::cout << actual->dato << " ";
+            }
+            actual = asignador.siguiente(actual);
         }
         std::cout << std::endl;
     }
@@ -209,22 +396,302 @@ public:
      true si está vacía, false en caso contrario
      */
     bool estaVacia() const {
-        return cabeza == nullptr;
+        return cantidad == 0;
     }
 
+    /** Llama funcion(const T&) por cada lectura viva, de la más antigua a
+     *  la más reciente
+     */
+    template <typename Funcion>
+    void paraCada(Funcion funcion) const {
+        for (NodoT* actual = cabeza; actual != nullptr; actual = asignador.siguiente(actual)) {
+            if (!asignador.estaEliminado(actual)) {
+                funcion(static_cast<const T&>(actual->dato));
+            }
+        }
+    }
+
+    /** Llama funcion(const T&, std::int64_t instanteMs) por cada lectura
+     *  viva, de la más antigua a la más reciente
+     */
+    template <typename Funcion>
+    void paraCadaConInstante(Funcion funcion) const {
+        if (puntos.empty()) {
+            return;
+        }
+        recorrerConInstante(0, [&](NodoT* n, std::int64_t instante) {
+            if (!asignador.estaEliminado(n)) {
+                funcion(static_cast<const T&>(n->dato), instante);
+            }
+            return true;
+        });
+    }
+
+    /**
+     * Llama funcion(const T&, std::int64_t instanteMs) por cada lectura
+     * viva con desdeMs <= instante <= hastaMs, en orden. El tramo inicial
+     * sale del índice en O(log n) y el recorrido se detiene en la primera
+     * lectura posterior a hastaMs.
+     */
+    template <typename Funcion>
+    void paraCadaEnIntervalo(std::int64_t desdeMs, std::int64_t hastaMs, Funcion funcion) const {
+        if (puntos.empty() || hastaMs < desdeMs) {
+            return;
+        }
+        std::size_t p = buscarPuntoTiempo(puntos.size(), desdeMs,
+                                          [this](std::size_t i) { return puntos[i].instanteMs; });
+        recorrerConInstante(p, [&](NodoT* n, std::int64_t instante) {
+            if (instante > hastaMs) {
+                return false;
+            }
+            if (instante >= desdeMs && !asignador.estaEliminado(n)) {
+                funcion(static_cast<const T&>(n->dato), instante);
+            }
+            return true;
+        });
+    }
+
+    /** Instante de la lectura más reciente (0 si nunca hubo lecturas) */
+    std::int64_t obtenerUltimoInstante() const {
+        return marcas.obtenerUltimo();
+    }
+
+    /**
+     * Iterador de avance (forward) de sólo lectura sobre las lecturas
+     * vivas, en el mismo orden que paraCada: salta los nodos con marca de
+     * borrado diferido. No hay versión mutable porque escribir una lectura
+     * dejaría desfasadas las estadísticas incrementales. Lo invalida
+     * cualquier operación que modifique la lista.
+     */
+    class IteradorConst {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        IteradorConst() : asignador(nullptr), nodo(nullptr) {}
+
+        reference operator*() const { return nodo->dato; }
+        pointer operator->() const { return &nodo->dato; }
+
+        IteradorConst& operator++() {
+            nodo = asignador->siguiente(nodo);
+            saltarEliminados();
+            return *this;
+        }
+
+        IteradorConst operator++(int) {
+            IteradorConst previo = *this;
+            ++(*this);
+            return previo;
+        }
+
+        friend bool operator==(const IteradorConst& a, const IteradorConst& b) {
+            return a.nodo == b.nodo;
+        }
+
+        friend bool operator!=(const IteradorConst& a, const IteradorConst& b) {
+            return a.nodo != b.nodo;
+        }
+
+    private:
+        friend class ListaSensor;
+
+        // El asignador resuelve los enlaces (índices de 32 bits en AsignadorSlabIndices)
+        IteradorConst(const Asignador* a, NodoT* n) : asignador(a), nodo(n) {
+            saltarEliminados();
+        }
+
+        void saltarEliminados() {
+            while (nodo != nullptr && asignador->estaEliminado(nodo)) {
+                nodo = asignador->siguiente(nodo);
+            }
+        }
+
+        const Asignador* asignador;
+        NodoT* nodo;
+    };
+
+    typedef T value_type;
+    typedef IteradorConst const_iterator;
+    typedef IteradorConst iterator;
+
+    const_iterator begin() const { return IteradorConst(&asignador, cabeza); }
+    const_iterator end() const { return IteradorConst(&asignador, nullptr); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
 private:
+    /** Comparador que convierte std::*_heap en un monticulo de mínimos;
+     *  entre iguales sale primero el más antiguo, así que eliminarMinimo
+     *  da el mismo resultado tras reproducir el diario sobre una instantánea
+     */
+    struct MayorDato {
+        bool operator()(const EntradaMinimo& a, const EntradaMinimo& b) const {
+            if (b.nodo->dato < a.nodo->dato) {
+                return true;
+            }
+            return !(a.nodo->dato < b.nodo->dato) && b.orden < a.orden;
+        }
+    };
+
+    /** Construye el monticulo con los nodos vivos (O(n), una sola vez) */
+    void construirIndice() {
+        monticulo.clear();
+        monticulo.reserve(cantidad);
+        proximoOrden = 0;
+        for (NodoT* actual = cabeza; actual != nullptr; actual = asignador.siguiente(actual)) {
+            if (!asignador.estaEliminado(actual)) {
+                EntradaMinimo entrada = { actual, proximoOrden++ };
+                monticulo.push_back(entrada);
+            }
+        }
+        std::make_heap(monticulo.begin(), monticulo.end(), MayorDato());
+        indiceActivo = true;
+    }
+
+    /** Desenlaza y libera los nodos marcados. Como sólo ocurre cuando las
+     *  marcas superan a los vivos, su costo O(n) se amortiza en O(1). En
+     *  la misma pasada vuelve a codificar los instantes de los nodos que
+     *  quedan y reconstruye el índice temporal.
+     */
+    void compactar() {
+        std::vector<PuntoTiempo<NodoT*> > anteriores;
+        anteriores.swap(puntos);
+        marcas.reiniciar();
+        enTramo = 0;
+        DecodificadorMarcas reloj;
+        std::size_t p = 0;
+
+        NodoT* anterior = nullptr;
+        NodoT* actual = cabeza;
+        while (actual != nullptr) {
+            NodoT* sig = asignador.siguiente(actual);
+            std::int64_t instante;
+            if (p < anteriores.size() && actual == anteriores[p].posicion) {
+                reloj.situar(anteriores[p++]);
+                instante = reloj.instante;
+            } else {
+                instante = reloj.avanzar(actual->marca);
+            }
+            if (asignador.estaEliminado(actual)) {
+                if (anterior == nullptr) {
+                    cabeza = sig;
+                } else {
+                    asignador.enlazar(anterior, sig);
+                }
+                asignador.destruir(actual);
+            } else {
+                marcar(actual, instante);
+                anterior = actual;
+            }
+            actual = sig;
+        }
+        cola = anterior;
+        eliminados = 0;
+    }
+
     /**
-     Limpia todos los nodos de la lista
+     * Recorre los nodos, vivos o marcados, desde el punto p del índice con
+     * el instante de cada uno; visitar(NodoT*, instante) retorna false
+     * para detenerse.
+     */
+    template <typename Visitar>
+    void recorrerConInstante(std::size_t p, Visitar visitar) const {
+        DecodificadorMarcas reloj;
+        for (NodoT* n = puntos[p].posicion; n != nullptr; n = asignador.siguiente(n)) {
+            std::int64_t instante;
+            if (p < puntos.size() && n == puntos[p].posicion) {
+                reloj.situar(puntos[p++]);
+                instante = reloj.instante;
+            } else {
+                instante = reloj.avanzar(n->marca);
+            }
+            if (!visitar(n, instante)) {
+                return;
+            }
+        }
+    }
+
+    /** Codifica el instante del nodo recién anexado; abre un tramo (y un
+     *  punto del índice) cada LECTURAS_POR_PUNTO nodos
+     */
+    void marcar(NodoT* nodo, std::int64_t instanteMs) {
+        std::int64_t instante = marcas.normalizar(instanteMs);
+        if (enTramo == LECTURAS_POR_PUNTO || marcas.excedeTramo(instante)) {
+            PuntoTiempo<NodoT*> punto = { instante, 0, nodo };
+            puntos.push_back(punto);
+            marcas.abrirTramo(instante);
+            nodo->marca = 0;
+            enTramo = 1;
+        } else {
+            nodo->marca = marcas.codificar(instante);
+            enTramo++;
+        }
+    }
+
+    /** Anexa sin instante propio: repite el de la lectura anterior */
+    template <typename... Args>
+    void anexar(Args&&... args) {
+        anexarEn(marcas.obtenerUltimo(), std::forward<Args>(args)...);
+    }
+
+    /** Enlaza un nuevo nodo después de la cola en O(1), sin log; los
+     *  argumentos van al constructor del nodo (valor o std::in_place, ...)
+     */
+    template <typename... Args>
+    void anexarEn(std::int64_t instanteMs, Args&&... args) {
+        NodoT* nuevoNodo = asignador.crear(std::forward<Args>(args)...);
+        if (cola == nullptr) {
+            cabeza = nuevoNodo;
+        } else {
+            asignador.enlazar(cola, nuevoNodo);
+        }
+        cola = nuevoNodo;
+        cantidad++;
+        marcar(nuevoNodo, instanteMs);
+        estadisticas.agregar(nuevoNodo->dato);
+        if (indiceActivo) {
+            EntradaMinimo entrada = { nuevoNodo, proximoOrden++ };
+            monticulo.push_back(entrada);
+            std::push_heap(monticulo.begin(), monticulo.end(), MayorDato());
+        }
+    }
+
+    /** Copia en orden todos los nodos de otra lista (lineal)
+     */
+    void copiarDesde(const ListaSensor& otra) {
+        otra.paraCadaConInstante([this](const T& valor, std::int64_t instante) {
+            anexarEn(instante, valor);
+        });
+    }
+
+    /**
+     Limpia todos los nodos de la lista. Con un asignador por bloques y
+     un T trivial se sueltan los bloques completos sin recorrer los nodos.
      */
     void limpiar() {
-        Nodo<T>* actual = cabeza;
-        while (actual != nullptr) {
-            Nodo<T>* temp = actual;
-            actual = actual->siguiente;
-            delete temp;
+        if (!Asignador::liberaEnBloque || !std::is_trivially_destructible<T>::value) {
+            NodoT* actual = cabeza;
+            while (actual != nullptr) {
+                NodoT* temp = actual;
+                actual = asignador.siguiente(actual);
+                asignador.destruir(temp);
+            }
         }
+        asignador.liberarTodo();
         cabeza = nullptr;
+        cola = nullptr;
         cantidad = 0;
+        eliminados = 0;
+        estadisticas.reiniciar();
+        monticulo.clear();
+        indiceActivo = false;
+        marcas.reiniciar();
+        puntos.clear();
+        enTramo = 0;
     }
 };
 
@@ -0,0 +1,791 @@
+#ifndef LISTA_SENSOR_BLOQUES_HPP
+#define LISTA_SENSOR_BLOQUES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Bitacora.hpp"
+#include "EstadisticasHistorial.hpp"
+#include "KernelesAnalitica.hpp"
+#include "MarcasTiempo.hpp"
+
+
+/**
+ * Nodo de una lista desenrollada: guarda hasta N lecturas contiguas.
+ * Los datos van al inicio y alineados a 64 bytes para que un recorrido
+ * lea líneas de caché completas.
+ */
+template <typename T, int N>
+struct NodoBloque {
+    alignas(64) T datos[N];     ///< Lecturas contiguas del bloque
+    std::int32_t marcas[N];     ///< Delta-de-delta de cada instante; marcas[0] no se usa
+    int usados;                 ///< Ranuras ocupadas [0, usados); 0 = vacío pendiente de soltar
+    std::uint32_t punto;        ///< Su posición en el índice temporal (va en el relleno)
+    NodoBloque<T, N>* siguiente;
+
+    NodoBloque() : usados(0), punto(0), siguiente(nullptr) {}
+};
+
+/**
+ * Lista enlazada desenrollada (unrolled) con la misma interfaz pública
+ * que ListaSensor<T>.
+ *
+ * Cada nodo almacena un arreglo de N lecturas, así que los recorridos
+ * completos (promedio, mínimo, búsqueda, impresión) avanzan sobre memoria
+ * contigua y sólo siguen un puntero cada N elementos. Los segmentos
+ * contiguos se exponen con paraCadaSegmento() para kernels vectorizados
+ * y con segmentos() para los algoritmos estándar.
+ *
+ * Promedio y mínimo salen de EstadisticasHistorial en O(1); varianza y
+ * conteo por rango recorren los bloques con los kernels SIMD de
+ * KernelesAnalitica.hpp. Como en ListaSensor, el primer eliminarMinimo
+ * construye un montículo de mínimos de (valor, bloque); desde entonces
+ * cada eliminación es O(log n + N): sólo se desplazan las lecturas del
+ * bloque, así que los tramos siguen siendo contiguos. Un bloque que queda
+ * vacío no se desenlaza en el momento (no se conoce su anterior): los
+ * recorridos lo saltan y se sueltan en lote cuando superan a los bloques
+ * con lecturas, con costo amortizado O(1).
+ *
+ * Cada bloque es un tramo de marcas de tiempo (MarcasTiempo.hpp): el
+ * instante de su primera lectura va en el índice `puntos` (uno por
+ * bloque) y las demás guardan un delta-de-delta de 32 bits, así que
+ * paraCadaEnIntervalo busca el bloque inicial en O(log n).
+ */
+template <typename T, int N = 64>
+class ListaSensorBloques {
+    static_assert(N > 0, "El bloque debe tener al menos una ranura");
+
+private:
+    typedef NodoBloque<T, N> Bloque;
+
+    Bloque* cabeza;      ///< Primer bloque
+    Bloque* cola;        ///< Último bloque (anexado O(1))
+    int cantidad;        ///< Cantidad total de lecturas
+    int bloquesVacios;   ///< Bloques enlazados sin lecturas, pendientes de soltar
+    EstadisticasHistorial<T> estadisticas;  ///< Suma/mín/máx incrementales
+
+    /// Entrada del montículo: el bloque donde está una lectura con ese valor
+    struct EntradaMinimo {
+        T valor;
+        Bloque* bloque;
+    };
+    std::vector<EntradaMinimo> monticulo;   ///< Montículo de mínimos (perezoso)
+    bool indiceActivo;                      ///< true si monticulo está vigente
+
+    CodificadorMarcas marcas;                   ///< Instante y delta de la última lectura
+    std::vector<PuntoTiempo<Bloque*> > puntos;  ///< Índice temporal, un punto por bloque
+
+public:
+
+    ListaSensorBloques() : cabeza(nullptr), cola(nullptr), cantidad(0), bloquesVacios(0), indiceActivo(false) {}
+
+
+    ~ListaSensorBloques() {
+        limpiar();
+    }
+
+    ListaSensorBloques(const ListaSensorBloques& otra)
+        : cabeza(nullptr), cola(nullptr), cantidad(0), bloquesVacios(0), indiceActivo(false) {
+        copiarDesde(otra);
+    }
+
+
+    ListaSensorBloques& operator=(const ListaSensorBloques& otra) {
+        if (this != &otra) {
+            limpiar();
+            copiarDesde(otra);
+        }
+        return *this;
+    }
+
+    /** Constructor de movimiento: traspasa la cadena de bloques en O(1) */
+    ListaSensorBloques(ListaSensorBloques&& otra) noexcept
+        : cabeza(nullptr), cola(nullptr), cantidad(0), bloquesVacios(0), indiceActivo(false) {
+        intercambiar(otra);
+    }
+
+    ListaSensorBloques& operator=(ListaSensorBloques&& otra) noexcept {
+        if (this != &otra) {
+            limpiar();
+            intercambiar(otra);
+        }
+        return *this;
+    }
+
+    void intercambiar(ListaSensorBloques& otra) noexcept {
+        std::swap(cabeza, otra.cabeza);
+        std::swap(cola, otra.cola);
+        std::swap(cantidad, otra.cantidad);
+        std::swap(bloquesVacios, otra.bloquesVacios);
+        std::swap(estadisticas, otra.estadisticas);
+        monticulo.swap(otra.monticulo);
+        std::swap(indiceActivo, otra.indiceActivo);
+        std::swap(marcas, otra.marcas);
+        puntos.swap(otra.puntos);
+    }
+
+    /** Construye la lectura con los argumentos de T y la mueve a su ranura
+     *  (las ranuras del bloque ya están construidas)
+     */
+    template <typename... Args>
+    void emplazar(Args&&... args) {
+        anexar(T(std::forward<Args>(args)...));
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Nodo emplazado. Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Mueve al final todos los bloques de otra lista (se reenlazan, no
+     *  se copian); la otra queda vacía. Si sus lecturas son anteriores a
+     *  la última nuestra, se copian una a una con el instante normalizado.
+     */
+    void empalmar(ListaSensorBloques& otra) {
+        if (&otra == this || otra.cabeza == nullptr) {
+            return;
+        }
+        int movidas = otra.cantidad;
+        if (cola != nullptr && otra.puntos.front().instanteMs < marcas.obtenerUltimo()) {
+            otra.paraCadaConInstante([this](const T& valor, std::int64_t instante) {
+                anexarEn(instante, valor);
+            });
+            otra.limpiar();
+        } else {
+            if (cola == nullptr) {
+                cabeza = otra.cabeza;
+            } else {
+                cola->siguiente = otra.cabeza;
+            }
+            for (Bloque* b = otra.cabeza; b != nullptr; b = b->siguiente) {
+                b->punto += static_cast<std::uint32_t>(puntos.size());
+            }
+            cola = otra.cola;
+            cantidad += otra.cantidad;
+            bloquesVacios += otra.bloquesVacios;
+            estadisticas.combinar(otra.estadisticas);
+            puntos.insert(puntos.end(), otra.puntos.begin(), otra.puntos.end());
+            marcas = otra.marcas;
+            // El montículo se rehace en el próximo eliminarMinimo
+            monticulo.clear();
+            indiceActivo = false;
+            otra.cabeza = nullptr;
+            otra.cola = nullptr;
+            otra.cantidad = 0;
+            otra.bloquesVacios = 0;
+            otra.estadisticas.reiniciar();
+            otra.monticulo.clear();
+            otra.indiceActivo = false;
+            otra.marcas.reiniciar();
+            otra.puntos.clear();
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << movidas << " lectura(s) empalmada(s). Cantidad actual: " << cantidad;
+        });
+    }
+
+
+    void insertar(T valor) {
+        anexar(std::move(valor));
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Nodo insertado. Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta una lectura tomada en instanteMs (ms del reloj del sistema) */
+    void insertarEn(T valor, std::int64_t instanteMs) {
+        anexarEn(instanteMs, std::move(valor));
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Nodo insertado. Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta en bloque n valores consecutivos (un solo mensaje de log)
+     */
+    void insertarVarios(const T* valores, int n) {
+        if (valores == nullptr || n <= 0) {
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            anexar(valores[i]);
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << n << " nodo(s) insertado(s). Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta en bloque n valores tomados en el mismo instante */
+    void insertarVariosEn(const T* valores, int n, std::int64_t instanteMs) {
+        if (valores == nullptr || n <= 0) {
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            anexarEn(instanteMs, valores[i]);
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << n << " nodo(s) insertado(s). Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta en bloque n valores, cada uno con su instante (p. ej. al restaurar) */
+    void insertarVariosEn(const T* valores, const std::int64_t* instantes, int n) {
+        if (valores == nullptr || instantes == nullptr || n <= 0) {
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            anexarEn(instantes[i], valores[i]);
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << n << " nodo(s) insertado(s). Cantidad actual: " << cantidad;
+        });
+    }
+
+    /** Inserta en bloque el rango [primero, ultimo)
+     */
+    template <typename Iterador>
+    void insertarRango(Iterador primero, Iterador ultimo) {
+        int insertados = 0;
+        for (; primero != ultimo; ++primero) {
+            anexar(*primero);
+            insertados++;
+        }
+        if (insertados > 0) {
+            BitacoraPredeterminada::registrar([&](auto& os) {
+                os << "[Log] " << insertados << " nodo(s) insertado(s). Cantidad actual: "
+                   << cantidad;
+            });
+        }
+    }
+
+    bool buscar(T valor) const {
+        for (Bloque* b = cabeza; b != nullptr; b = b->siguiente) {
+            for (int i = 0; i < b->usados; i++) {
+                if (b->datos[i] == valor) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    T& obtenerPrimero() {
+        Bloque* primero = saltarVacios(cabeza);
+        if (primero == nullptr) {
+            throw std::runtime_error("Lista vacía");
+        }
+        return primero->datos[0];
+    }
+
+
+    T obtenerMinimo() const {
+        if (cantidad == 0) {
+            throw std::runtime_error("Lista vacía");
+        }
+        return estadisticas.obtenerMinimo();
+    }
+
+    T obtenerMaximo() const {
+        if (cantidad == 0) {
+            throw std::runtime_error("Lista vacía");
+        }
+        return estadisticas.obtenerMaximo();
+    }
+
+    /** Elimina la primera aparición del mínimo; sólo desplaza las
+     *  lecturas de su propio bloque. Si el bloque queda vacío se suelta
+     *  más tarde, junto con los demás (compactar).
+     */
+    bool eliminarMinimo() {
+        if (cantidad == 0) {
+            return false;
+        }
+
+        if (!indiceActivo) {
+            construirIndice();
+        }
+
+        std::pop_heap(monticulo.begin(), monticulo.end(), MayorValor());
+        EntradaMinimo entrada = monticulo.back();
+        monticulo.pop_back();
+
+        Bloque* bloque = entrada.bloque;
+        int pos = 0;
+        while (bloque->datos[pos] < entrada.valor || entrada.valor < bloque->datos[pos]) {
+            pos++;
+        }
+
+        T minimo = bloque->datos[pos];
+        quitarMarca(bloque, bloque->punto, pos);
+        for (int i = pos + 1; i < bloque->usados; i++) {
+            bloque->datos[i - 1] = std::move(bloque->datos[i]);
+        }
+        bloque->usados--;
+        cantidad--;
+        estadisticas.quitar(minimo);
+
+        if (cantidad == 0) {
+            limpiar();
+        } else {
+            estadisticas.fijarMinimo(monticulo.front().valor);
+            if (!estadisticas.tieneMaximo()) {
+                // Sólo ocurre si todas las lecturas eran iguales al mínimo
+                estadisticas.fijarMaximo(minimo);
+            }
+            if (bloque->usados == 0) {
+                bloquesVacios++;
+                if (bloquesVacios > static_cast<int>(puntos.size()) - bloquesVacios) {
+                    compactar();
+                }
+            } else if (bloque == cola) {
+                retomarMarcas();
+            }
+        }
+
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Nodo<T> " << minimo << " liberado.";
+        });
+        return true;
+    }
+
+
+    double calcularPromedio() const {
+        return estadisticas.promedio();
+    }
+
+    /** Estadísticas incrementales del historial (suma, mín, máx) */
+    const EstadisticasHistorial<T>& obtenerEstadisticas() const {
+        return estadisticas;
+    }
+
+    /** Varianza poblacional: media incremental y una pasada vectorizada */
+    double calcularVarianza() const {
+        return varianzaHistorial<T>(*this, estadisticas.promedio(),
+                                    static_cast<std::size_t>(cantidad));
+    }
+
+    /** Cantidad de lecturas con minimo <= x <= maximo */
+    int contarEnRango(const T& minimo, const T& maximo) const {
+        return static_cast<int>(contarEnRangoHistorial<T>(*this, minimo, maximo));
+    }
+
+    int obtenerCantidad() const {
+        return cantidad;
+    }
+
+    /** Imprime todos los elementos de la lista
+     */
+    void imprimir() const {
+        if (cabeza == nullptr) {
+            std::cout << "[Lista vacía]" << std::endl;
+            return;
+        }
+
+        std::cout << "Elementos: ";
+        for (Bloque* b = cabeza; b != nullptr; b = b->siguiente) {
+            for (int i = 0; i < b->usados; i++) {
+                std::cout << b->datos[i] << " ";
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    bool estaVacia() const {
+        return cabeza == nullptr;
+    }
+
+    /** Llama funcion(const T&) por cada lectura, en orden de inserción */
+    template <typename Funcion>
+    void paraCada(Funcion funcion) const {
+        for (Bloque* b = cabeza; b != nullptr; b = b->siguiente) {
+            for (int i = 0; i < b->usados; i++) {
+                funcion(static_cast<const T&>(b->datos[i]));
+            }
+        }
+    }
+
+    /** Llama funcion(const T* datos, int n) por cada segmento contiguo,
+     *  en orden. Es el punto de entrada para kernels vectorizados.
+     */
+    template <typename Funcion>
+    void paraCadaSegmento(Funcion funcion) const {
+        for (Bloque* b = saltarVacios(cabeza); b != nullptr; b = saltarVacios(b->siguiente)) {
+            funcion(static_cast<const T*>(b->datos), b->usados);
+        }
+    }
+
+    /** Llama funcion(const T&, std::int64_t instanteMs) por cada lectura,
+     *  en orden de inserción
+     */
+    template <typename Funcion>
+    void paraCadaConInstante(Funcion funcion) const {
+        recorrerConInstante(0, [&](const T& valor, std::int64_t instante) {
+            funcion(valor, instante);
+            return true;
+        });
+    }
+
+    /**
+     * Llama funcion(const T&, std::int64_t instanteMs) por cada lectura
+     * con desdeMs <= instante <= hastaMs, en orden. El bloque inicial sale
+     * del índice en O(log n) y el recorrido se detiene en la primera
+     * lectura posterior a hastaMs.
+     */
+    template <typename Funcion>
+    void paraCadaEnIntervalo(std::int64_t desdeMs, std::int64_t hastaMs, Funcion funcion) const {
+        if (puntos.empty() || hastaMs < desdeMs) {
+            return;
+        }
+        std::size_t p = buscarPuntoTiempo(puntos.size(), desdeMs,
+                                          [this](std::size_t i) { return puntos[i].instanteMs; });
+        recorrerConInstante(p, [&](const T& valor, std::int64_t instante) {
+            if (instante > hastaMs) {
+                return false;
+            }
+            if (instante >= desdeMs) {
+                funcion(valor, instante);
+            }
+            return true;
+        });
+    }
+
+    /** Instante de la lectura más reciente (0 si nunca hubo lecturas) */
+    std::int64_t obtenerUltimoInstante() const {
+        return marcas.obtenerUltimo();
+    }
+
+    /**
+     * Iterador de avance (forward) de sólo lectura sobre todas las
+     * lecturas, en orden de inserción. Es segmentado: además de avanzar
+     * elemento a elemento expone el tramo contiguo del bloque actual, y
+     * segmentos() recorre esos tramos directamente. Lo invalida cualquier
+     * operación que modifique la lista.
+     */
+    class IteradorConst {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        IteradorConst() : bloque(nullptr), indice(0) {}
+
+        reference operator*() const { return bloque->datos[indice]; }
+        pointer operator->() const { return &bloque->datos[indice]; }
+
+        IteradorConst& operator++() {
+            if (++indice == bloque->usados) {
+                bloque = saltarVacios(bloque->siguiente);
+                indice = 0;
+            }
+            return *this;
+        }
+
+        IteradorConst operator++(int) {
+            IteradorConst previo = *this;
+            ++(*this);
+            return previo;
+        }
+
+        /** Lecturas que quedan en el bloque actual, desde esta posición */
+        TramoLecturas<T> tramoLocal() const {
+            return TramoLecturas<T>(bloque->datos + indice, bloque->datos + bloque->usados);
+        }
+
+        friend bool operator==(const IteradorConst& a, const IteradorConst& b) {
+            return a.bloque == b.bloque && a.indice == b.indice;
+        }
+
+        friend bool operator!=(const IteradorConst& a, const IteradorConst& b) {
+            return !(a == b);
+        }
+
+    private:
+        friend class ListaSensorBloques;
+
+        explicit IteradorConst(const Bloque* b) : bloque(b), indice(0) {}
+
+        const Bloque* bloque;
+        int indice;
+    };
+
+    /** Recorre los bloques entregando cada uno como TramoLecturas<T>.
+     *  Admite varias pasadas, pero devuelve el tramo por valor, por eso se
+     *  declara de entrada (input) y no forward.
+     */
+    class IteradorTramos {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef TramoLecturas<T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef TramoLecturas<T> reference;
+
+        IteradorTramos() : bloque(nullptr) {}
+
+        reference operator*() const {
+            return TramoLecturas<T>(bloque->datos, bloque->datos + bloque->usados);
+        }
+
+        IteradorTramos& operator++() {
+            bloque = saltarVacios(bloque->siguiente);
+            return *this;
+        }
+
+        IteradorTramos operator++(int) {
+            IteradorTramos previo = *this;
+            bloque = saltarVacios(bloque->siguiente);
+            return previo;
+        }
+
+        friend bool operator==(const IteradorTramos& a, const IteradorTramos& b) {
+            return a.bloque == b.bloque;
+        }
+
+        friend bool operator!=(const IteradorTramos& a, const IteradorTramos& b) {
+            return a.bloque != b.bloque;
+        }
+
+    private:
+        friend class ListaSensorBloques;
+
+        explicit IteradorTramos(const Bloque* b) : bloque(b) {}
+
+        const Bloque* bloque;
+    };
+
+    /// Rango de tramos para usar en un for de rango
+    struct RangoTramos {
+        IteradorTramos inicio;
+        IteradorTramos fin;
+
+        IteradorTramos begin() const { return inicio; }
+        IteradorTramos end() const { return fin; }
+    };
+
+    typedef T value_type;
+    typedef IteradorConst const_iterator;
+    typedef IteradorConst iterator;
+
+    // Los iteradores saltan los bloques vacíos pendientes de compactar
+    const_iterator begin() const { return IteradorConst(saltarVacios(cabeza)); }
+    const_iterator end() const { return IteradorConst(nullptr); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    /** Tramos contiguos (uno por bloque) para algoritmos de acceso aleatorio */
+    RangoTramos segmentos() const {
+        RangoTramos rango;
+        rango.inicio = IteradorTramos(saltarVacios(cabeza));
+        rango.fin = IteradorTramos(nullptr);
+        return rango;
+    }
+
+private:
+    /** Comparador que convierte std::*_heap en un montículo de mínimos;
+     *  entre iguales sale primero el bloque más antiguo
+     */
+    struct MayorValor {
+        bool operator()(const EntradaMinimo& a, const EntradaMinimo& b) const {
+            if (b.valor < a.valor) {
+                return true;
+            }
+            return !(a.valor < b.valor) && b.bloque->punto < a.bloque->punto;
+        }
+    };
+
+    /** Primer bloque con lecturas desde b (inclusive), o nullptr */
+    static Bloque* saltarVacios(Bloque* b) {
+        while (b != nullptr && b->usados == 0) {
+            b = b->siguiente;
+        }
+        return b;
+    }
+
+    static const Bloque* saltarVacios(const Bloque* b) {
+        while (b != nullptr && b->usados == 0) {
+            b = b->siguiente;
+        }
+        return b;
+    }
+
+    /** Construye el montículo con todas las lecturas (O(n), una sola vez) */
+    void construirIndice() {
+        monticulo.clear();
+        monticulo.reserve(static_cast<std::size_t>(cantidad));
+        for (Bloque* b = cabeza; b != nullptr; b = b->siguiente) {
+            for (int i = 0; i < b->usados; i++) {
+                EntradaMinimo entrada = { b->datos[i], b };
+                monticulo.push_back(entrada);
+            }
+        }
+        std::make_heap(monticulo.begin(), monticulo.end(), MayorValor());
+        indiceActivo = true;
+    }
+
+    /** Suelta los bloques vacíos y rehace el índice temporal sin ellos.
+     *  Sólo ocurre cuando superan a los bloques con lecturas, así que su
+     *  costo O(bloques) se amortiza en O(1) por eliminación.
+     */
+    void compactar() {
+        std::vector<PuntoTiempo<Bloque*> > anteriores;
+        anteriores.swap(puntos);
+        puntos.reserve(anteriores.size() - static_cast<std::size_t>(bloquesVacios));
+        Bloque* anterior = nullptr;
+        for (std::size_t p = 0; p < anteriores.size(); p++) {
+            Bloque* b = anteriores[p].posicion;
+            if (b->usados == 0) {
+                if (anterior == nullptr) {
+                    cabeza = b->siguiente;
+                } else {
+                    anterior->siguiente = b->siguiente;
+                }
+                delete b;
+            } else {
+                b->punto = static_cast<std::uint32_t>(puntos.size());
+                puntos.push_back(anteriores[p]);
+                anterior = b;
+            }
+        }
+        bloquesVacios = 0;
+        if (cola != anterior) {
+            cola = anterior;
+            retomarMarcas();
+        }
+    }
+
+    /** Anexa sin instante propio: repite el de la lectura anterior */
+    template <typename U>
+    void anexar(U&& valor) {
+        anexarEn(marcas.obtenerUltimo(), std::forward<U>(valor));
+    }
+
+    /** Escribe en la cola; sólo reserva un bloque nuevo cada N lecturas
+     *  (o si el instante ya no cabe en el tramo del bloque)
+     */
+    template <typename U>
+    void anexarEn(std::int64_t instanteMs, U&& valor) {
+        std::int64_t instante = marcas.normalizar(instanteMs);
+        if (cola != nullptr && cola->usados == 0) {
+            // La cola quedó vacía: se reutiliza con un tramo nuevo
+            puntos.back().instanteMs = instante;
+            marcas.abrirTramo(instante);
+            cola->marcas[0] = 0;
+            bloquesVacios--;
+        } else if (cola == nullptr || cola->usados == N || marcas.excedeTramo(instante)) {
+            Bloque* nuevo = new Bloque();
+            nuevo->punto = static_cast<std::uint32_t>(puntos.size());
+            if (cola == nullptr) {
+                cabeza = nuevo;
+            } else {
+                cola->siguiente = nuevo;
+            }
+            cola = nuevo;
+            PuntoTiempo<Bloque*> punto = { instante, 0, nuevo };
+            puntos.push_back(punto);
+            marcas.abrirTramo(instante);
+            cola->marcas[0] = 0;
+        } else {
+            cola->marcas[cola->usados] = marcas.codificar(instante);
+        }
+        cola->datos[cola->usados] = std::forward<U>(valor);
+        estadisticas.agregar(cola->datos[cola->usados]);
+        if (indiceActivo) {
+            EntradaMinimo entrada = { cola->datos[cola->usados], cola };
+            monticulo.push_back(entrada);
+            std::push_heap(monticulo.begin(), monticulo.end(), MayorValor());
+        }
+        cola->usados++;
+        cantidad++;
+    }
+
+    void copiarDesde(const ListaSensorBloques& otra) {
+        otra.paraCadaConInstante([this](const T& valor, std::int64_t instante) {
+            anexarEn(instante, valor);
+        });
+    }
+
+    /**
+     * Recorre las lecturas desde el bloque del punto p con su instante;
+     * visitar(const T&, instante) retorna false para detenerse.
+     */
+    template <typename Visitar>
+    void recorrerConInstante(std::size_t p, Visitar visitar) const {
+        for (; p < puntos.size(); p++) {
+            const Bloque* b = puntos[p].posicion;
+            DecodificadorMarcas reloj;
+            reloj.situar(puntos[p]);
+            for (int i = 0; i < b->usados; i++) {
+                std::int64_t instante = (i == 0) ? reloj.instante : reloj.avanzar(b->marcas[i]);
+                if (!visitar(static_cast<const T&>(b->datos[i]), instante)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /** Quita la marca de la posición pos del bloque (el punto número
+     *  indice) y vuelve a codificar las que quedan
+     */
+    void quitarMarca(Bloque* b, std::size_t indice, int pos) {
+        std::int64_t instantes[N];
+        DecodificadorMarcas reloj;
+        reloj.situar(puntos[indice]);
+        for (int i = 0; i < b->usados; i++) {
+            instantes[i] = (i == 0) ? reloj.instante : reloj.avanzar(b->marcas[i]);
+        }
+        CodificadorMarcas tramo;
+        int j = 0;
+        for (int i = 0; i < b->usados; i++) {
+            if (i == pos) {
+                continue;
+            }
+            if (j == 0) {
+                puntos[indice].instanteMs = instantes[i];
+                tramo.abrirTramo(instantes[i]);
+                b->marcas[0] = 0;
+            } else {
+                b->marcas[j] = tramo.codificar(instantes[i]);
+            }
+            j++;
+        }
+    }
+
+    /** Rehace el estado del codificador a partir del bloque cola */
+    void retomarMarcas() {
+        marcas.reiniciar();
+        if (cola == nullptr) {
+            return;
+        }
+        const PuntoTiempo<Bloque*>& punto = puntos.back();
+        DecodificadorMarcas reloj;
+        reloj.situar(punto);
+        marcas.abrirTramo(punto.instanteMs);
+        for (int i = 1; i < cola->usados; i++) {
+            marcas.codificar(reloj.avanzar(cola->marcas[i]));
+        }
+    }
+
+    void limpiar() {
+        Bloque* actual = cabeza;
+        while (actual != nullptr) {
+            Bloque* temp = actual;
+            actual = actual->siguiente;
+            delete temp;
+        }
+        cabeza = nullptr;
+        cola = nullptr;
+        cantidad = 0;
+        bloquesVacios = 0;
+        estadisticas.reiniciar();
+        monticulo.clear();
+        indiceActivo = false;
+        marcas.reiniciar();
+        puntos.clear();
+    }
+};
+
+#endif // LISTA_SENSOR_BLOQUES_HPP
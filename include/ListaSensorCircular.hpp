@@ -0,0 +1,785 @@
+#ifndef LISTA_SENSOR_CIRCULAR_HPP
+#define LISTA_SENSOR_CIRCULAR_HPP
+
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "AgregadosTemporales.hpp"
+#include "Bitacora.hpp"
+#include "EstadisticasHistorial.hpp"
+#include "KernelesAnalitica.hpp"
+#include "MarcasTiempo.hpp"
+
+
+/**
+ * Historial de capacidad fija (anillo) con la interfaz de ListaSensor.
+ *
+ * Conserva sólo las últimas `capacidad` lecturas y, si se indica una
+ * ventana de tiempo, además descarta las que tengan más antigüedad que
+ * la ventana. Toda la memoria se reserva en el constructor, así que lo
+ * que ocupa un sensor no crece aunque el proceso corra indefinidamente.
+ *
+ * Expirar la lectura más antigua es O(1): se quita de las estadísticas
+ * incrementales y de dos colas monótonas (mínimos crecientes y máximos
+ * decrecientes) cuyo frente es siempre el mínimo/máximo de la ventana.
+ * calcularPromedio, obtenerMinimo y obtenerMaximo siguen siendo O(1).
+ * calcularVarianza y contarEnRango recorren los tramos contiguos del
+ * anillo (paraCadaSegmento) con los kernels de KernelesAnalitica.hpp.
+ *
+ * Toda la memoria está en std::vector, así que copia y movimiento son los
+ * implícitos; mover el historial (p. ej. al mover el sensor) es O(1).
+ *
+ * eliminarMinimo marca la ranura (la ranura se recupera cuando expira).
+ * Una cola monótona no sabe quitar su frente de mínimos (las lecturas que
+ * ese frente desplazó volverían a contar), así que, como en ListaSensor,
+ * el primer eliminarMinimo construye un montículo perezoso de mínimos
+ * (O(capacidad), una vez) que desde entonces reemplaza a `minimos`: cada
+ * eliminación es O(log n) y las entradas expiradas o eliminadas se
+ * descartan al llegar a la cima. El montículo se compacta al llegar a
+ * 2 × capacidad entradas, así que su memoria también queda acotada. La
+ * cola de máximos sigue siendo válida (el mínimo no desplazó a ninguna
+ * lectura viva) y sólo salta las ranuras marcadas al llegar al frente.
+ *
+ * Cada ranura guarda el instante de la lectura en ms del reloj del
+ * sistema como delta-de-delta de 32 bits (MarcasTiempo.hpp). Un anillo de
+ * puntos indexa un tramo cada LECTURAS_POR_PUNTO lecturas; el primero se
+ * adelanta a medida que expiran las lecturas, así que siempre tiene el
+ * instante de `primero`. La ventana compara ese instante con la hora del
+ * sistema: las lecturas restauradas o reproducidas con su instante
+ * original expiran igual que si nunca se hubiera reiniciado el proceso.
+ */
+template <typename T>
+class ListaSensorCircular {
+public:
+    typedef std::chrono::steady_clock Reloj;
+
+    static const std::size_t CAPACIDAD_PREDETERMINADA = 4096;
+    static const int LECTURAS_POR_PUNTO = 64;   ///< Lecturas por tramo del índice temporal
+
+    /**
+     * capacidadMaxima  Máximo de lecturas conservadas (al menos 1)
+     * ventanaMaxima    Antigüedad máxima; cero desactiva la expiración por tiempo
+     */
+    explicit ListaSensorCircular(std::size_t capacidadMaxima = CAPACIDAD_PREDETERMINADA,
+                                 Reloj::duration ventanaMaxima = Reloj::duration::zero())
+        : capacidad(capacidadMaxima == 0 ? 1 : capacidadMaxima), ventana(ventanaMaxima),
+          ventanaMs(std::chrono::ceil<std::chrono::milliseconds>(ventanaMaxima).count()),
+          datos(capacidad), vivos(capacidad, 0),
+          marcas(capacidad, 0), puntos(capacidad / LECTURAS_POR_PUNTO + 2),
+          puntosInicio(0), puntosCantidad(0), enTramo(0),
+          primero(0), siguiente(0), cantidad(0), expirados(0),
+          minimos(capacidad), maximos(capacidad), indiceActivo(false) {}
+
+    /** Sin instante explícito la lectura hereda el de la anterior; con
+     *  ventana de tiempo se toma la hora del sistema
+     */
+    void insertar(T valor) {
+        std::size_t antes = expirados;
+        std::int64_t ahora = ahoraSiHaceFalta();
+        anexar(std::move(valor), instanteImplicito(ahora), ahora);
+        registrarInsercion(1, antes);
+    }
+
+    /** Inserta una lectura tomada en instanteMs (ms del reloj del sistema) */
+    void insertarEn(T valor, std::int64_t instanteMs) {
+        std::size_t antes = expirados;
+        anexar(std::move(valor), instanteMs, ahoraSiHaceFalta());
+        registrarInsercion(1, antes);
+    }
+
+    /** Construye la lectura con los argumentos de T y la mueve al anillo */
+    template <typename... Args>
+    void emplazar(Args&&... args) {
+        insertar(T(std::forward<Args>(args)...));
+    }
+
+    /** Inserta en bloque n valores consecutivos (un solo mensaje de log)
+     */
+    void insertarVarios(const T* valores, int n) {
+        if (valores == nullptr || n <= 0) {
+            return;
+        }
+        std::size_t antes = expirados;
+        std::int64_t ahora = ahoraSiHaceFalta();
+        std::int64_t instanteMs = instanteImplicito(ahora);
+        for (int i = 0; i < n; i++) {
+            anexar(valores[i], instanteMs, ahora);
+        }
+        registrarInsercion(n, antes);
+    }
+
+    /** Inserta en bloque n valores tomados en el mismo instante */
+    void insertarVariosEn(const T* valores, int n, std::int64_t instanteMs) {
+        if (valores == nullptr || n <= 0) {
+            return;
+        }
+        std::size_t antes = expirados;
+        std::int64_t ahora = ahoraSiHaceFalta();
+        for (int i = 0; i < n; i++) {
+            anexar(valores[i], instanteMs, ahora);
+        }
+        registrarInsercion(n, antes);
+    }
+
+    /** Inserta en bloque n valores, cada uno con su instante (p. ej. al restaurar) */
+    void insertarVariosEn(const T* valores, const std::int64_t* instantesMs, int n) {
+        if (valores == nullptr || instantesMs == nullptr || n <= 0) {
+            return;
+        }
+        std::size_t antes = expirados;
+        std::int64_t ahora = ahoraSiHaceFalta();
+        for (int i = 0; i < n; i++) {
+            anexar(valores[i], instantesMs[i], ahora);
+        }
+        registrarInsercion(n, antes);
+    }
+
+    template <typename Iterador>
+    void insertarRango(Iterador desde, Iterador hasta) {
+        std::size_t antes = expirados;
+        std::int64_t ahora = ahoraSiHaceFalta();
+        std::int64_t instanteMs = instanteImplicito(ahora);
+        int insertados = 0;
+        for (; desde != hasta; ++desde) {
+            anexar(*desde, instanteMs, ahora);
+            insertados++;
+        }
+        if (insertados > 0) {
+            registrarInsercion(insertados, antes);
+        }
+    }
+
+    /**
+     * Descarta las lecturas cuyo instante sea más antiguo que la ventana
+     * respecto de `ahoraMs` (ms del reloj del sistema). La inserción ya lo
+     * hace; sirve para sensores que dejaron de recibir datos. Retorna
+     * cuántas lecturas expiraron.
+     */
+    std::size_t expirar(std::int64_t ahoraMs = AgregadosTemporales::ahoraMilisegundos()) {
+        std::size_t antes = expirados;
+        expirarPorTiempo(ahoraMs);
+        return expirados - antes;
+    }
+
+    bool buscar(T valor) const {
+        for (std::uint64_t s = primero; s < siguiente; s++) {
+            std::size_t r = ranura(s);
+            if (vivos[r] && datos[r] == valor) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Lectura viva más antigua */
+    T& obtenerPrimero() {
+        for (std::uint64_t s = primero; s < siguiente; s++) {
+            if (vivos[ranura(s)]) {
+                return datos[ranura(s)];
+            }
+        }
+        throw std::runtime_error("Lista vacía");
+    }
+
+    T obtenerMinimo() const {
+        if (cantidad == 0) {
+            throw std::runtime_error("Lista vacía");
+        }
+        return estadisticas.obtenerMinimo();
+    }
+
+    T obtenerMaximo() const {
+        if (cantidad == 0) {
+            throw std::runtime_error("Lista vacía");
+        }
+        return estadisticas.obtenerMaximo();
+    }
+
+    bool eliminarMinimo() {
+        if (cantidad == 0) {
+            return false;
+        }
+        if (!indiceActivo) {
+            construirIndice();
+        }
+
+        descartarCimaMuerta();
+        T minimo = monticulo.front().valor;
+        vivos[ranura(monticulo.front().secuencia)] = 0;
+        std::pop_heap(monticulo.begin(), monticulo.end(), MayorValor());
+        monticulo.pop_back();
+        cantidad--;
+        estadisticas.quitar(minimo);
+        fijarExtremos();
+
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] Lectura " << minimo << " eliminada del anillo.";
+        });
+        return true;
+    }
+
+    double calcularPromedio() const {
+        return estadisticas.promedio();
+    }
+
+    /** Estadísticas de las lecturas vigentes (suma, mín, máx) */
+    const EstadisticasHistorial<T>& obtenerEstadisticas() const {
+        return estadisticas;
+    }
+
+    /** Varianza poblacional de las lecturas vigentes */
+    double calcularVarianza() const {
+        return varianzaHistorial<T>(*this, estadisticas.promedio(), cantidad);
+    }
+
+    /** Cantidad de lecturas vigentes con minimo <= x <= maximo */
+    int contarEnRango(const T& minimo, const T& maximo) const {
+        return static_cast<int>(contarEnRangoHistorial<T>(*this, minimo, maximo));
+    }
+
+    int obtenerCantidad() const {
+        return static_cast<int>(cantidad);
+    }
+
+    std::size_t obtenerCapacidad() const {
+        return capacidad;
+    }
+
+    Reloj::duration obtenerVentana() const {
+        return ventana;
+    }
+
+    /** Lecturas descartadas por capacidad o por antigüedad desde el inicio */
+    std::size_t obtenerExpirados() const {
+        return expirados;
+    }
+
+    /** Imprime las lecturas vigentes, de la más antigua a la más reciente
+     */
+    void imprimir() const {
+        if (cantidad == 0) {
+            std::cout << "[Lista vacía]" << std::endl;
+            return;
+        }
+        std::cout << "Elementos: ";
+        for (std::uint64_t s = primero; s < siguiente; s++) {
+            if (vivos[ranura(s)]) {
+                std::cout << datos[ranura(s)] << " ";
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    bool estaVacia() const {
+        return cantidad == 0;
+    }
+
+    /** Llama funcion(const T&) por cada lectura vigente, de la más antigua
+     *  a la más reciente
+     */
+    template <typename Funcion>
+    void paraCada(Funcion funcion) const {
+        for (std::uint64_t s = primero; s < siguiente; s++) {
+            if (vivos[ranura(s)]) {
+                funcion(static_cast<const T&>(datos[ranura(s)]));
+            }
+        }
+    }
+
+    /** Llama funcion(const T* datos, int n) por cada tramo contiguo de
+     *  lecturas vigentes, en orden. Sin huecos son a lo sumo dos tramos
+     *  (antes y después de la vuelta del anillo).
+     */
+    template <typename Funcion>
+    void paraCadaSegmento(Funcion funcion) const {
+        const T* base = datos.data();
+        if (cantidad == siguiente - primero) {
+            std::size_t inicio = ranura(primero);
+            std::size_t hastaVuelta = capacidad - inicio;
+            std::size_t tramo = (cantidad < hastaVuelta) ? cantidad : hastaVuelta;
+            if (tramo > 0) {
+                funcion(base + inicio, static_cast<int>(tramo));
+            }
+            if (cantidad > tramo) {
+                funcion(base, static_cast<int>(cantidad - tramo));
+            }
+            return;
+        }
+        std::uint64_t s = primero;
+        while (s < siguiente) {
+            if (!vivos[ranura(s)]) {
+                s++;
+                continue;
+            }
+            std::uint64_t inicio = s++;
+            while (s < siguiente && vivos[ranura(s)] && ranura(s) != 0) {
+                s++;
+            }
+            funcion(base + ranura(inicio), static_cast<int>(s - inicio));
+        }
+    }
+
+    /** Llama funcion(const T&, std::int64_t instanteMs) por cada lectura
+     *  vigente, de la más antigua a la más reciente
+     */
+    template <typename Funcion>
+    void paraCadaConInstante(Funcion funcion) const {
+        recorrerConInstante(0, [&](std::size_t r, std::int64_t instante) {
+            if (vivos[r]) {
+                funcion(static_cast<const T&>(datos[r]), instante);
+            }
+            return true;
+        });
+    }
+
+    /**
+     * Llama funcion(const T&, std::int64_t instanteMs) por cada lectura
+     * vigente con desdeMs <= instante <= hastaMs, en orden. El tramo
+     * inicial sale del anillo de puntos en O(log n) y el recorrido se
+     * detiene en la primera lectura posterior a hastaMs.
+     */
+    template <typename Funcion>
+    void paraCadaEnIntervalo(std::int64_t desdeMs, std::int64_t hastaMs, Funcion funcion) const {
+        if (puntosCantidad == 0 || hastaMs < desdeMs) {
+            return;
+        }
+        std::size_t p = buscarPuntoTiempo(puntosCantidad, desdeMs,
+                                          [this](std::size_t i) { return punto(i).instanteMs; });
+        recorrerConInstante(p, [&](std::size_t r, std::int64_t instante) {
+            if (instante > hastaMs) {
+                return false;
+            }
+            if (instante >= desdeMs && vivos[r]) {
+                funcion(static_cast<const T&>(datos[r]), instante);
+            }
+            return true;
+        });
+    }
+
+    /** Instante de la lectura más reciente (0 si nunca hubo lecturas) */
+    std::int64_t obtenerUltimoInstante() const {
+        return codificador.obtenerUltimo();
+    }
+
+    /**
+     * Iterador de avance (forward) de sólo lectura sobre las lecturas
+     * vigentes, de la más antigua a la más reciente; salta las ranuras
+     * que dejó eliminarMinimo. No es de acceso aleatorio porque esos
+     * huecos impiden saltar en O(1): para eso están los tramos de
+     * segmentos(). Lo invalida cualquier operación que modifique el anillo.
+     */
+    class IteradorConst {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        IteradorConst() : lista(nullptr), secuencia(0), posicion(0) {}
+
+        reference operator*() const { return lista->datos[posicion]; }
+        pointer operator->() const { return &lista->datos[posicion]; }
+
+        IteradorConst& operator++() {
+            avanzar();
+            saltarHuecos();
+            return *this;
+        }
+
+        IteradorConst operator++(int) {
+            IteradorConst previo = *this;
+            ++(*this);
+            return previo;
+        }
+
+        friend bool operator==(const IteradorConst& a, const IteradorConst& b) {
+            return a.secuencia == b.secuencia;
+        }
+
+        friend bool operator!=(const IteradorConst& a, const IteradorConst& b) {
+            return a.secuencia != b.secuencia;
+        }
+
+    private:
+        friend class ListaSensorCircular;
+
+        IteradorConst(const ListaSensorCircular* l, std::uint64_t s)
+            : lista(l), secuencia(s), posicion(l->ranura(s)) {
+            saltarHuecos();
+        }
+
+        // La ranura avanza junto con la secuencia: sin una división por paso
+        void avanzar() {
+            secuencia++;
+            if (++posicion == lista->capacidad) {
+                posicion = 0;
+            }
+        }
+
+        void saltarHuecos() {
+            while (secuencia < lista->siguiente && !lista->vivos[posicion]) {
+                avanzar();
+            }
+        }
+
+        const ListaSensorCircular* lista;
+        std::uint64_t secuencia;
+        std::size_t posicion;   ///< ranura(secuencia)
+    };
+
+    typedef T value_type;
+    typedef IteradorConst const_iterator;
+    typedef IteradorConst iterator;
+
+    const_iterator begin() const { return IteradorConst(this, primero); }
+    const_iterator end() const { return IteradorConst(this, siguiente); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    /** Tramos contiguos de lecturas vigentes (los de paraCadaSegmento);
+     *  sus iteradores son punteros de acceso aleatorio
+     */
+    std::vector<TramoLecturas<T> > segmentos() const {
+        std::vector<TramoLecturas<T> > tramos;
+        paraCadaSegmento([&tramos](const T* inicio, int n) {
+            tramos.push_back(TramoLecturas<T>(inicio, inicio + n));
+        });
+        return tramos;
+    }
+
+private:
+    /**
+     * Cola doble de números de secuencia sobre un anillo fijo. Nunca
+     * guarda más elementos que el historial, así que no crece.
+     */
+    class ColaMonotona {
+    public:
+        explicit ColaMonotona(std::size_t capacidad)
+            : elementos(capacidad), inicio(0), tamanio(0) {}
+
+        bool vacia() const { return tamanio == 0; }
+        std::uint64_t frente() const { return elementos[inicio]; }
+        std::uint64_t fondo() const { return elementos[posicion(tamanio - 1)]; }
+
+        void quitarFrente() {
+            inicio = posicion(1);
+            tamanio--;
+        }
+
+        void quitarFondo() {
+            tamanio--;
+        }
+
+        void agregarFondo(std::uint64_t secuencia) {
+            elementos[posicion(tamanio)] = secuencia;
+            tamanio++;
+        }
+
+        void vaciar() {
+            inicio = 0;
+            tamanio = 0;
+        }
+
+    private:
+        std::size_t posicion(std::size_t desplazamiento) const {
+            std::size_t p = inicio + desplazamiento;
+            return (p >= elementos.size()) ? p - elementos.size() : p;
+        }
+
+        std::vector<std::uint64_t> elementos;
+        std::size_t inicio;
+        std::size_t tamanio;
+    };
+
+    /// Entrada del montículo: copia el dato porque la ranura se reutiliza
+    struct EntradaMinimo {
+        T valor;
+        std::uint64_t secuencia;
+    };
+
+    /** Comparador que convierte std::*_heap en un montículo de mínimos;
+     *  entre iguales sale primero la más antigua, como en la cola monótona
+     */
+    struct MayorValor {
+        bool operator()(const EntradaMinimo& a, const EntradaMinimo& b) const {
+            if (b.valor < a.valor) {
+                return true;
+            }
+            return !(a.valor < b.valor) && b.secuencia < a.secuencia;
+        }
+    };
+
+    std::size_t ranura(std::uint64_t secuencia) const {
+        return static_cast<std::size_t>(secuencia % capacidad);
+    }
+
+    /** Hora del sistema en ms, sólo si hay ventana (sin ella no se lee el reloj) */
+    std::int64_t ahoraSiHaceFalta() const {
+        return (ventanaMs > 0) ? AgregadosTemporales::ahoraMilisegundos() : 0;
+    }
+
+    /** Instante de una lectura insertada sin él */
+    std::int64_t instanteImplicito(std::int64_t ahora) const {
+        return (ventanaMs > 0) ? ahora : codificador.obtenerUltimo();
+    }
+
+    void registrarInsercion(int n, std::size_t expiradosAntes) {
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Log] " << n << " lectura(s) insertada(s). Cantidad actual: " << cantidad;
+            if (expirados != expiradosAntes) {
+                os << " (" << (expirados - expiradosAntes) << " expirada(s))";
+            }
+        });
+    }
+
+    /** Agrega al final y expira lo que quede fuera de la ventana (incluso
+     *  la propia lectura, si su instante ya es más antiguo que la ventana)
+     */
+    template <typename U>
+    void anexar(U&& valor, std::int64_t instanteMs, std::int64_t ahora) {
+        if (siguiente - primero == capacidad) {
+            expirarMasAntigua();
+        }
+
+        std::uint64_t s = siguiente++;
+        std::size_t r = ranura(s);
+        datos[r] = std::forward<U>(valor);
+        vivos[r] = 1;
+        marcar(s, r, instanteMs);
+        cantidad++;
+        estadisticas.agregar(datos[r]);
+        empujarEnColas(s);
+        fijarExtremos();
+        expirarPorTiempo(ahora);
+    }
+
+    /** El punto más antiguo tiene el instante de `primero`: O(1) por lectura */
+    void expirarPorTiempo(std::int64_t ahora) {
+        if (ventanaMs <= 0) {
+            return;
+        }
+        std::size_t antes = expirados;
+        while (primero < siguiente && ahora - punto(0).instanteMs > ventanaMs) {
+            expirarMasAntigua();
+        }
+        if (expirados != antes && cantidad > 0) {
+            fijarExtremos();
+        }
+    }
+
+    /** Libera la ranura más antigua en O(1) */
+    void expirarMasAntigua() {
+        std::uint64_t s = primero++;
+        std::size_t r = ranura(s);
+        adelantarPunto((r + 1 == capacidad) ? 0 : r + 1);
+        if (vivos[r]) {
+            vivos[r] = 0;
+            cantidad--;
+            expirados++;
+            estadisticas.quitar(datos[r]);
+        }
+        // Las colas no conservan secuencias anteriores a `primero`, así que
+        // nunca guardan más de `capacidad` (el montículo las quita en la cima)
+        descartarFrenteMuerto(minimos);
+        descartarFrenteMuerto(maximos);
+    }
+
+    /** Punto i del índice temporal, contando desde el más antiguo */
+    const PuntoTiempo<std::uint64_t>& punto(std::size_t i) const {
+        std::size_t p = puntosInicio + i;
+        return puntos[(p >= puntos.size()) ? p - puntos.size() : p];
+    }
+
+    /** Codifica el instante de la secuencia s (en la ranura r); abre un
+     *  tramo (y un punto) cada LECTURAS_POR_PUNTO lecturas o si el anillo
+     *  de puntos está vacío
+     */
+    void marcar(std::uint64_t s, std::size_t r, std::int64_t instanteMs) {
+        std::int64_t instante = codificador.normalizar(instanteMs);
+        if (puntosCantidad == 0 || enTramo == LECTURAS_POR_PUNTO || codificador.excedeTramo(instante)) {
+            if (puntosCantidad == puntos.size()) {
+                crecerPuntos();
+            }
+            std::size_t p = puntosInicio + puntosCantidad;
+            PuntoTiempo<std::uint64_t> nuevo = { instante, 0, s };
+            puntos[(p >= puntos.size()) ? p - puntos.size() : p] = nuevo;
+            puntosCantidad++;
+            codificador.abrirTramo(instante);
+            marcas[r] = 0;
+            enTramo = 1;
+        } else {
+            marcas[r] = codificador.codificar(instante);
+            enTramo++;
+        }
+    }
+
+    /** Sólo hace falta con tramos muy cortos (saltos de más de 24 días) */
+    void crecerPuntos() {
+        std::vector<PuntoTiempo<std::uint64_t> > mayor(puntos.size() * 2);
+        for (std::size_t i = 0; i < puntosCantidad; i++) {
+            mayor[i] = punto(i);
+        }
+        puntos.swap(mayor);
+        puntosInicio = 0;
+    }
+
+    /**
+     * Tras avanzar `primero` (ahora en la ranura r), el punto más antiguo
+     * pasa a la lectura siguiente de su tramo (se decodifica su marca), o
+     * se descarta si ahí empieza el próximo tramo o ya no quedan lecturas.
+     */
+    void adelantarPunto(std::size_t r) {
+        if (puntosCantidad == 0) {
+            return;
+        }
+        if (primero == siguiente || (puntosCantidad > 1 && punto(1).posicion == primero)) {
+            puntosInicio = (puntosInicio + 1 == puntos.size()) ? 0 : puntosInicio + 1;
+            puntosCantidad--;
+            return;
+        }
+        PuntoTiempo<std::uint64_t>& frente = puntos[puntosInicio];
+        frente.deltaMs += marcas[r];
+        frente.instanteMs += frente.deltaMs;
+        frente.posicion = primero;
+    }
+
+    /**
+     * Recorre las secuencias desde el punto p con su instante, vivas o
+     * no; visitar(ranura, instante) retorna false para detenerse.
+     */
+    template <typename Visitar>
+    void recorrerConInstante(std::size_t p, Visitar visitar) const {
+        if (p >= puntosCantidad) {
+            return;
+        }
+        DecodificadorMarcas reloj;
+        std::uint64_t s = punto(p).posicion;
+        std::uint64_t proximoPunto = s;
+        // La ranura avanza junto con la secuencia: sin una división por paso
+        for (std::size_t r = ranura(s); s < siguiente; s++) {
+            std::int64_t instante;
+            if (s == proximoPunto) {
+                reloj.situar(punto(p++));
+                instante = reloj.instante;
+                proximoPunto = (p < puntosCantidad) ? punto(p).posicion : siguiente;
+            } else {
+                instante = reloj.avanzar(marcas[r]);
+            }
+            if (!visitar(r, instante)) {
+                return;
+            }
+            if (++r == capacidad) {
+                r = 0;
+            }
+        }
+    }
+
+    /** Cada cola conserva sólo las lecturas que aún pueden ser extremo */
+    void empujarEnColas(std::uint64_t s) {
+        const T& valor = datos[ranura(s)];
+        if (indiceActivo) {
+            if (monticulo.size() == 2 * capacidad) {
+                construirIndice();   // Ya incluye s; O(capacidad) cada >= capacidad inserciones
+            } else {
+                EntradaMinimo entrada = { valor, s };
+                monticulo.push_back(entrada);
+                std::push_heap(monticulo.begin(), monticulo.end(), MayorValor());
+            }
+        } else {
+            while (!minimos.vacia() && valor < datos[ranura(minimos.fondo())]) {
+                minimos.quitarFondo();
+            }
+            minimos.agregarFondo(s);
+        }
+        while (!maximos.vacia() && datos[ranura(maximos.fondo())] < valor) {
+            maximos.quitarFondo();
+        }
+        maximos.agregarFondo(s);
+    }
+
+    bool estaVivaSecuencia(std::uint64_t s) const {
+        return s >= primero && vivos[ranura(s)];
+    }
+
+    /** Quita del frente las secuencias expiradas o eliminadas */
+    void descartarFrenteMuerto(ColaMonotona& cola) {
+        while (!cola.vacia() && !estaVivaSecuencia(cola.frente())) {
+            cola.quitarFrente();
+        }
+    }
+
+    /** Quita de la cima del montículo las entradas expiradas o eliminadas */
+    void descartarCimaMuerta() {
+        while (!monticulo.empty() && !estaVivaSecuencia(monticulo.front().secuencia)) {
+            std::pop_heap(monticulo.begin(), monticulo.end(), MayorValor());
+            monticulo.pop_back();
+        }
+    }
+
+    /** Construye el montículo con las ranuras vivas; desde entonces
+     *  reemplaza a la cola de mínimos
+     */
+    void construirIndice() {
+        monticulo.clear();
+        monticulo.reserve(2 * capacidad);
+        for (std::uint64_t s = primero; s < siguiente; s++) {
+            std::size_t r = ranura(s);
+            if (vivos[r]) {
+                EntradaMinimo entrada = { datos[r], s };
+                monticulo.push_back(entrada);
+            }
+        }
+        std::make_heap(monticulo.begin(), monticulo.end(), MayorValor());
+        minimos.vaciar();
+        indiceActivo = true;
+    }
+
+    /** Devuelve a las estadísticas el mínimo y máximo vigentes */
+    void fijarExtremos() {
+        if (cantidad == 0) {
+            return;
+        }
+        descartarFrenteMuerto(maximos);
+        estadisticas.fijarMaximo(datos[ranura(maximos.frente())]);
+        if (indiceActivo) {
+            descartarCimaMuerta();
+            estadisticas.fijarMinimo(monticulo.front().valor);
+        } else {
+            estadisticas.fijarMinimo(datos[ranura(minimos.frente())]);
+        }
+    }
+
+    std::size_t capacidad;               ///< Ranuras del anillo
+    Reloj::duration ventana;             ///< Antigüedad máxima (cero: sin límite)
+    std::int64_t ventanaMs;              ///< La misma en ms, frente a los instantes de las lecturas
+
+    std::vector<T> datos;                      ///< Lecturas, indexadas por secuencia % capacidad
+    std::vector<unsigned char> vivos;          ///< 0 si la ranura fue eliminada o expiró
+
+    std::vector<std::int32_t> marcas;                 ///< Delta-de-delta del instante de cada ranura
+    std::vector<PuntoTiempo<std::uint64_t> > puntos;  ///< Anillo del índice temporal (por secuencia)
+    std::size_t puntosInicio;                         ///< Punto más antiguo (siempre en `primero`)
+    std::size_t puntosCantidad;
+    int enTramo;                                      ///< Lecturas del tramo actual
+    CodificadorMarcas codificador;                    ///< Instante y delta de la última lectura
+
+    std::uint64_t primero;     ///< Secuencia de la ranura más antigua
+    std::uint64_t siguiente;   ///< Secuencia de la próxima inserción
+    std::size_t cantidad;      ///< Lecturas vivas
+    std::size_t expirados;     ///< Lecturas descartadas por la ventana
+
+    EstadisticasHistorial<T> estadisticas;  ///< Suma/mín/máx de la ventana
+    ColaMonotona minimos;                   ///< Secuencias con datos crecientes
+    ColaMonotona maximos;                   ///< Secuencias con datos decrecientes
+    std::vector<EntradaMinimo> monticulo;   ///< Montículo de mínimos (perezoso)
+    bool indiceActivo;                      ///< true si monticulo reemplaza a minimos
+};
+
+#endif // LISTA_SENSOR_CIRCULAR_HPP
@@ -0,0 +1,149 @@
+#ifndef MARCAS_TIEMPO_HPP
+#define MARCAS_TIEMPO_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * Marcas de tiempo compactas para los historiales.
+ *
+ * Cada lectura guarda su instante (ms del reloj del sistema) como
+ * delta-de-delta de 32 bits respecto de la lectura anterior: con un
+ * muestreo regular o lecturas en lote el valor es 0 o casi 0. Las lecturas
+ * se agrupan en tramos; la primera de cada tramo no usa su marca, porque
+ * su instante va en un PuntoTiempo del índice disperso del historial
+ * (uno por tramo). Para decodificar se parte del punto y se suman deltas.
+ *
+ * Un tramo nunca abarca más de ALCANCE_TRAMO ms. Así todos los deltas de
+ * un tramo están en [0, 2^31) y cualquier delta-de-delta cabe en 32 bits,
+ * incluso al volver a codificar un tramo del que se quitó una lectura.
+ *
+ * Los instantes de un historial no decrecen (una lectura anterior a la
+ * última se guarda con el instante de la última), de modo que el índice
+ * está ordenado y una consulta por rango encuentra su inicio con una
+ * búsqueda binaria.
+ */
+
+/// Una lectura con su instante, tal como la entregan las consultas por tiempo
+struct LecturaTemporal {
+    std::int64_t instanteMs;
+    double valor;
+};
+
+/// Entrada del índice disperso: dónde empieza un tramo y su estado de decodificación
+template <typename Posicion>
+struct PuntoTiempo {
+    std::int64_t instanteMs;   ///< Instante de la primera lectura del tramo
+    std::int64_t deltaMs;      ///< Delta de referencia para la marca siguiente
+    Posicion posicion;         ///< Nodo, bloque o secuencia de esa lectura
+};
+
+/** Estado al final del historial: produce la marca de cada lectura nueva */
+class CodificadorMarcas {
+public:
+    static const std::int64_t ALCANCE_TRAMO = 2147483647;   ///< ms (24,8 días)
+
+    CodificadorMarcas() : ultimo(0), delta(0), inicioTramo(0), iniciado(false) {}
+
+    /** Instante efectivo de una lectura: nunca anterior al de la última */
+    std::int64_t normalizar(std::int64_t instanteMs) const {
+        return (iniciado && instanteMs < ultimo) ? ultimo : instanteMs;
+    }
+
+    /** true si una lectura en instanteMs (normalizado) no cabe en el tramo actual */
+    bool excedeTramo(std::int64_t instanteMs) const {
+        return !iniciado || instanteMs - inicioTramo >= ALCANCE_TRAMO;
+    }
+
+    /** La lectura en instanteMs inicia un tramo (su instante va al índice) */
+    void abrirTramo(std::int64_t instanteMs) {
+        ultimo = instanteMs;
+        inicioTramo = instanteMs;
+        delta = 0;
+        iniciado = true;
+    }
+
+    /** Marca de la lectura en instanteMs dentro del tramo actual */
+    std::int32_t codificar(std::int64_t instanteMs) {
+        std::int64_t nuevoDelta = instanteMs - ultimo;
+        std::int32_t marca = static_cast<std::int32_t>(nuevoDelta - delta);
+        delta = nuevoDelta;
+        ultimo = instanteMs;
+        return marca;
+    }
+
+    /** Retoma el estado del final tras modificar el último tramo */
+    void retomar(std::int64_t inicioTramoMs, std::int64_t ultimoMs, std::int64_t deltaMs) {
+        inicioTramo = inicioTramoMs;
+        ultimo = ultimoMs;
+        delta = deltaMs;
+        iniciado = true;
+    }
+
+    void reiniciar() {
+        ultimo = 0;
+        delta = 0;
+        inicioTramo = 0;
+        iniciado = false;
+    }
+
+    /** Instante de la última lectura (0 si no hubo ninguna) */
+    std::int64_t obtenerUltimo() const {
+        return ultimo;
+    }
+
+    bool estaIniciado() const {
+        return iniciado;
+    }
+
+private:
+    std::int64_t ultimo;        ///< Instante de la última lectura
+    std::int64_t delta;         ///< Delta de la última lectura (0 al abrir tramo)
+    std::int64_t inicioTramo;   ///< Instante de la primera lectura del tramo
+    bool iniciado;
+};
+
+/** Recorre un tramo reconstruyendo los instantes a partir de su punto */
+struct DecodificadorMarcas {
+    std::int64_t instante;
+    std::int64_t delta;
+
+    DecodificadorMarcas() : instante(0), delta(0) {}
+
+    template <typename Posicion>
+    void situar(const PuntoTiempo<Posicion>& punto) {
+        instante = punto.instanteMs;
+        delta = punto.deltaMs;
+    }
+
+    /** Instante de la lectura siguiente del tramo, dada su marca */
+    std::int64_t avanzar(std::int32_t marca) {
+        delta += marca;
+        instante += delta;
+        return instante;
+    }
+};
+
+/**
+ * Índice del punto desde el que se decodifica para llegar a desdeMs: el
+ * último con instante < desdeMs (las lecturas iguales a desdeMs pueden
+ * empezar en el tramo anterior), o 0. instanteDe(i) da el instante del
+ * punto i; los n puntos están ordenados. O(log n).
+ */
+template <typename Acceso>
+std::size_t buscarPuntoTiempo(std::size_t n, std::int64_t desdeMs, Acceso instanteDe) {
+    std::size_t bajo = 0;
+    std::size_t alto = n;   // Primer punto con instante >= desdeMs en [bajo, alto]
+    while (bajo < alto) {
+        std::size_t medio = bajo + (alto - bajo) / 2;
+        if (instanteDe(medio) < desdeMs) {
+            bajo = medio + 1;
+        } else {
+            alto = medio;
+        }
+    }
+    return (bajo == 0) ? 0 : bajo - 1;
+}
+
+#endif // MARCAS_TIEMPO_HPP
@@ -0,0 +1,553 @@
+#ifndef METRICAS_SISTEMA_HPP
+#define METRICAS_SISTEMA_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "InternadorNombres.hpp"
+
+/**
+ * Métricas internas del sistema: contadores por sensor, por puerto y por
+ * cola, e histogramas de latencia, expuestos en el formato de texto de
+ * Prometheus (0.0.4) para que un recolector local los lea.
+ *
+ * La ruta de datos sólo toca memoria propia del hilo que la usa:
+ *  - Los contadores de un sensor, puerto o cola tienen un único hilo
+ *    escritor (el que ya es dueño de ese sensor o puerto), así que se
+ *    incrementan con load + store relajados, sin instrucción atómica de
+ *    lectura-modificación-escritura. Cada ranura ocupa su propia línea
+ *    de caché: sensores vecinos pertenecen a aplicadores distintos.
+ *  - Los histogramas se fragmentan por hilo; cada fragmento está
+ *    alineado a línea de caché y se suman al leerlos.
+ * Las lecturas de otros hilos (exposición) son atómicas y nunca frenan
+ * a los escritores.
+ */
+
+/** Instante monotónico en nanosegundos (para latencias) */
+inline std::int64_t relojMetricasNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Índice fijo del hilo actual, asignado por turnos la primera vez */
+inline unsigned indiceFragmentoHilo() {
+    static std::atomic<unsigned> siguiente(0);
+    thread_local unsigned indice = siguiente.fetch_add(1, std::memory_order_relaxed);
+    return indice;
+}
+
+/** Incremento para contadores con un único hilo escritor */
+inline void sumarUnEscritor(std::atomic<std::uint64_t>& contador, std::uint64_t n) {
+    contador.store(contador.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/// Copia consolidada de un HistogramaLatencia
+struct ResumenHistograma {
+    std::vector<std::uint64_t> cubetas;
+    std::uint64_t cantidad;
+    std::uint64_t suma;
+    std::uint64_t maximo;
+
+    ResumenHistograma() : cantidad(0), suma(0), maximo(0) {}
+
+    /** Cota superior del valor en el cuantil q (0..1); 0 si está vacío */
+    std::uint64_t percentil(double q) const;
+
+    double promedio() const {
+        return (cantidad == 0) ? 0.0 : static_cast<double>(suma) / static_cast<double>(cantidad);
+    }
+};
+
+/**
+ * Histograma log-lineal al estilo HDR para valores enteros (ns).
+ *
+ * Cada potencia de dos se divide en 16 subcubetas, así que el error
+ * relativo de un cuantil es a lo sumo 1/16 (6.25 %); los valores menores
+ * que 16 son exactos. Cubre hasta 2^41 ns (~36 min); lo mayor cae en la
+ * última cubeta. registrar() es un fetch_add relajado sobre el fragmento
+ * del hilo, sin contención entre hilos.
+ */
+class HistogramaLatencia {
+public:
+    static const int BITS_SUBCUBETA = 4;
+    static const int SUBCUBETAS = 1 << BITS_SUBCUBETA;
+    static const int EXPONENTE_MAXIMO = 40;
+    static const int CUBETAS = (EXPONENTE_MAXIMO - BITS_SUBCUBETA + 2) * SUBCUBETAS;
+    static const int FRAGMENTOS = 8;
+
+    HistogramaLatencia() {
+        for (int f = 0; f < FRAGMENTOS; f++) {
+            for (int i = 0; i < CUBETAS; i++) {
+                fragmentos[f].cubetas[i].store(0, std::memory_order_relaxed);
+            }
+            fragmentos[f].suma.store(0, std::memory_order_relaxed);
+            fragmentos[f].maximo.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    HistogramaLatencia(const HistogramaLatencia&) = delete;
+    HistogramaLatencia& operator=(const HistogramaLatencia&) = delete;
+
+    /** Registra `veces` muestras con el mismo valor (negativos cuentan como 0) */
+    void registrar(std::int64_t valor, std::uint64_t veces = 1) {
+        std::uint64_t v = (valor < 0) ? 0 : static_cast<std::uint64_t>(valor);
+        Fragmento& f = fragmentos[indiceFragmentoHilo() % FRAGMENTOS];
+        f.cubetas[indiceCubeta(v)].fetch_add(veces, std::memory_order_relaxed);
+        f.suma.fetch_add(v * veces, std::memory_order_relaxed);
+        std::uint64_t maximo = f.maximo.load(std::memory_order_relaxed);
+        while (v > maximo && !f.maximo.compare_exchange_weak(maximo, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    /** Suma los fragmentos (aproximado mientras otros hilos registran) */
+    ResumenHistograma resumir() const {
+        ResumenHistograma r;
+        r.cubetas.assign(CUBETAS, 0);
+        for (int f = 0; f < FRAGMENTOS; f++) {
+            for (int i = 0; i < CUBETAS; i++) {
+                std::uint64_t c = fragmentos[f].cubetas[i].load(std::memory_order_relaxed);
+                r.cubetas[i] += c;
+                r.cantidad += c;
+            }
+            r.suma += fragmentos[f].suma.load(std::memory_order_relaxed);
+            std::uint64_t m = fragmentos[f].maximo.load(std::memory_order_relaxed);
+            if (m > r.maximo) {
+                r.maximo = m;
+            }
+        }
+        return r;
+    }
+
+    static int indiceCubeta(std::uint64_t v) {
+        if (v < static_cast<std::uint64_t>(SUBCUBETAS)) {
+            return static_cast<int>(v);
+        }
+        int exponente = bitMasAlto(v);
+        if (exponente > EXPONENTE_MAXIMO) {
+            return CUBETAS - 1;
+        }
+        int desplazamiento = exponente - BITS_SUBCUBETA;
+        return (desplazamiento + 1) * SUBCUBETAS + static_cast<int>((v >> desplazamiento) - SUBCUBETAS);
+    }
+
+    /** Mayor valor que cae en la cubeta i (inclusive) */
+    static std::uint64_t limiteSuperior(int i) {
+        if (i < SUBCUBETAS) {
+            return static_cast<std::uint64_t>(i);
+        }
+        int desplazamiento = i / SUBCUBETAS - 1;
+        std::uint64_t inferior = static_cast<std::uint64_t>(SUBCUBETAS + i % SUBCUBETAS) << desplazamiento;
+        return inferior + (std::uint64_t(1) << desplazamiento) - 1;
+    }
+
+private:
+    static int bitMasAlto(std::uint64_t v) {
+        #if defined(__GNUC__) || defined(__clang__)
+            return 63 - __builtin_clzll(v);
+        #else
+            int b = 0;
+            while (v >>= 1) {
+                b++;
+            }
+            return b;
+        #endif
+    }
+
+    struct alignas(64) Fragmento {
+        std::atomic<std::uint64_t> cubetas[CUBETAS];
+        std::atomic<std::uint64_t> suma;
+        std::atomic<std::uint64_t> maximo;
+    };
+
+    Fragmento fragmentos[FRAGMENTOS];
+};
+
+inline std::uint64_t ResumenHistograma::percentil(double q) const {
+    if (cantidad == 0) {
+        return 0;
+    }
+    std::uint64_t objetivo = static_cast<std::uint64_t>(q * static_cast<double>(cantidad));
+    if (objetivo == 0) {
+        objetivo = 1;
+    }
+    std::uint64_t acumulado = 0;
+    for (std::size_t i = 0; i < cubetas.size(); i++) {
+        acumulado += cubetas[i];
+        if (acumulado >= objetivo) {
+            std::uint64_t limite = HistogramaLatencia::limiteSuperior(static_cast<int>(i));
+            return (limite < maximo) ? limite : maximo;
+        }
+    }
+    return maximo;
+}
+
+/// Contadores de un sensor; `aceptadas` y `anomalias` las escribe sólo su hilo aplicador
+struct alignas(64) MetricasSensor {
+    std::atomic<std::uint64_t> aceptadas;
+    std::atomic<std::uint64_t> rechazadas;   ///< Línea con su ID pero valor inválido
+    std::atomic<std::uint64_t> anomalias;    ///< Detectadas por DetectorAnomalias
+    char nombre[50];
+
+    MetricasSensor() : aceptadas(0), rechazadas(0), anomalias(0) { nombre[0] = '\0'; }
+};
+
+/// Contadores de un puerto serie; los escribe el hilo que lo lee
+struct alignas(64) MetricasPuerto {
+    std::atomic<std::uint64_t> bytesLeidos;
+    std::atomic<std::uint64_t> lineasValidas;
+    std::atomic<std::uint64_t> erroresInterpretacion;
+    std::atomic<std::uint64_t> sensoresDesconocidos;
+    char nombre[256];
+
+    MetricasPuerto() : bytesLeidos(0), lineasValidas(0), erroresInterpretacion(0),
+                       sensoresDesconocidos(0) { nombre[0] = '\0'; }
+};
+
+/// Ocupación de una cola; la escribe su hilo consumidor
+struct alignas(64) MetricasCola {
+    std::atomic<std::uint64_t> profundidad;
+    std::atomic<std::uint64_t> profundidadMaxima;
+    std::atomic<std::uint64_t> capacidad;
+    char nombre[32];
+
+    MetricasCola() : profundidad(0), profundidadMaxima(0), capacidad(0) { nombre[0] = '\0'; }
+
+    void observar(std::uint64_t actual) {
+        profundidad.store(actual, std::memory_order_relaxed);
+        if (actual > profundidadMaxima.load(std::memory_order_relaxed)) {
+            profundidadMaxima.store(actual, std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * Arreglo de ranuras que nunca se mueven: crece por bloques y los
+ * bloques ya publicados no se liberan hasta el destructor. Agregar
+ * requiere el candado del registro; leer [0, obtenerCantidad()) no.
+ */
+template <typename T>
+class TablaMetricas {
+public:
+    static const std::uint32_t TAMANIO_BLOQUE = 256;
+    static const std::uint32_t MAXIMO_BLOQUES = 4096;
+
+    TablaMetricas() : cantidad(0) {
+        for (std::uint32_t b = 0; b < MAXIMO_BLOQUES; b++) {
+            bloques[b] = nullptr;
+        }
+    }
+
+    ~TablaMetricas() {
+        for (std::uint32_t b = 0; b < MAXIMO_BLOQUES; b++) {
+            delete[] bloques[b];
+        }
+    }
+
+    TablaMetricas(const TablaMetricas&) = delete;
+    TablaMetricas& operator=(const TablaMetricas&) = delete;
+
+    /** Ranura nueva (sin publicar) o nullptr si la tabla está llena */
+    T* reservar() {
+        std::uint32_t n = cantidad.load(std::memory_order_relaxed);
+        std::uint32_t b = n / TAMANIO_BLOQUE;
+        if (b >= MAXIMO_BLOQUES) {
+            return nullptr;
+        }
+        if (bloques[b] == nullptr) {
+            bloques[b] = new T[TAMANIO_BLOQUE];
+        }
+        return &bloques[b][n % TAMANIO_BLOQUE];
+    }
+
+    /** Hace visible la ranura reservada a los lectores */
+    void publicar() {
+        cantidad.store(cantidad.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::uint32_t obtenerCantidad() const {
+        return cantidad.load(std::memory_order_acquire);
+    }
+
+    T& operator[](std::uint32_t i) const {
+        return bloques[i / TAMANIO_BLOQUE][i % TAMANIO_BLOQUE];
+    }
+
+private:
+    T* bloques[MAXIMO_BLOQUES];
+    std::atomic<std::uint32_t> cantidad;
+};
+
+/**
+ * Registro de todas las métricas de un proceso. Las ranuras se piden por
+ * nombre (la misma ranura si el nombre ya existía, p. ej. al reconectar
+ * un puerto) y viven lo mismo que el registro.
+ */
+class RegistroMetricas {
+public:
+    RegistroMetricas() {}
+
+    RegistroMetricas(const RegistroMetricas&) = delete;
+    RegistroMetricas& operator=(const RegistroMetricas&) = delete;
+
+    /** Ranura del sensor; nullptr sólo si se agotó la tabla */
+    MetricasSensor* sensor(std::string_view nombre) {
+        return ranura(sensores, nombresSensores, nombre);
+    }
+
+    MetricasPuerto* puerto(std::string_view nombre) {
+        return ranura(puertos, nombresPuertos, nombre);
+    }
+
+    MetricasCola* cola(std::string_view nombre) {
+        return ranura(colas, nombresColas, nombre);
+    }
+
+    /** Desde que una lectura sale del puerto serie hasta que queda en su sensor */
+    HistogramaLatencia& latenciaIngesta() { return histogramaIngesta; }
+    const HistogramaLatencia& latenciaIngesta() const { return histogramaIngesta; }
+
+    /** Duración de cada llamada a procesarLectura */
+    HistogramaLatencia& duracionProcesamiento() { return histogramaProcesamiento; }
+    const HistogramaLatencia& duracionProcesamiento() const { return histogramaProcesamiento; }
+
+    /** Escribe todas las métricas en el formato de texto de Prometheus */
+    void exponer(std::ostream& os) const {
+        std::uint32_t n = sensores.obtenerCantidad();
+        encabezado(os, "sistemaiot_lecturas_aceptadas_total", "counter",
+                   "Lecturas registradas en cada sensor.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_lecturas_aceptadas_total", "sensor", sensores[i].nombre,
+                    sensores[i].aceptadas.load(std::memory_order_relaxed));
+        }
+        encabezado(os, "sistemaiot_lecturas_rechazadas_total", "counter",
+                   "Líneas con el ID del sensor pero un valor inválido.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_lecturas_rechazadas_total", "sensor", sensores[i].nombre,
+                    sensores[i].rechazadas.load(std::memory_order_relaxed));
+        }
+        encabezado(os, "sistemaiot_anomalias_total", "counter",
+                   "Lecturas marcadas como anómalas en la ingesta.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_anomalias_total", "sensor", sensores[i].nombre,
+                    sensores[i].anomalias.load(std::memory_order_relaxed));
+        }
+
+        n = puertos.obtenerCantidad();
+        encabezado(os, "sistemaiot_puerto_bytes_leidos_total", "counter", "Bytes leídos de cada puerto serie.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_puerto_bytes_leidos_total", "puerto", puertos[i].nombre,
+                    puertos[i].bytesLeidos.load(std::memory_order_relaxed));
+        }
+        encabezado(os, "sistemaiot_puerto_lineas_validas_total", "counter", "Líneas ID:valor bien formadas.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_puerto_lineas_validas_total", "puerto", puertos[i].nombre,
+                    puertos[i].lineasValidas.load(std::memory_order_relaxed));
+        }
+        encabezado(os, "sistemaiot_puerto_errores_interpretacion_total", "counter",
+                   "Líneas malformadas descartadas por el intérprete.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_puerto_errores_interpretacion_total", "puerto", puertos[i].nombre,
+                    puertos[i].erroresInterpretacion.load(std::memory_order_relaxed));
+        }
+        encabezado(os, "sistemaiot_puerto_sensores_desconocidos_total", "counter",
+                   "Líneas válidas cuyo ID no está registrado.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_puerto_sensores_desconocidos_total", "puerto", puertos[i].nombre,
+                    puertos[i].sensoresDesconocidos.load(std::memory_order_relaxed));
+        }
+
+        n = colas.obtenerCantidad();
+        encabezado(os, "sistemaiot_cola_profundidad", "gauge", "Lecturas pendientes en cada cola lector->aplicador.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_cola_profundidad", "cola", colas[i].nombre,
+                    colas[i].profundidad.load(std::memory_order_relaxed));
+        }
+        encabezado(os, "sistemaiot_cola_profundidad_maxima", "gauge", "Mayor profundidad observada.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_cola_profundidad_maxima", "cola", colas[i].nombre,
+                    colas[i].profundidadMaxima.load(std::memory_order_relaxed));
+        }
+        encabezado(os, "sistemaiot_cola_capacidad", "gauge", "Capacidad de cada cola.");
+        for (std::uint32_t i = 0; i < n; i++) {
+            muestra(os, "sistemaiot_cola_capacidad", "cola", colas[i].nombre,
+                    colas[i].capacidad.load(std::memory_order_relaxed));
+        }
+
+        histograma(os, "sistemaiot_latencia_ingesta_segundos",
+                   "Desde la lectura del puerto serie hasta el registro en el sensor.", histogramaIngesta);
+        histograma(os, "sistemaiot_duracion_procesamiento_segundos",
+                   "Duración de procesarLectura por sensor.", histogramaProcesamiento);
+    }
+
+    /**
+     * Escribe la exposición en ruta.tmp y la renombra sobre ruta, así un
+     * recolector nunca ve un archivo a medio escribir.
+     */
+    bool volcarArchivo(const std::string& ruta) const {
+        std::string temporal = ruta + ".tmp";
+        {
+            std::ofstream archivo(temporal, std::ios::trunc);
+            if (!archivo) {
+                return false;
+            }
+            exponer(archivo);
+            if (!archivo) {
+                return false;
+            }
+        }
+        #ifdef _WIN32
+            std::remove(ruta.c_str());
+        #endif
+        return std::rename(temporal.c_str(), ruta.c_str()) == 0;
+    }
+
+private:
+    template <typename T>
+    T* ranura(TablaMetricas<T>& tabla, InternadorNombres& nombres, std::string_view nombre) {
+        std::lock_guard<std::mutex> guardia(candado);
+        std::int32_t existente = nombres.buscar(nombre);
+        if (existente != InternadorNombres::NO_ENCONTRADO) {
+            return &tabla[static_cast<std::uint32_t>(existente)];
+        }
+        T* nueva = tabla.reservar();
+        if (nueva == nullptr) {
+            return nullptr;
+        }
+        std::size_t largo = (nombre.size() < sizeof(nueva->nombre)) ? nombre.size() : sizeof(nueva->nombre) - 1;
+        std::memcpy(nueva->nombre, nombre.data(), largo);
+        nueva->nombre[largo] = '\0';
+        nombres.internar(nombre);
+        tabla.publicar();
+        return nueva;
+    }
+
+    static void encabezado(std::ostream& os, const char* metrica, const char* tipo, const char* ayuda) {
+        os << "# HELP " << metrica << ' ' << ayuda << "\n# TYPE " << metrica << ' ' << tipo << '\n';
+    }
+
+    /** Valor de etiqueta con '\\', '"' y saltos de línea escapados */
+    static void etiqueta(std::ostream& os, const char* valor) {
+        for (const char* c = valor; *c != '\0'; c++) {
+            if (*c == '\\' || *c == '"') {
+                os << '\\' << *c;
+            } else if (*c == '\n') {
+                os << "\\n";
+            } else {
+                os << *c;
+            }
+        }
+    }
+
+    static void muestra(std::ostream& os, const char* metrica, const char* clave, const char* valorEtiqueta,
+                        std::uint64_t valor) {
+        os << metrica << '{' << clave << "=\"";
+        etiqueta(os, valorEtiqueta);
+        os << "\"} " << valor << '\n';
+    }
+
+    /** Sólo se emiten las cubetas con muestras (más +Inf), acumuladas */
+    static void histograma(std::ostream& os, const char* metrica, const char* ayuda,
+                           const HistogramaLatencia& h) {
+        encabezado(os, metrica, "histogram", ayuda);
+        ResumenHistograma r = h.resumir();
+        char limite[32];
+        std::uint64_t acumulado = 0;
+        for (int i = 0; i < HistogramaLatencia::CUBETAS; i++) {
+            if (r.cubetas[i] == 0) {
+                continue;
+            }
+            acumulado += r.cubetas[i];
+            std::snprintf(limite, sizeof(limite), "%.9g",
+                          static_cast<double>(HistogramaLatencia::limiteSuperior(i) + 1) * 1e-9);
+            os << metrica << "_bucket{le=\"" << limite << "\"} " << acumulado << '\n';
+        }
+        os << metrica << "_bucket{le=\"+Inf\"} " << r.cantidad << '\n';
+        std::snprintf(limite, sizeof(limite), "%.9g", static_cast<double>(r.suma) * 1e-9);
+        os << metrica << "_sum " << limite << '\n';
+        os << metrica << "_count " << r.cantidad << '\n';
+    }
+
+    std::mutex candado;   ///< Sólo para crear ranuras
+    InternadorNombres nombresSensores;
+    InternadorNombres nombresPuertos;
+    InternadorNombres nombresColas;
+    TablaMetricas<MetricasSensor> sensores;
+    TablaMetricas<MetricasPuerto> puertos;
+    TablaMetricas<MetricasCola> colas;
+    HistogramaLatencia histogramaIngesta;
+    HistogramaLatencia histogramaProcesamiento;
+};
+
+/**
+ * Hilo que vuelca el registro a un archivo cada `periodo` (para un
+ * recolector de archivos de texto). Al detenerse escribe una última vez.
+ */
+class VolcadorMetricas {
+public:
+    VolcadorMetricas(const RegistroMetricas& registroMetricas, const std::string& rutaArchivo,
+                     std::chrono::milliseconds periodoVolcado)
+        : registro(registroMetricas), ruta(rutaArchivo), periodo(periodoVolcado), activo(false) {}
+
+    ~VolcadorMetricas() {
+        detener();
+    }
+
+    VolcadorMetricas(const VolcadorMetricas&) = delete;
+    VolcadorMetricas& operator=(const VolcadorMetricas&) = delete;
+
+    void iniciar() {
+        std::lock_guard<std::mutex> guardia(candado);
+        if (activo) {
+            return;
+        }
+        activo = true;
+        hilo = std::thread(&VolcadorMetricas::bucle, this);
+    }
+
+    void detener() {
+        {
+            std::lock_guard<std::mutex> guardia(candado);
+            if (!activo) {
+                return;
+            }
+            activo = false;
+        }
+        despertar.notify_one();
+        hilo.join();
+        registro.volcarArchivo(ruta);
+    }
+
+private:
+    void bucle() {
+        std::unique_lock<std::mutex> guardia(candado);
+        while (activo) {
+            if (despertar.wait_for(guardia, periodo, [this]() { return !activo; })) {
+                break;
+            }
+            guardia.unlock();
+            registro.volcarArchivo(ruta);
+            guardia.lock();
+        }
+    }
+
+    const RegistroMetricas& registro;
+    const std::string ruta;
+    const std::chrono::milliseconds periodo;
+
+    std::mutex candado;
+    std::condition_variable despertar;
+    std::thread hilo;
+    bool activo;
+};
+
+#endif // METRICAS_SISTEMA_HPP
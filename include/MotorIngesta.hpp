@@ -0,0 +1,316 @@
+#ifndef MOTOR_INGESTA_HPP
+#define MOTOR_INGESTA_HPP
+
+#include <cstring>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "ComunicacionSerial.hpp"
+#include "GestorSensores.hpp"
+#include "MetricasSistema.hpp"
+#include "ParserLecturas.hpp"
+
+#ifndef _WIN32
+    #include <poll.h>
+#endif
+
+/// Resultado de interpretar una línea "ID:valor"
+enum class ResultadoLinea {
+    Aceptada,            ///< Lectura registrada en su sensor
+    Vacia,               ///< Línea en blanco (se ignora)
+    Invalida,            ///< No respeta el formato ID:valor
+    SensorDesconocido    ///< Formato válido pero el ID no está registrado
+};
+
+/// Motivo por el que regresó esperarYProcesar()
+enum class EventoIngesta {
+    SinEventos,          ///< Se agotó el tiempo de espera
+    Datos,               ///< Se leyeron y despacharon bytes del puerto
+    EntradaExtra,        ///< El descriptor adicional tiene datos (p. ej. stdin)
+    Error                ///< El puerto se cerró o falló la lectura
+};
+
+/**
+ * Motor de ingesta: lee el puerto serial sin bloquear y despacha cada
+ * línea "ID:valor" al sensor correspondiente de GestorSensores.
+ *
+ * Espera con poll() y lee en bloques grandes directamente sobre un buffer
+ * de recepción propio. Las líneas que quedan cortadas entre dos lecturas
+ * se completan en la siguiente; los bytes ya consumidos se recuperan
+ * desplazando el resto al inicio (a diferencia de un anillo que da la
+ * vuelta, así cada línea queda contigua y ParserLecturas la interpreta
+ * en su lugar). Ninguna línea provoca reservas de memoria.
+ *
+ * leerDisponible() no registra línea por línea: junta las lecturas del
+ * ciclo de lectura y al final entrega a cada sensor las suyas en un lote
+ * (GestorSensores::registrarAgrupadas).
+ *
+ * Con un RegistroMetricas asignado, cada bloque leído lleva su instante de
+ * llegada y los contadores del puerto se publican una vez por llamada a
+ * leerDisponible(), no por línea.
+ */
+class MotorIngesta {
+public:
+    static const int TAMANIO_BUFFER = 64 * 1024;
+    static const std::size_t LECTURAS_POR_LOTE = 4096;   ///< Tope de lecturas sin aplicar
+
+    MotorIngesta(ComunicacionSerial& puertoSerial, GestorSensores& gestorSensores)
+        : puerto(puertoSerial), gestor(gestorSensores), usados(0), descartando(false),
+          bytesLeidos(0), lecturasAceptadas(0), sensoresDesconocidos(0),
+          metricas(nullptr), metricasPuerto(nullptr), instanteLlegada(0),
+          bytesPublicados(0), validasPublicadas(0), invalidasPublicadas(0), desconocidosPublicados(0) {
+        pendientes.reserve(LECTURAS_POR_LOTE);
+    }
+
+    MotorIngesta(const MotorIngesta&) = delete;
+    MotorIngesta& operator=(const MotorIngesta&) = delete;
+
+    /**
+     * Espera hasta timeoutMs a que el puerto (o fdExtra, si es >= 0) tenga
+     * datos; lee todo lo disponible y despacha las líneas completas.
+     */
+    EventoIngesta esperarYProcesar(int timeoutMs, int fdExtra = -1) {
+        #ifdef _WIN32
+            // En Windows el puerto ya tiene timeouts de lectura configurados
+            (void)timeoutMs;
+            (void)fdExtra;
+            int n = leerDisponible();
+            if (n < 0) return EventoIngesta::Error;
+            return (n > 0) ? EventoIngesta::Datos : EventoIngesta::SinEventos;
+        #else
+            pollfd fds[2];
+            fds[0].fd = puerto.obtenerDescriptor();
+            fds[0].events = POLLIN;
+            fds[0].revents = 0;
+            nfds_t total = 1;
+            if (fdExtra >= 0) {
+                fds[1].fd = fdExtra;
+                fds[1].events = POLLIN;
+                fds[1].revents = 0;
+                total = 2;
+            }
+
+            int listos = ::poll(fds, total, timeoutMs);
+            if (listos < 0) {
+                return (errno == EINTR) ? EventoIngesta::SinEventos : EventoIngesta::Error;
+            }
+
+            EventoIngesta evento = EventoIngesta::SinEventos;
+            if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+                int n = leerDisponible();
+                if (n < 0 || (n == 0 && (fds[0].revents & (POLLHUP | POLLERR)))) {
+                    return EventoIngesta::Error;
+                }
+                evento = EventoIngesta::Datos;
+            }
+            if (total == 2 && (fds[1].revents & (POLLIN | POLLHUP))) {
+                evento = EventoIngesta::EntradaExtra;
+            }
+            return evento;
+        #endif
+    }
+
+    /**
+     * Publica desde ahora los contadores del puerto (ya conectado) en el
+     * registro y mide la latencia de ingesta. nullptr desactiva las métricas.
+     */
+    void asignarMetricas(RegistroMetricas* registro) {
+        metricas = registro;
+        metricasPuerto = (registro != nullptr) ? registro->puerto(puerto.obtenerNombre()) : nullptr;
+        bytesPublicados = bytesLeidos;
+        validasPublicadas = parser.obtenerLineasValidas();
+        invalidasPublicadas = parser.obtenerLineasInvalidas();
+        desconocidosPublicados = sensoresDesconocidos;
+    }
+
+    /** Lee del puerto hasta vaciarlo y despacha las líneas completas.
+     *  Retorna los bytes leídos o -1 si el puerto falló.
+     */
+    int leerDisponible() {
+        std::uint64_t antes = lecturasAceptadas;
+        int n = leerDisponible([this](const LecturaCruda& lectura) { acumular(lectura); });
+        aplicarPendientes();
+        if (metricas != nullptr && lecturasAceptadas > antes) {
+            // Todas las lecturas del bloque quedaron registradas ahora
+            metricas->latenciaIngesta().registrar(relojMetricasNs() - instanteLlegada,
+                                                  lecturasAceptadas - antes);
+        }
+        return n;
+    }
+
+    /** Igual que leerDisponible(), pero entrega cada lectura válida a
+     *  destino(const LecturaCruda&) en lugar de registrarla directamente.
+     *  El ID de la lectura sólo es válido durante la llamada.
+     */
+    template <typename Destino>
+    int leerDisponible(Destino&& destino) {
+        int total = 0;
+        while (true) {
+            if (usados == TAMANIO_BUFFER) {
+                // Una línea ocupa el buffer completo: se descarta
+                usados = 0;
+                descartando = true;
+                parser.contarInvalida();
+            }
+            int n = puerto.leer(buffer + usados, TAMANIO_BUFFER - usados);
+            if (n < 0) {
+                publicarMetricas();
+                return -1;
+            }
+            if (n == 0) {
+                break;
+            }
+            if (metricas != nullptr) {
+                instanteLlegada = relojMetricasNs();
+            }
+            int desde = usados;
+            usados += n;
+            total += n;
+            bytesLeidos += static_cast<std::uint64_t>(n);
+            despacharLineas(desde, destino);
+            if (n < TAMANIO_BUFFER / 2) {
+                break;  // Lectura corta: ya no queda más en el puerto
+            }
+        }
+        publicarMetricas();
+        return total;
+    }
+
+    /** Interpreta y despacha una línea "ID:valor" suelta (sin '\n') */
+    ResultadoLinea procesarLinea(std::string_view linea) {
+        LecturaCruda lectura;
+        switch (parser.interpretarLinea(linea, lectura)) {
+            case ClaseLinea::Valida:
+                return despachar(lectura);
+            case ClaseLinea::Vacia:
+                return ResultadoLinea::Vacia;
+            case ClaseLinea::Invalida:
+                if (!lectura.id.empty()) {
+                    gestor.contarRechazada(lectura.id);
+                }
+                break;
+        }
+        return ResultadoLinea::Invalida;
+    }
+
+    /** Lo llama quien resuelve los IDs fuera del motor (ServicioMultipuerto) */
+    void contarSensorDesconocido() {
+        sensoresDesconocidos++;
+    }
+
+    /** Instante (relojMetricasNs) en que se leyó el último bloque; 0 sin métricas */
+    std::int64_t obtenerInstanteLlegada() const { return instanteLlegada; }
+
+    std::uint64_t obtenerBytesLeidos() const { return bytesLeidos; }
+    std::uint64_t obtenerLecturasAceptadas() const { return lecturasAceptadas; }
+    std::uint64_t obtenerLineasInvalidas() const { return parser.obtenerLineasInvalidas(); }
+    std::uint64_t obtenerSensoresDesconocidos() const { return sensoresDesconocidos; }
+
+private:
+    /** Registra la lectura en su sensor resolviendo el ID por el índice hash */
+    ResultadoLinea despachar(const LecturaCruda& lectura) {
+        std::int32_t id = gestor.obtenerIdSensor(lectura.id);
+        if (id < 0) {
+            sensoresDesconocidos++;
+            return ResultadoLinea::SensorDesconocido;
+        }
+        gestor.registrarLectura(static_cast<std::uint32_t>(id), lectura.valor);
+        lecturasAceptadas++;
+        return ResultadoLinea::Aceptada;
+    }
+
+    /** Resuelve el ID y deja la lectura pendiente para el lote del ciclo */
+    void acumular(const LecturaCruda& lectura) {
+        std::int32_t id = gestor.obtenerIdSensor(lectura.id);
+        if (id < 0) {
+            sensoresDesconocidos++;
+            return;
+        }
+        LecturaPorId pendiente;
+        pendiente.idSensor = static_cast<std::uint32_t>(id);
+        pendiente.valor = lectura.valor;
+        pendientes.push_back(pendiente);
+        lecturasAceptadas++;
+        if (pendientes.size() == LECTURAS_POR_LOTE) {
+            aplicarPendientes();
+        }
+    }
+
+    /** Entrega a cada sensor sus lecturas pendientes en un lote */
+    void aplicarPendientes() {
+        if (!pendientes.empty()) {
+            gestor.registrarAgrupadas(pendientes.data(), pendientes.size());
+            pendientes.clear();
+        }
+    }
+
+    /** Despacha las líneas completas del buffer y conserva la incompleta */
+    template <typename Destino>
+    void despacharLineas(int desde, Destino& destino) {
+        char* inicio = buffer;
+        char* fin = buffer + usados;
+
+        if (descartando) {
+            // Saltar el resto de una línea demasiado larga hasta su '\n'
+            char* salto = static_cast<char*>(std::memchr(buffer + desde, '\n', fin - (buffer + desde)));
+            if (salto == nullptr) {
+                usados = 0;
+                return;
+            }
+            descartando = false;
+            inicio = salto + 1;
+        }
+
+        std::size_t consumidos = parser.interpretar(inicio, static_cast<std::size_t>(fin - inicio), destino,
+                                                    [this](std::string_view id) { gestor.contarRechazada(id); });
+        inicio += consumidos;
+
+        int resto = static_cast<int>(fin - inicio);
+        if (inicio != buffer && resto > 0) {
+            std::memmove(buffer, inicio, resto);
+        }
+        usados = resto;
+    }
+
+    /** Suma al registro lo acumulado desde la última publicación */
+    void publicarMetricas() {
+        if (metricasPuerto == nullptr) {
+            return;
+        }
+        std::uint64_t validas = parser.obtenerLineasValidas();
+        std::uint64_t invalidas = parser.obtenerLineasInvalidas();
+        metricasPuerto->bytesLeidos.fetch_add(bytesLeidos - bytesPublicados, std::memory_order_relaxed);
+        metricasPuerto->lineasValidas.fetch_add(validas - validasPublicadas, std::memory_order_relaxed);
+        metricasPuerto->erroresInterpretacion.fetch_add(invalidas - invalidasPublicadas, std::memory_order_relaxed);
+        metricasPuerto->sensoresDesconocidos.fetch_add(sensoresDesconocidos - desconocidosPublicados,
+                                                       std::memory_order_relaxed);
+        bytesPublicados = bytesLeidos;
+        validasPublicadas = validas;
+        invalidasPublicadas = invalidas;
+        desconocidosPublicados = sensoresDesconocidos;
+    }
+
+    ComunicacionSerial& puerto;
+    GestorSensores& gestor;
+
+    char buffer[TAMANIO_BUFFER];     ///< Bytes recibidos aún sin despachar
+    int usados;                      ///< Bytes válidos en buffer
+    bool descartando;                ///< Saltando una línea demasiado larga
+
+    ParserLecturas parser;           ///< Intérprete de líneas ID:valor
+
+    std::uint64_t bytesLeidos;
+    std::uint64_t lecturasAceptadas;
+    std::uint64_t sensoresDesconocidos;
+
+    RegistroMetricas* metricas;        ///< Registro (opcional, no propio)
+    MetricasPuerto* metricasPuerto;    ///< Ranura de este puerto en el registro
+    std::int64_t instanteLlegada;      ///< relojMetricasNs del último bloque leído
+    std::uint64_t bytesPublicados;
+    std::uint64_t validasPublicadas;
+    std::uint64_t invalidasPublicadas;
+    std::uint64_t desconocidosPublicados;
+    std::vector<LecturaPorId> pendientes;   ///< Lecturas del ciclo aún sin registrar
+};
+
+#endif // MOTOR_INGESTA_HPP
@@ -0,0 +1,154 @@
+#ifndef PARSER_LECTURAS_HPP
+#define PARSER_LECTURAS_HPP
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+
+/// Clasificación de una línea de entrada
+enum class ClaseLinea {
+    Valida,      ///< "ID:valor" bien formada
+    Vacia,       ///< Sólo espacios (se ignora sin contarse)
+    Invalida     ///< Malformada
+};
+
+/// Lectura interpretada: el ID apunta dentro del buffer de entrada
+struct LecturaCruda {
+    std::string_view id;   ///< Identificador del sensor (sin copiar)
+    double valor;          ///< Valor numérico de la lectura
+};
+
+/**
+ * Intérprete del formato de línea "ID:valor" que envía sensor.ino.
+ *
+ * Trabaja directamente sobre el buffer de ingesta: no copia ni reserva
+ * memoria, devuelve el ID como std::string_view y convierte el valor con
+ * std::from_chars (sin locale ni terminador '\0'). interpretar() procesa
+ * todas las líneas completas de un bloque en una sola llamada y lleva la
+ * cuenta de líneas válidas y malformadas en lugar de imprimirlas.
+ */
+class ParserLecturas {
+public:
+    static const std::size_t LONGITUD_MAX_ID = 49;   ///< Igual que SensorBase::nombre
+
+    ParserLecturas() : lineasValidas(0), lineasInvalidas(0) {}
+
+    /**
+     * Interpreta las líneas completas ('\n') de [datos, datos + n) y llama
+     * destino(const LecturaCruda&) por cada una válida. Las líneas vacías
+     * se ignoran. Retorna los bytes consumidos: lo que sigue al último
+     * '\n' es una línea incompleta que debe volver a entregarse.
+     */
+    template <typename Destino>
+    std::size_t interpretar(const char* datos, std::size_t n, Destino&& destino) {
+        return interpretar(datos, n, destino, [](std::string_view) {});
+    }
+
+    /**
+     * Igual que interpretar(datos, n, destino), y además llama
+     * rechazo(std::string_view id) por cada línea malformada cuyo ID sí es
+     * válido (el valor no es numérico, está vacío o trae basura).
+     */
+    template <typename Destino, typename Rechazo>
+    std::size_t interpretar(const char* datos, std::size_t n, Destino&& destino, Rechazo&& rechazo) {
+        const char* inicio = datos;
+        const char* fin = datos + n;
+        LecturaCruda lectura;
+
+        while (inicio < fin) {
+            const char* salto = static_cast<const char*>(std::memchr(inicio, '\n', fin - inicio));
+            if (salto == nullptr) {
+                break;
+            }
+            std::string_view linea(inicio, static_cast<std::size_t>(salto - inicio));
+            switch (clasificar(linea, lectura)) {
+                case ClaseLinea::Valida:
+                    lineasValidas++;
+                    destino(lectura);
+                    break;
+                case ClaseLinea::Invalida:
+                    lineasInvalidas++;
+                    if (!lectura.id.empty()) {
+                        rechazo(lectura.id);
+                    }
+                    break;
+                case ClaseLinea::Vacia:
+                    break;
+            }
+            inicio = salto + 1;
+        }
+        return static_cast<std::size_t>(inicio - datos);
+    }
+
+    /**
+     * Interpreta una sola línea (sin '\n'); si es válida llena salida.
+     * Actualiza los contadores igual que interpretar().
+     */
+    ClaseLinea interpretarLinea(std::string_view linea, LecturaCruda& salida) {
+        ClaseLinea clase = clasificar(linea, salida);
+        if (clase == ClaseLinea::Valida) {
+            lineasValidas++;
+        } else if (clase == ClaseLinea::Invalida) {
+            lineasInvalidas++;
+        }
+        return clase;
+    }
+
+    /** Registra una línea descartada por el llamador (p. ej. demasiado larga) */
+    void contarInvalida() {
+        lineasInvalidas++;
+    }
+
+    std::uint64_t obtenerLineasValidas() const { return lineasValidas; }
+    std::uint64_t obtenerLineasInvalidas() const { return lineasInvalidas; }
+
+private:
+    static bool esEspacio(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    static ClaseLinea clasificar(std::string_view linea, LecturaCruda& salida) {
+        std::size_t a = 0;
+        std::size_t b = linea.size();
+        while (a < b && esEspacio(linea[a])) a++;
+        while (b > a && esEspacio(linea[b - 1])) b--;
+        if (a == b) {
+            return ClaseLinea::Vacia;
+        }
+
+        const char* inicio = linea.data() + a;
+        const char* fin = linea.data() + b;
+        const char* separador = static_cast<const char*>(std::memchr(inicio, ':', fin - inicio));
+        if (separador == nullptr || separador == inicio ||
+            static_cast<std::size_t>(separador - inicio) > LONGITUD_MAX_ID) {
+            salida.id = std::string_view();
+            return ClaseLinea::Invalida;
+        }
+
+        // Desde aquí el ID es válido: una línea inválida lo deja en salida.id
+        salida.id = std::string_view(inicio, static_cast<std::size_t>(separador - inicio));
+        const char* numero = separador + 1;
+        while (numero < fin && esEspacio(*numero)) numero++;
+        if (numero == fin) {
+            return ClaseLinea::Invalida;
+        }
+
+        double valor = 0.0;
+        std::from_chars_result r = std::from_chars(numero, fin, valor);
+        if (r.ec != std::errc() || r.ptr != fin || !std::isfinite(valor)) {
+            return ClaseLinea::Invalida;
+        }
+
+        salida.valor = valor;
+        return ClaseLinea::Valida;
+    }
+
+    std::uint64_t lineasValidas;     ///< Líneas con formato correcto
+    std::uint64_t lineasInvalidas;   ///< Líneas malformadas (sin imprimir)
+};
+
+#endif // PARSER_LECTURAS_HPP
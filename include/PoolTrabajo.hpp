@@ -0,0 +1,214 @@
+#ifndef POOL_TRABAJO_HPP
+#define POOL_TRABAJO_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Pool de hilos con robo de trabajo para recorrer índices [0, n).
+ *
+ * paraCada() reparte el intervalo en un rango contiguo por trabajador.
+ * Cada rango se guarda empaquetado (inicio, fin) en un solo entero
+ * atómico: el dueño toma índices del frente y, cuando se queda sin
+ * trabajo, roba la mitad final del rango de otro trabajador, ambos con
+ * compare_exchange y sin candados. Así los sensores con historiales
+ * largos no dejan hilos ociosos mientras otros siguen ocupados.
+ *
+ * El hilo que llama a paraCada() participa como trabajador 0; el pool
+ * crea hilos - 1 hilos adicionales que duermen entre llamadas.
+ */
+class PoolTrabajo {
+public:
+    explicit PoolTrabajo(int hilos = static_cast<int>(std::thread::hardware_concurrency()))
+        : numTrabajadores(hilos < 1 ? 1 : hilos),
+          rangos(new Rango[static_cast<std::size_t>(numTrabajadores)]),
+          tarea(nullptr), contexto(nullptr), generacion(0), pendientes(0),
+          terminando(false), robos(0) {
+        for (int t = 1; t < numTrabajadores; t++) {
+            auxiliares.emplace_back(&PoolTrabajo::bucleTrabajador, this, t);
+        }
+    }
+
+    ~PoolTrabajo() {
+        {
+            std::lock_guard<std::mutex> guardia(mutex);
+            terminando = true;
+        }
+        hayTrabajo.notify_all();
+        for (std::thread& h : auxiliares) {
+            h.join();
+        }
+    }
+
+    PoolTrabajo(const PoolTrabajo&) = delete;
+    PoolTrabajo& operator=(const PoolTrabajo&) = delete;
+
+    int obtenerHilos() const {
+        return numTrabajadores;
+    }
+
+    /** Robos de trabajo realizados desde que se creó el pool */
+    std::uint64_t obtenerRobos() const {
+        return robos.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Llama funcion(indice, trabajador) una vez por cada índice de [0, n)
+     * y regresa cuando todas terminaron. El orden de ejecución no está
+     * definido; funcion no debe lanzar excepciones.
+     */
+    template <typename Funcion>
+    void paraCada(std::size_t n, Funcion&& funcion) {
+        if (n == 0) {
+            return;
+        }
+        if (numTrabajadores == 1 || n == 1) {
+            for (std::size_t i = 0; i < n; i++) {
+                funcion(i, 0);
+            }
+            return;
+        }
+
+        const std::uint64_t total = static_cast<std::uint64_t>(n);
+        for (int t = 0; t < numTrabajadores; t++) {
+            std::uint64_t inicio = total * static_cast<std::uint64_t>(t) / numTrabajadores;
+            std::uint64_t fin = total * static_cast<std::uint64_t>(t + 1) / numTrabajadores;
+            rangos[t].valor.store(empaquetar(inicio, fin), std::memory_order_relaxed);
+        }
+
+        typedef typename std::remove_reference<Funcion>::type TipoFuncion;
+        {
+            std::lock_guard<std::mutex> guardia(mutex);
+            tarea = &invocar<TipoFuncion>;
+            contexto = const_cast<void*>(static_cast<const void*>(&funcion));
+            pendientes = numTrabajadores - 1;
+            generacion++;
+        }
+        hayTrabajo.notify_all();
+
+        trabajar(0);
+
+        std::unique_lock<std::mutex> candado(mutex);
+        terminado.wait(candado, [this]() { return pendientes == 0; });
+    }
+
+private:
+    /// Rango [inicio, fin) de un trabajador, en su propia línea de caché
+    struct alignas(64) Rango {
+        std::atomic<std::uint64_t> valor;
+        Rango() : valor(0) {}
+    };
+
+    typedef void (*Tarea)(void*, std::size_t, int);
+
+    static std::uint64_t empaquetar(std::uint64_t inicio, std::uint64_t fin) {
+        return (inicio << 32) | fin;
+    }
+
+    template <typename TipoFuncion>
+    static void invocar(void* funcion, std::size_t indice, int trabajador) {
+        (*static_cast<TipoFuncion*>(funcion))(indice, trabajador);
+    }
+
+    /** Toma el siguiente índice del rango propio */
+    bool tomarPropio(int trabajador, std::size_t& indice) {
+        std::atomic<std::uint64_t>& rango = rangos[trabajador].valor;
+        std::uint64_t actual = rango.load(std::memory_order_acquire);
+        while (true) {
+            std::uint64_t inicio = actual >> 32;
+            std::uint64_t fin = actual & 0xFFFFFFFFu;
+            if (inicio >= fin) {
+                return false;
+            }
+            if (rango.compare_exchange_weak(actual, empaquetar(inicio + 1, fin),
+                                            std::memory_order_acq_rel)) {
+                indice = static_cast<std::size_t>(inicio);
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Roba la mitad final del rango de otro trabajador y la deja como
+     * rango propio. Un índice sólo puede estar en un rango a la vez, así
+     * que un valor (inicio, fin) no vuelve a repetirse (sin problema ABA).
+     */
+    bool robar(int trabajador) {
+        for (int k = 1; k < numTrabajadores; k++) {
+            std::atomic<std::uint64_t>& victima = rangos[(trabajador + k) % numTrabajadores].valor;
+            std::uint64_t actual = victima.load(std::memory_order_acquire);
+            while (true) {
+                std::uint64_t inicio = actual >> 32;
+                std::uint64_t fin = actual & 0xFFFFFFFFu;
+                if (inicio >= fin) {
+                    break;
+                }
+                std::uint64_t mitad = inicio + (fin - inicio) / 2;
+                if (victima.compare_exchange_weak(actual, empaquetar(inicio, mitad),
+                                                  std::memory_order_acq_rel)) {
+                    rangos[trabajador].valor.store(empaquetar(mitad, fin), std::memory_order_release);
+                    robos.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void trabajar(int trabajador) {
+        std::size_t indice;
+        while (true) {
+            if (tomarPropio(trabajador, indice)) {
+                tarea(contexto, indice, trabajador);
+            } else if (!robar(trabajador)) {
+                // Todos los rangos vacíos: lo que esté en tránsito lo
+                // termina el trabajador que lo robó
+                return;
+            }
+        }
+    }
+
+    void bucleTrabajador(int trabajador) {
+        std::uint64_t vista = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> candado(mutex);
+                hayTrabajo.wait(candado, [&]() { return terminando || generacion != vista; });
+                if (terminando) {
+                    return;
+                }
+                vista = generacion;
+            }
+            trabajar(trabajador);
+            {
+                std::lock_guard<std::mutex> guardia(mutex);
+                pendientes--;
+            }
+            terminado.notify_one();
+        }
+    }
+
+    const int numTrabajadores;
+    std::unique_ptr<Rango[]> rangos;
+    std::vector<std::thread> auxiliares;
+
+    std::mutex mutex;
+    std::condition_variable hayTrabajo;
+    std::condition_variable terminado;
+    Tarea tarea;                ///< Función de la llamada en curso (tipo borrado)
+    void* contexto;             ///< Objeto función de la llamada en curso
+    std::uint64_t generacion;   ///< Se incrementa con cada paraCada()
+    int pendientes;             ///< Trabajadores auxiliares que no han terminado
+    bool terminando;
+
+    std::atomic<std::uint64_t> robos;
+};
+
+#endif // POOL_TRABAJO_HPP
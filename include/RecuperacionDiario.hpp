@@ -0,0 +1,182 @@
+#ifndef RECUPERACION_DIARIO_HPP
+#define RECUPERACION_DIARIO_HPP
+
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include "DiarioLecturas.hpp"
+#include "GestorSensores.hpp"
+#include "InstantaneaSensores.hpp"
+#include "SensorTemperatura.hpp"
+#include "SensorPresion.hpp"
+
+/**
+ * Crea un sensor vacío del tipo y con el historial indicados, o nullptr si
+ * el tipo no existe. La ventana de un historial acotado va en ms.
+ */
+inline SensorBase* crearSensorRecuperado(std::uint8_t tipo, const char* nombre,
+                                         HistorialInstantanea historial = HistorialInstantanea::Lista,
+                                         std::size_t capacidad = 0, std::int64_t ventanaMs = 0) {
+    std::chrono::milliseconds ventana(ventanaMs);
+    if (tipo == static_cast<std::uint8_t>(TipoSensor::Temperatura)) {
+        switch (historial) {
+            case HistorialInstantanea::Bloques:  return new SensorTemperaturaBloques(nombre);
+            case HistorialInstantanea::Circular: return new SensorTemperaturaCircular(nombre, capacidad, ventana);
+            default:                             return new SensorTemperatura(nombre);
+        }
+    }
+    if (tipo == static_cast<std::uint8_t>(TipoSensor::Presion)) {
+        switch (historial) {
+            case HistorialInstantanea::Bloques:  return new SensorPresionBloques(nombre);
+            case HistorialInstantanea::Circular: return new SensorPresionCircular(nombre, capacidad, ventana);
+            default:                             return new SensorPresion(nombre);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Destino de DiarioLecturas::reproducir que recrea en un GestorSensores
+ * los sensores definidos en el diario y les aplica sus lecturas con la
+ * hora original (los resúmenes por minuto/hora quedan como estaban).
+ * Los procesamientos anotados se repiten en el mismo punto, así que lo
+ * que procesarLectura quitó del historial vuelve a quitarse.
+ *
+ * Un sensor que ya está en el gestor (cargado de la instantánea) se
+ * reutiliza por nombre; los demás se recrean con el historial, capacidad
+ * y ventana anotados en su registro 'S'.
+ */
+class RecuperacionDiario {
+public:
+    explicit RecuperacionDiario(GestorSensores& gestorSensores)
+        : gestor(gestorSensores), lecturasHuerfanas(0) {}
+
+    void definirSensor(std::uint32_t id, std::uint8_t tipo, std::string_view nombre,
+                       std::uint8_t historial, std::uint64_t capacidad, std::int64_t ventanaMs) {
+        char nombreSensor[50];
+        std::size_t largo = nombre.size() < sizeof(nombreSensor) - 1 ? nombre.size() : sizeof(nombreSensor) - 1;
+        std::memcpy(nombreSensor, nombre.data(), largo);
+        nombreSensor[largo] = '\0';
+
+        SensorBase* sensor = gestor.buscarSensor(nombreSensor);
+        if (sensor == nullptr) {
+            sensor = crearSensorRecuperado(tipo, nombreSensor, static_cast<HistorialInstantanea>(historial),
+                                           static_cast<std::size_t>(capacidad), ventanaMs);
+            if (sensor == nullptr) {
+                std::cerr << "[Error] Tipo de sensor desconocido en el diario: " << static_cast<int>(tipo) << std::endl;
+                return;
+            }
+            gestor.agregarSensor(sensor);
+        }
+        if (id >= porIdDiario.size()) {
+            porIdDiario.resize(id + 1, nullptr);
+        }
+        porIdDiario[id] = sensor;
+    }
+
+    void aplicarLectura(std::uint32_t id, std::int64_t instanteMs, double valor) {
+        if (id < porIdDiario.size() && porIdDiario[id] != nullptr) {
+            porIdDiario[id]->registrarLecturaEn(valor, instanteMs);
+        } else {
+            lecturasHuerfanas++;
+        }
+    }
+
+    /** Repite el procesamiento (que puede quitar lecturas) sin mostrarlo */
+    void aplicarProceso(std::uint32_t id) {
+        if (id < porIdDiario.size() && porIdDiario[id] != nullptr) {
+            std::ostream descarte(nullptr);
+            porIdDiario[id]->procesarLectura(descarte);
+        }
+    }
+
+    /** Lecturas cuyo sensor no tenía definición válida */
+    std::uint64_t obtenerLecturasHuerfanas() const {
+        return lecturasHuerfanas;
+    }
+
+private:
+    GestorSensores& gestor;
+    std::vector<SensorBase*> porIdDiario;   ///< Id del diario -> sensor recreado
+    std::uint64_t lecturasHuerfanas;
+};
+
+/**
+ * Agrega a gestor los sensores de una instantánea, con su historial,
+ * capacidad y agregados. Las lecturas se copian directo de la columna
+ * mapeada al historial. Retorna cuántos sensores se recuperaron.
+ */
+inline std::uint32_t restaurarInstantanea(const InstantaneaMapeada& instantanea, GestorSensores& gestor) {
+    std::ostream descarte(nullptr);
+    RedireccionBitacora silencio(descarte);
+    std::uint32_t restaurados = 0;
+    for (std::uint32_t i = 0; i < instantanea.obtenerCantidad(); i++) {
+        const FichaInstantanea& ficha = instantanea.ficha(i);
+        SensorBase* sensor = crearSensorRecuperado(ficha.tipo, ficha.nombre,
+                                                   static_cast<HistorialInstantanea>(ficha.historial),
+                                                   static_cast<std::size_t>(ficha.capacidad), ficha.ventanaMs);
+        if (sensor == nullptr || !sensor->restaurar(instantanea, i)) {
+            std::cerr << "[Error] Ficha " << i << " de la instantánea no válida." << std::endl;
+            delete sensor;
+            continue;
+        }
+        gestor.agregarSensor(sensor);
+        restaurados++;
+    }
+    return restaurados;
+}
+
+/**
+ * Aplica a gestor lo anotado en el diario y lo deja anotando las lecturas
+ * nuevas en él. Si antes se cargó una instantánea, generacionInstantanea
+ * es la suya: sólo se aplica el diario que la continúa.
+ */
+inline ResumenReproduccion recuperarDiario(DiarioLecturas& diario, GestorSensores& gestor,
+                                           std::uint64_t generacionInstantanea = 0) {
+    ResumenReproduccion resumen;
+    {
+        // Sin bitácora por lectura durante la reproducción
+        std::ostream descarte(nullptr);
+        RedireccionBitacora silencio(descarte);
+        RecuperacionDiario recuperacion(gestor);
+        resumen = diario.reproducir(recuperacion, generacionInstantanea);
+    }
+    if (diario.estaAbierto()) {
+        gestor.asignarDiario(&diario);
+    }
+    return resumen;
+}
+
+/**
+ * Punto de control: guarda la instantánea de gestor en ruta y, si hay
+ * diario, lo vacía para que sólo contenga lo posterior. Así el próximo
+ * arranque mapea la instantánea y reproduce un diario corto.
+ *
+ * El orden es lo que hace segura una caída en cualquier punto:
+ *  1. el diario se sincroniza (todo lo anotado está en disco);
+ *  2. guardar() escribe el temporal, fsync, rename y fsync del
+ *     directorio, y sólo entonces retorna true;
+ *  3. recién ahí se reinicia el diario con la generación nueva.
+ * Si guardar() falla, el diario queda intacto con su generación.
+ */
+inline bool guardarPuntoControl(GestorSensores& gestor, DiarioLecturas* diario, const char* ruta) {
+    std::uint64_t generacion = 1;
+    if (diario != nullptr && diario->estaAbierto()) {
+        diario->sincronizar();
+        generacion = diario->obtenerGeneracion() + 1;
+    }
+    EscritorInstantanea escritor;
+    gestor.volcarInstantanea(escritor);
+    if (!escritor.guardar(ruta, generacion)) {
+        return false;   // Sin instantánea durable no se toca el diario
+    }
+    if (diario != nullptr && diario->estaAbierto() && diario->reiniciar(generacion)) {
+        gestor.asignarDiario(diario);
+    }
+    return true;
+}
+
+#endif // RECUPERACION_DIARIO_HPP
@@ -2,7 +2,24 @@
 #define SENSOR_BASE_HPP
 
 #include <iostream>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <vector>
+#include "AgregadosTemporales.hpp"
+#include "BocetoCuantiles.hpp"
+#include "MarcasTiempo.hpp"
+
+class EscritorInstantanea;
+class InstantaneaMapeada;
+struct FichaInstantanea;
+
+/// Tipo concreto de un sensor (se guarda en el diario para recrearlo)
+enum class TipoSensor : std::uint8_t {
+    Temperatura = 1,
+    Presion = 2
+};
 
 /**
 
@@ -18,17 +35,29 @@ public:
     /** nom Nombre identificador del sensor
      */
     SensorBase(const char* nom) {
-        std::strncpy(nombre, nom, sizeof(nombre) - 1);
-        nombre[sizeof(nombre) - 1] = '\0';
+        std::size_t largo = std::strlen(nom);   // Se trunca si no cabe
+        if (largo >= sizeof(nombre)) {
+            largo = sizeof(nombre) - 1;
+        }
+        std::memcpy(nombre, nom, largo);
+        nombre[largo] = '\0';
     }
 
     /** Destructor virtual para permitir polimorfismo correcto
      */
     virtual ~SensorBase() {}
 
-    /** Método virtual puro para procesar lecturas
+    /** Procesa las lecturas escribiendo el resultado en std::cout
      */
-    virtual void procesarLectura() = 0;
+    virtual void procesarLectura() {
+        procesarLectura(std::cout);
+    }
+
+    /** Método virtual puro para procesar lecturas; todo el texto va a
+     *  salida, lo que permite procesar varios sensores en paralelo y
+     *  emitir sus resultados después en orden
+     */
+    virtual void procesarLectura(std::ostream& salida) = 0;
 
     /** Método virtual puro para imprimir información del sensor
      */
@@ -43,6 +72,87 @@ public:
     /** Registra una lectura (método virtual) valor Valor de la lectura (genérico)
      */
     virtual void registrarLectura(double valor) = 0;
+
+    /** Registra una lectura tomada en instanteMs (ms del reloj del sistema);
+     *  la usan el diario y la reproducción para conservar la hora original
+     */
+    virtual void registrarLecturaEn(double valor, std::int64_t instanteMs) {
+        (void)instanteMs;
+        registrarLectura(valor);
+    }
+
+    /** Registra n lecturas de una vez con la hora actual: una sola llamada
+     *  virtual por lote en lugar de una por lectura
+     */
+    void registrarLecturas(const double* valores, std::size_t n) {
+        registrarLecturasEn(valores, n, AgregadosTemporales::ahoraMilisegundos());
+    }
+
+    /** Registra n lecturas tomadas en el mismo instante. La versión base
+     *  las pasa una a una; los sensores concretos convierten el lote en un
+     *  bucle vectorizable y lo anexan al historial en una operación
+     */
+    virtual void registrarLecturasEn(const double* valores, std::size_t n, std::int64_t instanteMs) {
+        for (std::size_t i = 0; i < n; i++) {
+            registrarLecturaEn(valores[i], instanteMs);
+        }
+    }
+
+    /** Agrega a salida las lecturas del historial con desdeMs <= instante
+     *  <= hastaMs (ms del reloj del sistema), de la más antigua a la más
+     *  reciente; retorna cuántas agregó
+     */
+    virtual std::size_t lecturasEntre(std::int64_t desdeMs, std::int64_t hastaMs,
+                                      std::vector<LecturaTemporal>& salida) const {
+        (void)desdeMs;
+        (void)hastaMs;
+        (void)salida;
+        return 0;
+    }
+
+    /** Lecturas del historial de los últimos `duracion` (p. ej. 5 minutos) */
+    std::size_t lecturasUltimos(std::chrono::milliseconds duracion,
+                                std::vector<LecturaTemporal>& salida) const {
+        std::int64_t ahora = AgregadosTemporales::ahoraMilisegundos();
+        return lecturasEntre(ahora - duracion.count(), ahora, salida);
+    }
+
+    /** Tipo concreto del sensor
+     */
+    virtual TipoSensor obtenerTipo() const = 0;
+
+    /** Resúmenes por segundo/minuto/hora del sensor, o nullptr si no los lleva
+     */
+    virtual const AgregadosTemporales* obtenerAgregados() const {
+        return nullptr;
+    }
+
+    /** Bocetos de cuantiles por minuto del sensor, o nullptr si no los lleva.
+     *  Cubren todas las lecturas recibidas, también las ya eliminadas del
+     *  historial (son percentiles históricos, no del historial actual)
+     */
+    virtual const CuantilesTemporales* obtenerCuantiles() const {
+        return nullptr;
+    }
+
+    /** Copia profunda del sensor con su tipo concreto (constructor virtual);
+     *  la usa el constructor de copia de GestorSensores
+     */
+    virtual SensorBase* clonar() const = 0;
+
+    /** Vuelca tipo, nombre, historial y agregados a una instantánea
+     */
+    virtual void serializar(EscritorInstantanea& escritor) const = 0;
+
+    /** Anota en ficha el tipo de historial, su capacidad y su ventana (lo
+     *  que hace falta para recrear el sensor vacío); por omisión, Lista
+     */
+    virtual void describirHistorial(FichaInstantanea&) const {}
+
+    /** Carga historial y agregados de la ficha indice de una instantánea;
+     *  retorna false si la ficha no corresponde a este tipo de sensor
+     */
+    virtual bool restaurar(const InstantaneaMapeada& instantanea, std::uint32_t indice) = 0;
 };
 
 #endif // SENSOR_BASE_HPP
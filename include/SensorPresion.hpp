@@ -3,49 +3,125 @@
 
 #include "SensorBase.hpp"
 #include "ListaSensor.hpp"
+#include "ListaSensorBloques.hpp"
+#include "ListaSensorCircular.hpp"
+#include "InstantaneaSensores.hpp"
+#include "Bitacora.hpp"
 
 /**
  * @brief Sensor especializado en mediciones de presión
  * 
  * Hereda de SensorBase e implementa los métodos virtuales puros.
- * Utiliza ListaSensor<int> para almacenar el historial de mediciones.
+ * Utiliza ListaSensor<int> para almacenar el historial de mediciones;
+ * el parámetro Historial permite elegir otro contenedor con la misma
+ * interfaz (p. ej. ListaSensorBloques<int>) en tiempo de compilación.
  */
-class SensorPresion : public SensorBase {
+template <typename Historial>
+class SensorPresionGen : public SensorBase {
 private:
-    ListaSensor<int> historial;  ///< Historial de lecturas de presión
+    AgregadosTemporales agregados;  ///< Resúmenes 1 s / 1 min / 1 h
+    /// Percentiles por minuto (t-digest) de todas las lecturas recibidas:
+    /// no descuentan las que eliminarMinimo() o el anillo ya descartaron
+    CuantilesTemporales cuantiles;
+    Historial historial;  ///< Historial de lecturas de presión
 
 public:
 
-    SensorPresion(const char* nom) : SensorBase(nom) {
-        std::cout << "[SensorPresion] Sensor '" << nombre << "' creado." << std::endl;
+    /** Los argumentos adicionales se pasan al constructor del historial
+     *  (p. ej. capacidad y ventana de ListaSensorCircular)
+     */
+    template <typename... ArgsHistorial>
+    SensorPresionGen(const char* nom, ArgsHistorial&&... args)
+        : SensorBase(nom), historial(std::forward<ArgsHistorial>(args)...) {
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[SensorPresion] Sensor '" << nombre << "' creado.";
+        });
     }
 
 
-    ~SensorPresion() {
-        std::cout << "[Destructor SensorPresion] Liberando Lista Interna de '" 
-                  << nombre << "'..." << std::endl;
+    SensorPresionGen(const SensorPresionGen&) = default;
+    SensorPresionGen& operator=(const SensorPresionGen&) = default;
+
+    /** Mover el sensor traspasa historial y agregados sin copiarlos
+     *  (p. ej. al crecer el arreglo de AlmacenSensores)
+     */
+    SensorPresionGen(SensorPresionGen&&) = default;
+    SensorPresionGen& operator=(SensorPresionGen&&) = default;
+
+    ~SensorPresionGen() {
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Destructor SensorPresion] Liberando Lista Interna de '"
+               << nombre << "'...";
+        });
     }
 
 
     void registrarLectura(double valor) override {
+        registrarLecturaEn(valor, AgregadosTemporales::ahoraMilisegundos());
+    }
+
+    void registrarLecturaEn(double valor, std::int64_t instanteMs) override {
         int presionInt = static_cast<int>(valor);
-        std::cout << "[" << nombre << "] Registrando lectura: " << presionInt << " Pa" << std::endl;
-        historial.insertar(presionInt);
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[" << nombre << "] Registrando lectura: " << presionInt << " Pa";
+        });
+        historial.insertarEn(presionInt, instanteMs);
+        agregados.registrarEn(presionInt, instanteMs);
+        cuantiles.registrarEn(presionInt, instanteMs);
+    }
+
+    using SensorBase::registrarLecturas;
+
+    void registrarLecturasEn(const double* valores, std::size_t n, std::int64_t instanteMs) override {
+        int convertidas[LOTE_CONVERSION];
+        for (std::size_t desde = 0; desde < n; desde += LOTE_CONVERSION) {
+            std::size_t m = (n - desde < LOTE_CONVERSION) ? n - desde : LOTE_CONVERSION;
+            for (std::size_t i = 0; i < m; i++) {
+                convertidas[i] = static_cast<int>(valores[desde + i]);
+            }
+            anexarLote(convertidas, m, instanteMs);
+        }
+    }
+
+    /** Lote ya convertido a int: se anexa sin copia intermedia */
+    void registrarLecturas(const int* valores, std::size_t n) {
+        anexarLote(valores, n, AgregadosTemporales::ahoraMilisegundos());
     }
 
+    TipoSensor obtenerTipo() const override {
+        return TipoSensor::Presion;
+    }
+
+    using SensorBase::procesarLectura;
 
-    void procesarLectura() override {
+    void procesarLectura(std::ostream& salida) override {
         if (historial.estaVacia()) {
-            std::cout << "[SensorPresion] " << nombre << " - Sin lecturas registradas." << std::endl;
+            salida << "[SensorPresion] " << nombre << " - Sin lecturas registradas." << std::endl;
             return;
         }
 
-        std::cout << "\n-> Procesando Sensor " << nombre << "..." << std::endl;
+        salida << "\n-> Procesando Sensor " << nombre << "..." << std::endl;
         
         double promedio = historial.calcularPromedio();
-        std::cout << "[Sensor Presion] Promedio calculado sobre " 
-                  << historial.obtenerCantidad() << " lectura(s): " 
-                  << promedio << " Pa" << std::endl;
+        salida << "[Sensor Presion] Promedio calculado sobre " 
+               << historial.obtenerCantidad() << " lectura(s): " 
+               << promedio << " Pa" << std::endl;
+
+        ResumenRango minuto = agregados.consultarUltimos(std::chrono::minutes(1));
+        if (!minuto.estaVacio()) {
+            salida << "[Sensor Presion] Último minuto: " << minuto.cantidad << " lectura(s), "
+                   << "promedio " << minuto.promedio() << " Pa, mín " << minuto.minimo
+                   << " Pa, máx " << minuto.maximo << " Pa" << std::endl;
+        }
+
+        // Población distinta del promedio: todo lo recibido, no sólo el historial actual
+        if (!cuantiles.estaVacio()) {
+            BocetoCuantiles todas = cuantiles.consultarTodo();
+            salida << "[Sensor Presion] Percentiles históricos (todas las lecturas recibidas, "
+                   << todas.obtenerCantidad() << "): p50 "
+                   << todas.cuantil(0.50) << " Pa, p95 " << todas.cuantil(0.95) << " Pa, p99 "
+                   << todas.cuantil(0.99) << " Pa" << std::endl;
+        }
     }
 
 
@@ -57,11 +133,78 @@ public:
         historial.imprimir();
     }
 
+    std::size_t lecturasEntre(std::int64_t desdeMs, std::int64_t hastaMs,
+                              std::vector<LecturaTemporal>& salida) const override {
+        std::size_t antes = salida.size();
+        historial.paraCadaEnIntervalo(desdeMs, hastaMs, [&salida](const int& valor, std::int64_t instante) {
+            LecturaTemporal lectura = { instante, static_cast<double>(valor) };
+            salida.push_back(lectura);
+        });
+        return salida.size() - antes;
+    }
+
+    const AgregadosTemporales* obtenerAgregados() const override {
+        return &agregados;
+    }
+
+    const CuantilesTemporales* obtenerCuantiles() const override {
+        return &cuantiles;
+    }
+
+    SensorBase* clonar() const override {
+        return new SensorPresionGen(*this);
+    }
+
+    void serializar(EscritorInstantanea& escritor) const override {
+        escritor.agregarSensor<int>(obtenerTipo(), nombre, historial, agregados);
+    }
+
+    void describirHistorial(FichaInstantanea& ficha) const override {
+        EscritorInstantanea::describir(historial, ficha);
+    }
+
+    bool restaurar(const InstantaneaMapeada& instantanea, std::uint32_t indice) override {
+        if (!instantanea.cargarSensor<int>(indice, historial, agregados)) {
+            return false;
+        }
+        // La instantánea no guarda bocetos: se rehacen con el historial
+        // restaurado, sin instante, en el histórico (las lecturas eliminadas
+        // antes de la instantánea ya no cuentan)
+        historial.paraCada([this](const int& valor) {
+            cuantiles.registrarHistorico(valor);
+        });
+        return true;
+    }
+
     // Obtiene la cantidad de lecturas registradas
     // Retorna la cantidad de lecturas
     int obtenerCantidadLecturas() const {
         return historial.obtenerCantidad();
     }
+
+private:
+    static const std::size_t LOTE_CONVERSION = 256;  ///< Lecturas convertidas por tramo
+
+    void anexarLote(const int* valores, std::size_t n, std::int64_t instanteMs) {
+        if (n == 0) {
+            return;
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[" << nombre << "] Registrando " << n << " lectura(s) en lote";
+        });
+        historial.insertarVariosEn(valores, static_cast<int>(n), instanteMs);
+        agregados.registrarVariosEn(valores, n, instanteMs);
+        cuantiles.registrarVariosEn(valores, n, instanteMs);
+    }
 };
 
+/// Versión predeterminada: historial en lista enlazada simple
+typedef SensorPresionGen<ListaSensor<int> > SensorPresion;
+
+/// Historial desenrollado: los recorridos leen memoria contigua
+typedef SensorPresionGen<ListaSensorBloques<int> > SensorPresionBloques;
+
+/// Historial acotado (anillo): memoria fija por sensor
+typedef SensorPresionGen<ListaSensorCircular<int> > SensorPresionCircular;
+
 #endif // SENSOR_PRESION_HPP
@@ -3,51 +3,132 @@
 
 #include "SensorBase.hpp"
 #include "ListaSensor.hpp"
-
-
-class SensorTemperatura : public SensorBase {
+#include "ListaSensorBloques.hpp"
+#include "ListaSensorCircular.hpp"
+#include "InstantaneaSensores.hpp"
+#include "Bitacora.hpp"
+
+/**
+ * Sensor de temperatura (lecturas float).
+ *
+ * El contenedor del historial se elige en tiempo de compilación:
+ * cualquier tipo con la interfaz de ListaSensor<float> sirve.
+ */
+template <typename Historial>
+class SensorTemperaturaGen : public SensorBase {
 private:
-    ListaSensor<float> historial;  ///< Historial de lecturas de temperatura
+    AgregadosTemporales agregados;  ///< Resúmenes 1 s / 1 min / 1 h
+    /// Percentiles por minuto (t-digest) de todas las lecturas recibidas:
+    /// no descuentan las que eliminarMinimo() o el anillo ya descartaron
+    CuantilesTemporales cuantiles;
+    Historial historial;  ///< Historial de lecturas de temperatura
 
 public:
 
-    SensorTemperatura(const char* nom) : SensorBase(nom) {
-        std::cout << "[SensorTemperatura] Sensor '" << nombre << "' creado." << std::endl;
+    /** Los argumentos adicionales se pasan al constructor del historial
+     *  (p. ej. capacidad y ventana de ListaSensorCircular)
+     */
+    template <typename... ArgsHistorial>
+    SensorTemperaturaGen(const char* nom, ArgsHistorial&&... args)
+        : SensorBase(nom), historial(std::forward<ArgsHistorial>(args)...) {
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[SensorTemperatura] Sensor '" << nombre << "' creado.";
+        });
     }
 
    
-    ~SensorTemperatura() {
-        std::cout << "[Destructor SensorTemperatura] Liberando Lista Interna de '" 
-                  << nombre << "'..." << std::endl;
+    SensorTemperaturaGen(const SensorTemperaturaGen&) = default;
+    SensorTemperaturaGen& operator=(const SensorTemperaturaGen&) = default;
+
+    /** Mover el sensor traspasa historial y agregados sin copiarlos
+     *  (p. ej. al crecer el arreglo de AlmacenSensores)
+     */
+    SensorTemperaturaGen(SensorTemperaturaGen&&) = default;
+    SensorTemperaturaGen& operator=(SensorTemperaturaGen&&) = default;
+
+    ~SensorTemperaturaGen() {
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[Destructor SensorTemperatura] Liberando Lista Interna de '"
+               << nombre << "'...";
+        });
     }
 
 
     void registrarLectura(double valor) override {
+        registrarLecturaEn(valor, AgregadosTemporales::ahoraMilisegundos());
+    }
+
+    void registrarLecturaEn(double valor, std::int64_t instanteMs) override {
         float temperaturaFloat = static_cast<float>(valor);
-        std::cout << "[" << nombre << "] Registrando lectura: " << temperaturaFloat << "°C" << std::endl;
-        historial.insertar(temperaturaFloat);
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[" << nombre << "] Registrando lectura: " << temperaturaFloat << "°C";
+        });
+        historial.insertarEn(temperaturaFloat, instanteMs);
+        agregados.registrarEn(temperaturaFloat, instanteMs);
+        cuantiles.registrarEn(temperaturaFloat, instanteMs);
     }
 
-    void procesarLectura() override {
+    using SensorBase::registrarLecturas;
+
+    void registrarLecturasEn(const double* valores, std::size_t n, std::int64_t instanteMs) override {
+        float convertidas[LOTE_CONVERSION];
+        for (std::size_t desde = 0; desde < n; desde += LOTE_CONVERSION) {
+            std::size_t m = (n - desde < LOTE_CONVERSION) ? n - desde : LOTE_CONVERSION;
+            for (std::size_t i = 0; i < m; i++) {
+                convertidas[i] = static_cast<float>(valores[desde + i]);
+            }
+            anexarLote(convertidas, m, instanteMs);
+        }
+    }
+
+    /** Lote ya convertido a float: se anexa sin copia intermedia */
+    void registrarLecturas(const float* valores, std::size_t n) {
+        anexarLote(valores, n, AgregadosTemporales::ahoraMilisegundos());
+    }
+
+    TipoSensor obtenerTipo() const override {
+        return TipoSensor::Temperatura;
+    }
+
+
+    using SensorBase::procesarLectura;
+
+    void procesarLectura(std::ostream& salida) override {
         if (historial.estaVacia()) {
-            std::cout << "[SensorTemperatura] " << nombre << " - Sin lecturas registradas." << std::endl;
+            salida << "[SensorTemperatura] " << nombre << " - Sin lecturas registradas." << std::endl;
             return;
         }
 
         float minimo = historial.obtenerMinimo();
         
-        std::cout << "\n-> Procesando Sensor " << nombre << "..." << std::endl;
-        std::cout << "[Sensor Temp] Lectura más baja (" << minimo << "°C) eliminada." << std::endl;
+        salida << "\n-> Procesando Sensor " << nombre << "..." << std::endl;
+        salida << "[Sensor Temp] Lectura más baja (" << minimo << "°C) eliminada." << std::endl;
         
         historial.eliminarMinimo();
 
         if (!historial.estaVacia()) {
             double promedio = historial.calcularPromedio();
-            std::cout << "[Sensor Temp] Promedio calculado sobre " 
-                      << historial.obtenerCantidad() << " lectura(s): " 
-                      << promedio << "°C" << std::endl;
+            salida << "[Sensor Temp] Promedio calculado sobre " 
+                   << historial.obtenerCantidad() << " lectura(s): " 
+                   << promedio << "°C" << std::endl;
         } else {
-            std::cout << "[Sensor Temp] Sin lecturas restantes." << std::endl;
+            salida << "[Sensor Temp] Sin lecturas restantes." << std::endl;
+        }
+
+        ResumenRango minuto = agregados.consultarUltimos(std::chrono::minutes(1));
+        if (!minuto.estaVacio()) {
+            salida << "[Sensor Temp] Último minuto: " << minuto.cantidad << " lectura(s), "
+                   << "promedio " << minuto.promedio() << "°C, mín " << minuto.minimo
+                   << "°C, máx " << minuto.maximo << "°C" << std::endl;
+        }
+
+        // Población distinta del promedio: todo lo recibido, no sólo el historial actual
+        if (!cuantiles.estaVacio()) {
+            BocetoCuantiles todas = cuantiles.consultarTodo();
+            salida << "[Sensor Temp] Percentiles históricos (todas las lecturas recibidas, "
+                   << todas.obtenerCantidad() << "): p50 "
+                   << todas.cuantil(0.50) << "°C, p95 " << todas.cuantil(0.95) << "°C, p99 "
+                   << todas.cuantil(0.99) << "°C" << std::endl;
         }
     }
 
@@ -61,9 +142,76 @@ public:
     }
 
 
+    std::size_t lecturasEntre(std::int64_t desdeMs, std::int64_t hastaMs,
+                              std::vector<LecturaTemporal>& salida) const override {
+        std::size_t antes = salida.size();
+        historial.paraCadaEnIntervalo(desdeMs, hastaMs, [&salida](const float& valor, std::int64_t instante) {
+            LecturaTemporal lectura = { instante, static_cast<double>(valor) };
+            salida.push_back(lectura);
+        });
+        return salida.size() - antes;
+    }
+
+    const AgregadosTemporales* obtenerAgregados() const override {
+        return &agregados;
+    }
+
+    const CuantilesTemporales* obtenerCuantiles() const override {
+        return &cuantiles;
+    }
+
+    SensorBase* clonar() const override {
+        return new SensorTemperaturaGen(*this);
+    }
+
+    void serializar(EscritorInstantanea& escritor) const override {
+        escritor.agregarSensor<float>(obtenerTipo(), nombre, historial, agregados);
+    }
+
+    void describirHistorial(FichaInstantanea& ficha) const override {
+        EscritorInstantanea::describir(historial, ficha);
+    }
+
+    bool restaurar(const InstantaneaMapeada& instantanea, std::uint32_t indice) override {
+        if (!instantanea.cargarSensor<float>(indice, historial, agregados)) {
+            return false;
+        }
+        // La instantánea no guarda bocetos: se rehacen con el historial
+        // restaurado, sin instante, en el histórico (las lecturas eliminadas
+        // antes de la instantánea ya no cuentan)
+        historial.paraCada([this](const float& valor) {
+            cuantiles.registrarHistorico(valor);
+        });
+        return true;
+    }
+
     int obtenerCantidadLecturas() const {
         return historial.obtenerCantidad();
     }
+
+private:
+    static const std::size_t LOTE_CONVERSION = 256;  ///< Lecturas convertidas por tramo
+
+    void anexarLote(const float* valores, std::size_t n, std::int64_t instanteMs) {
+        if (n == 0) {
+            return;
+        }
+        BitacoraPredeterminada::registrar([&](auto& os) {
+            os << "[" << nombre << "] Registrando " << n << " lectura(s) en lote";
+        });
+        historial.insertarVariosEn(valores, static_cast<int>(n), instanteMs);
+        agregados.registrarVariosEn(valores, n, instanteMs);
+        cuantiles.registrarVariosEn(valores, n, instanteMs);
+    }
 };
 
+/// Versión predeterminada: historial en lista enlazada simple
+typedef SensorTemperaturaGen<ListaSensor<float> > SensorTemperatura;
+
+/// Historial desenrollado: los recorridos leen memoria contigua
+typedef SensorTemperaturaGen<ListaSensorBloques<float> > SensorTemperaturaBloques;
+
+/// Historial acotado (anillo): memoria fija por sensor
+typedef SensorTemperaturaGen<ListaSensorCircular<float> > SensorTemperaturaCircular;
+
 #endif // SENSOR_TEMPERATURA_HPP
@@ -0,0 +1,341 @@
+#ifndef SERVICIO_MULTIPUERTO_HPP
+#define SERVICIO_MULTIPUERTO_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ColaSPSC.hpp"
+#include "ComunicacionSerial.hpp"
+#include "GestorSensores.hpp"
+#include "MotorIngesta.hpp"
+
+#ifndef _WIN32
+    #include <poll.h>
+#endif
+
+/// Lectura ya resuelta a identificador, lista para aplicarse a su sensor
+struct LecturaIndexada {
+    std::uint32_t idSensor;
+    double valor;
+    std::int64_t llegadaNs;   ///< relojMetricasNs al leer el bloque (0 sin métricas)
+};
+
+/**
+ * Servicio de ingesta concurrente para varios puertos serie (Linux).
+ *
+ * Hay dos grupos de hilos:
+ *  - Lectores: cada uno atiende un subconjunto de puertos con un solo
+ *    poll(), interpreta las líneas con el MotorIngesta del puerto y
+ *    resuelve el nombre del sensor a su identificador.
+ *  - Aplicadores: el sensor con identificador id pertenece siempre al
+ *    aplicador id % aplicadores, que es el único hilo que lo modifica.
+ *
+ * Cada par (lector, aplicador) se comunica por una ColaSPSC propia, así
+ * que no hay candados en la ruta de datos y las lecturas de un mismo
+ * sensor que llegan por un puerto se aplican en el orden de llegada.
+ * Si una cola se llena el lector espera (no se descartan lecturas).
+ *
+ * Ese orden sólo vale dentro de un puerto (dos lectores no se coordinan),
+ * así que cada sensor debe llegar por un único puerto: el primero que
+ * entrega un ID queda como su dueño y las lecturas de ese ID que lleguen
+ * por otro puerto se descartan y se cuentan (obtenerLecturasOtroPuerto).
+ *
+ * Los sensores deben registrarse en el GestorSensores antes de iniciar():
+ * mientras el servicio corre, el índice de nombres sólo se consulta.
+ *
+ * Si el gestor tiene un RegistroMetricas, cada puerto publica sus
+ * contadores, cada aplicador mide la latencia desde la lectura del
+ * puerto hasta el registro (un reloj por lote, no por lectura) y la
+ * profundidad de las colas que consume.
+ */
+class ServicioMultipuerto {
+public:
+    ServicioMultipuerto(GestorSensores& gestorSensores, int hilosLectores = 1,
+                        int hilosAplicadores = 1, std::size_t capacidadCola = 16384)
+        : gestor(gestorSensores),
+          numLectores(hilosLectores < 1 ? 1 : hilosLectores),
+          numAplicadores(hilosAplicadores < 1 ? 1 : hilosAplicadores),
+          capacidadColas(capacidadCola),
+          cantidadDuenios(0), activo(false), lectoresActivos(0),
+          lecturasAplicadas(0), sensoresDesconocidos(0), esperasColaLlena(0),
+          lineasInvalidas(0), lecturasOtroPuerto(0) {}
+
+    ~ServicioMultipuerto() {
+        detener();
+    }
+
+    ServicioMultipuerto(const ServicioMultipuerto&) = delete;
+    ServicioMultipuerto& operator=(const ServicioMultipuerto&) = delete;
+
+    /** Abre un puerto y lo agrega al servicio (antes de iniciar) */
+    bool agregarPuerto(const char* nombrePuerto, int velocidad = 115200) {
+        if (activo.load()) {
+            return false;
+        }
+        std::unique_ptr<Puerto> p(new Puerto(gestor, static_cast<std::uint32_t>(puertos.size() + 1)));
+        if (!p->serial.conectar(nombrePuerto, velocidad)) {
+            return false;
+        }
+        p->motor.asignarMetricas(gestor.obtenerMetricas());
+        puertos.push_back(std::move(p));
+        return true;
+    }
+
+    int obtenerCantidadPuertos() const {
+        return static_cast<int>(puertos.size());
+    }
+
+    /** Lanza los hilos lectores y aplicadores */
+    void iniciar() {
+        if (activo.exchange(true)) {
+            return;
+        }
+        colas.clear();
+        metricasColas.clear();
+        // Los sensores ya están registrados: un dueño (puerto) por ID, 0 si aún no llegó
+        cantidadDuenios = gestor.obtenerCantidadIds();
+        duenios.reset(new std::atomic<std::uint32_t>[cantidadDuenios]);
+        for (std::uint32_t i = 0; i < cantidadDuenios; i++) {
+            duenios[i].store(0, std::memory_order_relaxed);
+        }
+        RegistroMetricas* metricas = gestor.obtenerMetricas();
+        for (int i = 0; i < numLectores * numAplicadores; i++) {
+            colas.emplace_back(new ColaSPSC<LecturaIndexada>(capacidadColas));
+            MetricasCola* m = nullptr;
+            if (metricas != nullptr) {
+                std::string nombre = "l" + std::to_string(i / numAplicadores) + "-a" +
+                                     std::to_string(i % numAplicadores);
+                m = metricas->cola(nombre);
+                if (m != nullptr) {
+                    m->capacidad.store(colas.back()->obtenerCapacidad(), std::memory_order_relaxed);
+                }
+            }
+            metricasColas.push_back(m);
+        }
+        lectoresActivos.store(numLectores);
+        for (int a = 0; a < numAplicadores; a++) {
+            hilos.emplace_back(&ServicioMultipuerto::bucleAplicador, this, a);
+        }
+        for (int l = 0; l < numLectores; l++) {
+            hilos.emplace_back(&ServicioMultipuerto::bucleLector, this, l);
+        }
+    }
+
+    /** Detiene los lectores, deja que los aplicadores vacíen las colas y
+     *  espera a todos los hilos
+     */
+    void detener() {
+        if (!activo.exchange(false)) {
+            return;
+        }
+        for (std::thread& h : hilos) {
+            h.join();
+        }
+        hilos.clear();
+    }
+
+    std::uint64_t obtenerLecturasAplicadas() const {
+        return lecturasAplicadas.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t obtenerSensoresDesconocidos() const {
+        return sensoresDesconocidos.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t obtenerEsperasColaLlena() const {
+        return esperasColaLlena.load(std::memory_order_relaxed);
+    }
+
+    /** Suma de líneas malformadas en todos los puertos (se puede
+     *  consultar mientras el servicio corre)
+     */
+    std::uint64_t obtenerLineasInvalidas() const {
+        return lineasInvalidas.load(std::memory_order_relaxed);
+    }
+
+    /** Lecturas descartadas por llegar por un puerto que no es el dueño de su sensor */
+    std::uint64_t obtenerLecturasOtroPuerto() const {
+        return lecturasOtroPuerto.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// Estado por puerto: la conexión y su motor de lectura/interpretación
+    struct Puerto {
+        ComunicacionSerial serial;
+        MotorIngesta motor;
+        std::uint64_t invalidasPublicadas;   ///< Ya sumadas a lineasInvalidas
+        std::uint32_t numero;                ///< Posición en puertos + 1 (0: sin dueño)
+
+        Puerto(GestorSensores& g, std::uint32_t numeroPuerto)
+            : serial(), motor(serial, g), invalidasPublicadas(0), numero(numeroPuerto) {}
+    };
+
+    ColaSPSC<LecturaIndexada>& cola(int lector, int aplicador) {
+        return *colas[static_cast<std::size_t>(lector * numAplicadores + aplicador)];
+    }
+
+    /** true si el puerto es el dueño del sensor id; el primero que lo pide lo es */
+    bool esDuenio(std::uint32_t id, std::uint32_t puerto) {
+        if (id >= cantidadDuenios) {
+            return true;   // Registrado después de iniciar(): sin control
+        }
+        std::uint32_t actual = duenios[id].load(std::memory_order_relaxed);
+        if (actual == 0 && duenios[id].compare_exchange_strong(actual, puerto, std::memory_order_relaxed)) {
+            return true;
+        }
+        return actual == puerto;
+    }
+
+    void bucleLector(int lector) {
+        std::vector<Puerto*> propios;
+        for (std::size_t i = static_cast<std::size_t>(lector); i < puertos.size();
+             i += static_cast<std::size_t>(numLectores)) {
+            propios.push_back(puertos[i].get());
+        }
+
+        std::uint64_t desconocidos = 0;
+        std::uint64_t esperas = 0;
+        std::uint64_t otroPuerto = 0;
+        Puerto* actual = nullptr;
+        auto destino = [&](const LecturaCruda& lectura) {
+            std::int32_t id = gestor.obtenerIdSensor(lectura.id);
+            if (id < 0) {
+                desconocidos++;
+                actual->motor.contarSensorDesconocido();
+                return;
+            }
+            if (!esDuenio(static_cast<std::uint32_t>(id), actual->numero)) {
+                otroPuerto++;
+                return;
+            }
+            LecturaIndexada li = { static_cast<std::uint32_t>(id), lectura.valor,
+                                   actual->motor.obtenerInstanteLlegada() };
+            ColaSPSC<LecturaIndexada>& c = cola(lector, static_cast<int>(li.idSensor % numAplicadores));
+            while (!c.intentarEncolar(li)) {
+                esperas++;
+                std::this_thread::yield();
+            }
+        };
+
+        #ifndef _WIN32
+        std::vector<pollfd> fds(propios.size());
+        for (std::size_t i = 0; i < propios.size(); i++) {
+            fds[i].fd = propios[i]->serial.obtenerDescriptor();
+            fds[i].events = POLLIN;
+        }
+        while (activo.load(std::memory_order_relaxed) && !propios.empty()) {
+            int listos = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), 50);
+            if (listos <= 0) {
+                continue;
+            }
+            for (std::size_t i = 0; i < fds.size(); i++) {
+                short eventos = fds[i].revents;
+                if (eventos & POLLNVAL) {
+                    fds[i].fd = -1;   // Descriptor cerrado: poll lo ignora desde ahora
+                    continue;
+                }
+                if (eventos & (POLLIN | POLLHUP | POLLERR)) {
+                    // Tras un corte POLLIN sigue activo: se lee lo que quede y,
+                    // como en MotorIngesta::esperarYProcesar, el puerto se retira
+                    // si falla o no entrega nada con POLLHUP/POLLERR (sin girar)
+                    actual = propios[i];
+                    int n = actual->motor.leerDisponible(destino);
+                    if (n < 0 || (n == 0 && (eventos & (POLLHUP | POLLERR)))) {
+                        fds[i].fd = -1;
+                    }
+                    std::uint64_t invalidas = actual->motor.obtenerLineasInvalidas();
+                    if (invalidas != actual->invalidasPublicadas) {
+                        lineasInvalidas.fetch_add(invalidas - actual->invalidasPublicadas,
+                                                  std::memory_order_relaxed);
+                        actual->invalidasPublicadas = invalidas;
+                    }
+                }
+            }
+        }
+        #endif
+
+        sensoresDesconocidos.fetch_add(desconocidos, std::memory_order_relaxed);
+        esperasColaLlena.fetch_add(esperas, std::memory_order_relaxed);
+        lecturasOtroPuerto.fetch_add(otroPuerto, std::memory_order_relaxed);
+        lectoresActivos.fetch_sub(1, std::memory_order_release);
+    }
+
+    void bucleAplicador(int aplicador) {
+        static const int LOTE = 256;
+        LecturaIndexada li;
+        std::int64_t llegadas[LOTE];
+        LecturaPorId lote[LOTE];
+        std::uint64_t aplicadas = 0;
+        RegistroMetricas* metricas = gestor.obtenerMetricas();
+        while (true) {
+            bool terminaron = lectoresActivos.load(std::memory_order_acquire) == 0;
+            bool trabajo = false;
+            for (int l = 0; l < numLectores; l++) {
+                ColaSPSC<LecturaIndexada>& c = cola(l, aplicador);
+                // Lotes acotados para repartir el tiempo entre lectores
+                int k = 0;
+                for (; k < LOTE && c.intentarDesencolar(li); k++) {
+                    lote[k].idSensor = li.idSensor;
+                    lote[k].valor = li.valor;
+                    llegadas[k] = li.llegadaNs;
+                }
+                if (k > 0) {
+                    // Cada sensor recibe sus lecturas del lote de una vez
+                    gestor.registrarAgrupadas(lote, static_cast<std::size_t>(k));
+                    aplicadas += static_cast<std::uint64_t>(k);
+                    trabajo = true;
+                    if (metricas != nullptr) {
+                        std::int64_t ahora = relojMetricasNs();
+                        for (int i = 0; i < k; i++) {
+                            if (llegadas[i] != 0) {
+                                metricas->latenciaIngesta().registrar(ahora - llegadas[i]);
+                            }
+                        }
+                    }
+                }
+            }
+            if (aplicadas >= 4096 || (!trabajo && aplicadas > 0)) {
+                // El contador global se publica por lotes o al quedar ocioso
+                lecturasAplicadas.fetch_add(aplicadas, std::memory_order_relaxed);
+                aplicadas = 0;
+                for (int l = 0; l < numLectores; l++) {
+                    MetricasCola* m = metricasColas[static_cast<std::size_t>(l * numAplicadores + aplicador)];
+                    if (m != nullptr) {
+                        m->observar(cola(l, aplicador).tamanio());
+                    }
+                }
+            }
+            if (!trabajo) {
+                if (terminaron) {
+                    break;   // Ya no llegará nada y las colas están vacías
+                }
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    GestorSensores& gestor;
+    const int numLectores;
+    const int numAplicadores;
+    const std::size_t capacidadColas;
+
+    std::vector<std::unique_ptr<Puerto> > puertos;
+    std::vector<std::unique_ptr<ColaSPSC<LecturaIndexada> > > colas;   ///< lector x aplicador
+    std::vector<MetricasCola*> metricasColas;                          ///< Ranura de cada cola (o nullptr)
+    std::vector<std::thread> hilos;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> duenios;   ///< Id de sensor -> número de su puerto
+    std::uint32_t cantidadDuenios;
+
+    std::atomic<bool> activo;
+    std::atomic<int> lectoresActivos;
+    std::atomic<std::uint64_t> lecturasAplicadas;
+    std::atomic<std::uint64_t> sensoresDesconocidos;
+    std::atomic<std::uint64_t> esperasColaLlena;
+    std::atomic<std::uint64_t> lineasInvalidas;
+    std::atomic<std::uint64_t> lecturasOtroPuerto;
+};
+
+#endif // SERVICIO_MULTIPUERTO_HPP
@@ -1,11 +1,15 @@
 #include <iostream>
+#include <chrono>
 #include <cstring>
+#include <cstdint>
 #include <cstdlib>
 
 #include "GestorSensores.hpp"
 #include "SensorTemperatura.hpp"
 #include "SensorPresion.hpp"
 #include "ComunicacionSerial.hpp"
+#include "MotorIngesta.hpp"
+#include "RecuperacionDiario.hpp"
 
 // Evitamos 'using namespace std;' como se solicita
 using std::cout;
@@ -26,7 +30,9 @@ void mostrarMenu() {
     cout << "4. Conectar con Arduino/ESP32 (Puerto Serial)" << endl;
     cout << "5. Procesar Lecturas (Polimorfismo)" << endl;
     cout << "6. Ver Estado de Sensores" << endl;
-    cout << "7. Cerrar Sistema (Liberar Memoria)" << endl;
+    cout << "7. Guardar Punto de Control (Instantánea)" << endl;
+    cout << "8. Ver Métricas" << endl;
+    cout << "9. Cerrar Sistema (Liberar Memoria)" << endl;
     cout << "========================================" << endl;
     cout << "Seleccione una opción: ";
 }
@@ -61,8 +67,27 @@ void crearSensor(GestorSensores& gestor, bool esTemperatura) {
         return;
     }
 
+    long capacidad = 0;
+    long segundos = 0;
+    cout << "Máximo de lecturas a conservar (0 = sin límite): ";
+    cin >> capacidad;
+    if (capacidad > 0) {
+        cout << "Ventana de tiempo en segundos (0 = sólo por cantidad): ";
+        cin >> segundos;
+    }
+    cin.ignore(); // Limpiar el buffer
+
     SensorBase* nuevoSensor = nullptr;
-    if (esTemperatura) {
+    if (capacidad > 0) {
+        // Historial acotado: la memoria del sensor no crece con el tiempo
+        std::size_t maximo = static_cast<std::size_t>(capacidad);
+        std::chrono::seconds ventana(segundos > 0 ? segundos : 0);
+        if (esTemperatura) {
+            nuevoSensor = new SensorTemperaturaCircular(nombreSensor, maximo, ventana);
+        } else {
+            nuevoSensor = new SensorPresionCircular(nombreSensor, maximo, ventana);
+        }
+    } else if (esTemperatura) {
         nuevoSensor = new SensorTemperatura(nombreSensor);
     } else {
         nuevoSensor = new SensorPresion(nombreSensor);
@@ -82,8 +107,8 @@ void registrarLectura(GestorSensores& gestor) {
     cout << "\nIngrese el identificador del sensor: ";
     leerString(nombreSensor, sizeof(nombreSensor));
 
-    SensorBase* sensor = gestor.buscarSensor(nombreSensor);
-    if (sensor == nullptr) {
+    std::int32_t id = gestor.obtenerIdSensor(nombreSensor);
+    if (id < 0) {
         cout << "[Error] Sensor '" << nombreSensor << "' no encontrado." << endl;
         return;
     }
@@ -93,7 +118,7 @@ void registrarLectura(GestorSensores& gestor) {
     cin >> valor;
     cin.ignore(); // Limpiar el buffer
 
-    sensor->registrarLectura(valor);
+    gestor.registrarLectura(static_cast<std::uint32_t>(id), valor);
 }
 
 
@@ -127,56 +152,73 @@ void conectarArduino(GestorSensores& gestor) {
     }
 
     cout << "\n[Sistema] Esperando datos del Arduino/ESP32..." << endl;
-    cout << "[Sistema] Presione Ctrl+C para detener." << endl;
     cout << "[Formato esperado: ID:valor (ej: T-001:25.5)]" << endl;
+    cout << "[Sistema] También puede escribir lecturas 'ID:valor' aquí." << endl;
+    cout << "[Sistema] Escriba 'salir' para terminar." << endl;
     cout << "=============================================" << endl;
 
-    char buffer[256];
+    MotorIngesta motor(serial, gestor);
+    motor.asignarMetricas(gestor.obtenerMetricas());
     char linea[256];
-    int posicion = 0;
 
-    // Simulación de lectura de datos
-    cout << "\n[Simulación de lecturas Arduino]" << endl;
-    cout << "Ingrese lecturas en formato 'ID:valor' (escribe 'salir' para terminar):" << endl;
+    #ifdef _WIN32
+        const int fdEntrada = -1;
+    #else
+        const int fdEntrada = STDIN_FILENO;
+    #endif
 
     while (true) {
-        cout << "> ";
-        leerString(linea, sizeof(linea));
+        EventoIngesta evento = motor.esperarYProcesar(500, fdEntrada);
 
-        if (std::strcmp(linea, "salir") == 0) {
+        if (evento == EventoIngesta::Error) {
+            cerr << "[Error] Se perdió la conexión con el puerto serial." << endl;
             break;
         }
-
-        // Parsear formato "ID:valor"
-        char* separador = std::strchr(linea, ':');
-        if (separador == nullptr) {
-            cout << "[Error] Formato inválido. Use 'ID:valor'" << endl;
+        if (evento != EventoIngesta::EntradaExtra) {
             continue;
         }
 
-        char idSensor[50];
-        char valorStr[50];
-        int idLen = separador - linea;
-
-        std::strncpy(idSensor, linea, idLen);
-        idSensor[idLen] = '\0';
-
-        std::strncpy(valorStr, separador + 1, sizeof(valorStr) - 1);
-        valorStr[sizeof(valorStr) - 1] = '\0';
-
-        SensorBase* sensor = gestor.buscarSensor(idSensor);
-        if (sensor == nullptr) {
-            cout << "[Error] Sensor '" << idSensor << "' no encontrado." << endl;
-            continue;
+        // Lectura escrita a mano (simulación) o comando de salida
+        leerString(linea, sizeof(linea));
+        if (std::strcmp(linea, "salir") == 0 || cin.eof()) {
+            break;
         }
 
-        double valor = std::atof(valorStr);
-        sensor->registrarLectura(valor);
+        ResultadoLinea resultado = motor.procesarLinea(linea);
+        if (resultado == ResultadoLinea::Invalida) {
+            cout << "[Error] Formato inválido. Use 'ID:valor'" << endl;
+        } else if (resultado == ResultadoLinea::SensorDesconocido) {
+            cout << "[Error] Sensor no encontrado en '" << linea << "'." << endl;
+        }
     }
 
+    cout << "\n[Sistema] Resumen de ingesta: "
+         << motor.obtenerLecturasAceptadas() << " lectura(s) aceptada(s), "
+         << motor.obtenerLineasInvalidas() << " línea(s) inválida(s), "
+         << motor.obtenerSensoresDesconocidos() << " con sensor desconocido, "
+         << motor.obtenerBytesLeidos() << " byte(s) leídos del puerto." << endl;
+
     serial.desconectar();
 }
 
+/**
+ * Muestra el registro completo (mismo texto que el archivo de métricas)
+ * y un resumen de los percentiles de latencia
+ */
+void mostrarMetricas(const RegistroMetricas& metricas) {
+    cout << "\n--- Métricas ---" << endl;
+    metricas.exponer(cout);
+
+    ResumenHistograma ingesta = metricas.latenciaIngesta().resumir();
+    ResumenHistograma proceso = metricas.duracionProcesamiento().resumir();
+    cout << "\n[Métricas] Latencia de ingesta (µs): " << ingesta.cantidad << " lectura(s), p50 "
+         << ingesta.percentil(0.50) / 1000.0 << ", p99 " << ingesta.percentil(0.99) / 1000.0
+         << ", máx " << ingesta.maximo / 1000.0 << endl;
+    cout << "[Métricas] procesarLectura (µs): " << proceso.cantidad << " llamada(s), p50 "
+         << proceso.percentil(0.50) / 1000.0 << ", p99 " << proceso.percentil(0.99) / 1000.0
+         << ", máx " << proceso.maximo / 1000.0 << endl;
+}
+
 /**
  * @brief Función principal
  */
@@ -187,11 +229,71 @@ int main() {
     cout << "║  Compatible con Arduino/ESP32             ║" << endl;
     cout << "╚════════════════════════════════════════════╝" << endl;
 
+    // Diario de lecturas: lo registrado en sesiones anteriores se recupera
+    const char* rutaDiario = std::getenv("SISTEMAIOT_DIARIO");
+    if (rutaDiario == nullptr || rutaDiario[0] == '\0') {
+        rutaDiario = "sistemaiot.wal";
+    }
+    DiarioLecturas diario(rutaDiario);
+
+    // La instantánea (punto de control) se carga primero; el diario sólo
+    // tiene lo posterior a ella
+    const char* rutaInstantanea = std::getenv("SISTEMAIOT_INSTANTANEA");
+    if (rutaInstantanea == nullptr || rutaInstantanea[0] == '\0') {
+        rutaInstantanea = "sistemaiot.snap";
+    }
+
     GestorSensores gestor;
+    std::uint64_t generacion = 0;
+    {
+        InstantaneaMapeada instantanea(rutaInstantanea);
+        if (instantanea.estaAbierta()) {
+            std::uint32_t sensores = restaurarInstantanea(instantanea, gestor);
+            generacion = instantanea.obtenerGeneracion();
+            cout << "[Sistema] Instantánea '" << rutaInstantanea << "': " << sensores
+                 << " sensor(es) cargados." << endl;
+        }
+    }
+    ResumenReproduccion recuperado = recuperarDiario(diario, gestor, generacion);
+    if (diario.estaAbierto() && !recuperado.obsoleto) {
+        cout << "[Sistema] Diario '" << rutaDiario << "': " << recuperado.sensores
+             << " sensor(es) y " << recuperado.lecturas << " lectura(s) recuperados." << endl;
+        if (recuperado.bytesDescartados > 0) {
+            cout << "[Sistema] Se descartaron " << recuperado.bytesDescartados
+                 << " byte(s) incompletos al final del diario." << endl;
+        }
+    }
+    // Métricas: se vuelcan periódicamente a un archivo de texto para un
+    // recolector local (SISTEMAIOT_METRICAS_PERIODO=0 lo desactiva)
+    RegistroMetricas metricas;
+    gestor.asignarMetricas(&metricas);
+    const char* rutaMetricas = std::getenv("SISTEMAIOT_METRICAS");
+    if (rutaMetricas == nullptr || rutaMetricas[0] == '\0') {
+        rutaMetricas = "sistemaiot.prom";
+    }
+    const char* periodoMetricas = std::getenv("SISTEMAIOT_METRICAS_PERIODO");
+    long segundosMetricas = (periodoMetricas != nullptr) ? std::atol(periodoMetricas) : 10;
+    VolcadorMetricas volcador(metricas, rutaMetricas, std::chrono::seconds(segundosMetricas));
+    if (segundosMetricas > 0) {
+        volcador.iniciar();
+    }
+
+    // Anomalías: cada lectura se evalúa al registrarla y las alertas salen
+    // por stderr desde otro hilo (SISTEMAIOT_ANOMALIAS=0 lo desactiva)
+    DetectorAnomalias detector;
+    AlertadorAnomalias alertador(detector, cerr);
+    const char* anomalias = std::getenv("SISTEMAIOT_ANOMALIAS");
+    if (anomalias == nullptr || std::strcmp(anomalias, "0") != 0) {
+        gestor.asignarDetector(&detector);
+        alertador.iniciar();
+    }
+
+    PoolTrabajo pool;  // Un hilo por núcleo para procesar los sensores
     int opcion;
     bool ejecutando = true;
 
     while (ejecutando) {
+        BitacoraPredeterminada::vaciar();  // La bitácora con buffer se muestra antes del menú
         mostrarMenu();
         cin >> opcion;
         cin.ignore(); // Limpiar el buffer de entrada
@@ -218,7 +320,7 @@ int main() {
                 break;
 
             case 5:
-                gestor.procesarTodosSensores();
+                gestor.procesarTodosSensores(pool);
                 break;
 
             case 6:
@@ -226,6 +328,17 @@ int main() {
                 break;
 
             case 7:
+                if (guardarPuntoControl(gestor, &diario, rutaInstantanea)) {
+                    cout << "[Sistema] Punto de control guardado en '" << rutaInstantanea
+                         << "' (" << gestor.obtenerCantidad() << " sensor(es)); diario reiniciado." << endl;
+                }
+                break;
+
+            case 8:
+                mostrarMetricas(metricas);
+                break;
+
+            case 9:
                 cout << "\n--- Cerrando Sistema ---" << endl;
                 ejecutando = false;
                 break;